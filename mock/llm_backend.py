@@ -6,6 +6,8 @@ Used for testing and demonstrating the NTONIX proxy.
 
 Features:
 - OpenAI-compatible /v1/chat/completions endpoint
+- Legacy /v1/completions endpoint with batched (array) prompts
+- /v1/embeddings endpoint with deterministic vectors
 - Server-Sent Events (SSE) streaming responses
 - Configurable response delay to simulate inference time
 - Health check endpoint for load balancer monitoring
@@ -59,7 +61,9 @@ async def root():
         "backend_id": BACKEND_ID,
         "endpoints": [
             "/health",
-            "/v1/chat/completions"
+            "/v1/chat/completions",
+            "/v1/completions",
+            "/v1/embeddings"
         ]
     }
 
@@ -201,6 +205,99 @@ async def chat_completions(request: Request):
         )
 
 
+@app.post("/v1/completions")
+async def completions(request: Request):
+    """
+    OpenAI-compatible legacy completions endpoint (non-streaming).
+
+    Accepts a single prompt or an array of prompts and returns one choice
+    per prompt, like a batching inference server.
+    """
+    try:
+        body = await request.json()
+    except json.JSONDecodeError:
+        return JSONResponse(
+            content={"error": "Invalid JSON in request body"},
+            status_code=400
+        )
+
+    model = body.get("model", "mock-gpt")
+    prompts = body.get("prompt", "")
+    if not isinstance(prompts, list):
+        prompts = [prompts]
+
+    request_id = request.headers.get("X-Request-ID", f"cmpl-{uuid.uuid4().hex[:24]}")
+    prompt_tokens = sum(len(str(p).split()) for p in prompts)
+    completion_tokens = len(SAMPLE_RESPONSE) * len(prompts)
+
+    await asyncio.sleep(RESPONSE_DELAY_MS / 1000.0)
+
+    return JSONResponse(
+        content={
+            "id": request_id,
+            "object": "text_completion",
+            "created": int(time.time()),
+            "model": model,
+            "choices": [
+                {
+                    "index": i,
+                    "text": f"Completion of: {prompt}",
+                    "finish_reason": "stop"
+                }
+                for i, prompt in enumerate(prompts)
+            ],
+            "usage": {
+                "prompt_tokens": prompt_tokens,
+                "completion_tokens": completion_tokens,
+                "total_tokens": prompt_tokens + completion_tokens
+            },
+            "batch_size": len(prompts),  # Extra field for debugging
+            "backend_id": BACKEND_ID
+        },
+        headers={"X-Backend-ID": BACKEND_ID}
+    )
+
+
+@app.post("/v1/embeddings")
+async def embeddings(request: Request):
+    """
+    OpenAI-compatible embeddings endpoint.
+
+    Vectors are derived from the input text, so the same input always
+    yields the same embedding.
+    """
+    try:
+        body = await request.json()
+    except json.JSONDecodeError:
+        return JSONResponse(
+            content={"error": "Invalid JSON in request body"},
+            status_code=400
+        )
+
+    inputs = body.get("input", [])
+    if not isinstance(inputs, list) or (inputs and isinstance(inputs[0], int)):
+        inputs = [inputs]
+    prompt_tokens = sum(len(str(text).split()) for text in inputs)
+
+    return JSONResponse(
+        content={
+            "object": "list",
+            "data": [
+                {
+                    "object": "embedding",
+                    "index": i,
+                    "embedding": [(sum(map(ord, str(text))) % 1000) / 1000.0, len(str(text)) / 100.0, 0.5]
+                }
+                for i, text in enumerate(inputs)
+            ],
+            "model": body.get("model", "mock-embedding"),
+            "usage": {"prompt_tokens": prompt_tokens, "total_tokens": prompt_tokens},
+            "backend_id": BACKEND_ID
+        },
+        headers={"X-Backend-ID": BACKEND_ID}
+    )
+
+
 if __name__ == "__main__":
     import uvicorn
 
@@ -2,32 +2,121 @@
 """
 Simple mock LLM backend for testing NTONIX load balancer.
 Returns the port number in response to verify which backend handled the request.
+
+Usage:
+    simple_backend.py PORT [--delay-ms MS] [--idle-timeout SECONDS]
+                           [--stream-events N] [--event-bytes N]
+                           [--event-text TEXT] [--event-interval-ms MS]
+                           [--split-done-ms MS] [--close-after-request]
+
+Requests with "stream": true are answered with N chunked SSE events ending
+in [DONE], MS apart with --event-interval-ms. --event-text sets the token
+text of each event. --split-done-ms
+sends [DONE] in two chunks, then holds the body open for MS before ending it.
+Requests offering "tools" are answered with a call to the first
+tool, in either form. Bodies that are not valid JSON get a 400
+error, as from a real server. Keep-alive connections idle for longer than --idle-timeout are
+closed, as real inference servers do. --close-after-request reads each POST
+and closes the connection without answering, like a handler that crashed.
+GET /stats reports how many POST requests have arrived.
 """
 
-import sys
-from http.server import HTTPServer, BaseHTTPRequestHandler
+import argparse
 import json
+import sys
+import threading
+import time
+from http.server import ThreadingHTTPServer, BaseHTTPRequestHandler
+
 
 class MockBackendHandler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+    options = argparse.Namespace(delay_ms=0, idle_timeout=None, stream_events=10, event_bytes=32,
+                                 event_text=None, event_interval_ms=0, split_done_ms=None,
+                                 close_after_request=False)
+    posts = 0
+    posts_lock = threading.Lock()
+
+    def send_json(self, status, payload):
+        body = json.dumps(payload).encode()
+        self.send_response(status)
+        self.send_header('Content-Type', 'application/json')
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
     def do_GET(self):
         if self.path == '/health':
-            self.send_response(200)
-            self.send_header('Content-Type', 'application/json')
-            self.end_headers()
-            self.wfile.write(json.dumps({'status': 'healthy', 'port': self.server.server_port}).encode())
+            self.send_json(200, {'status': 'healthy', 'port': self.server.server_port})
+        elif self.path == '/stats':
+            self.send_json(200, {'posts': MockBackendHandler.posts})
         else:
-            self.send_response(404)
-            self.end_headers()
+            self.send_json(404, {'error': 'not found'})
 
     def do_POST(self):
         content_length = int(self.headers.get('Content-Length', 0))
         body = self.rfile.read(content_length) if content_length > 0 else b''
+        with MockBackendHandler.posts_lock:
+            MockBackendHandler.posts += 1
 
-        self.send_response(200)
-        self.send_header('Content-Type', 'application/json')
-        self.end_headers()
+        if self.options.close_after_request:
+            self.close_connection = True
+            return
+        try:
+            request = json.loads(body or b'{}')
+        except json.JSONDecodeError as error:
+            self.send_json(400, {'error': {
+                'message': f'Invalid JSON body: {error}',
+                'type': 'invalid_request_error',
+                'param': None,
+                'code': None
+            }})
+            return
+
+        if self.options.delay_ms:
+            time.sleep(self.options.delay_ms / 1000.0)
+
+        if self.path == '/v1/embeddings':
+            inputs = request.get('input', [])
+            if not isinstance(inputs, list) or (inputs and isinstance(inputs[0], int)):
+                inputs = [inputs]
+            self.send_json(200, {
+                'object': 'list',
+                'data': [{
+                    'object': 'embedding',
+                    'index': i,
+                    'embedding': [len(str(text)) / 100.0, 0.5, -0.25]
+                } for i, text in enumerate(inputs)],
+                'model': 'embedding-mock',
+                'usage': {'prompt_tokens': len(inputs), 'total_tokens': len(inputs)}
+            })
+            return
+
+        if self.path == '/v1/completions':
+            prompts = request.get('prompt', '')
+            if not isinstance(prompts, list):
+                prompts = [prompts]
+            self.send_json(200, {
+                'id': 'cmpl-mock',
+                'object': 'text_completion',
+                'backend_port': self.server.server_port,
+                'choices': [{
+                    'index': i,
+                    'text': f'Completion for {prompt}',
+                    'finish_reason': 'stop'
+                } for i, prompt in enumerate(prompts)]
+            })
+            return
+
+        if request.get('tools'):
+            self.send_tool_call(request)
+            return
 
-        response = {
+        if request.get('stream'):
+            self.send_stream()
+            return
+
+        self.send_json(200, {
             'id': 'chatcmpl-mock',
             'object': 'chat.completion',
             'backend_port': self.server.server_port,
@@ -38,15 +127,111 @@ class MockBackendHandler(BaseHTTPRequestHandler):
                     'content': f'Response from backend on port {self.server.server_port}'
                 },
                 'finish_reason': 'stop'
-            }]
-        }
-        self.wfile.write(json.dumps(response).encode())
+            }],
+            'usage': {'prompt_tokens': 10, 'completion_tokens': 10, 'total_tokens': 20}
+        })
+
+    def send_tool_call(self, request):
+        name = request['tools'][0].get('function', {}).get('name', 'tool')
+        arguments = ['{"city": ', '"Paris"}']
+        if not request.get('stream'):
+            self.send_json(200, {
+                'id': 'chatcmpl-mock',
+                'object': 'chat.completion',
+                'choices': [{
+                    'index': 0,
+                    'message': {
+                        'role': 'assistant',
+                        'content': None,
+                        'tool_calls': [{
+                            'id': 'call_mock',
+                            'type': 'function',
+                            'function': {'name': name, 'arguments': ''.join(arguments)}
+                        }]
+                    },
+                    'finish_reason': 'tool_calls'
+                }]
+            })
+            return
+
+        def chunk(delta, finish_reason=None):
+            return {
+                'id': 'chatcmpl-mock',
+                'object': 'chat.completion.chunk',
+                'choices': [{'index': 0, 'delta': delta, 'finish_reason': finish_reason}]
+            }
+
+        first_call = {'index': 0, 'id': 'call_mock', 'type': 'function',
+                      'function': {'name': name, 'arguments': ''}}
+        chunks = [chunk({'role': 'assistant', 'content': None, 'tool_calls': [first_call]})]
+        chunks += [chunk({'tool_calls': [{'index': 0, 'function': {'arguments': piece}}]}) for piece in arguments]
+        chunks.append(chunk({}, 'tool_calls'))
+        self.send_events(['data: ' + json.dumps(c) + '\n\n' for c in chunks])
+
+    def send_stream(self):
+        padding = 'x' * self.options.event_bytes
+        text = self.options.event_text
+        events = [
+            'data: ' + json.dumps({
+                'id': 'chatcmpl-mock',
+                'object': 'chat.completion.chunk',
+                'choices': [{'index': 0, 'delta': {'content': text if text is not None else f'{i} {padding}'}}]
+            }) + '\n\n'
+            for i in range(self.options.stream_events)
+        ]
+        self.send_events(events)
+
+    def send_events(self, events):
+        self.send_response(200)
+        self.send_header('Content-Type', 'text/event-stream')
+        self.send_header('Transfer-Encoding', 'chunked')
+        self.end_headers()
+
+        split = self.options.split_done_ms is not None
+        events = events + (['data: [DO', 'NE]\n\n'] if split else ['data: [DONE]\n\n'])
+        try:
+            for event in events:
+                data = event.encode()
+                self.wfile.write(f'{len(data):x}\r\n'.encode() + data + b'\r\n')
+                if self.options.event_interval_ms:
+                    time.sleep(self.options.event_interval_ms / 1000)
+                if split and event == 'data: [DO':
+                    # Let the first half arrive as a read of its own
+                    time.sleep(0.05)
+            if split:
+                time.sleep(self.options.split_done_ms / 1000)
+            self.wfile.write(b'0\r\n\r\n')
+        except (BrokenPipeError, ConnectionResetError):
+            self.close_connection = True
 
     def log_message(self, format, *args):
         print(f"[Backend:{self.server.server_port}] {args[0]}")
 
-if __name__ == '__main__':
-    port = int(sys.argv[1]) if len(sys.argv) > 1 else 8001
-    server = HTTPServer(('0.0.0.0', port), MockBackendHandler)
-    print(f"Mock backend running on port {port}")
+
+def main():
+    parser = argparse.ArgumentParser(description='Mock OpenAI-compatible backend')
+    parser.add_argument('port', type=int, nargs='?', default=8001)
+    parser.add_argument('--delay-ms', type=int, default=0, help='Delay before each POST response')
+    parser.add_argument('--idle-timeout', type=float, default=None,
+                        help='Close keep-alive connections idle this many seconds')
+    parser.add_argument('--stream-events', type=int, default=10, help='SSE events per streamed response')
+    parser.add_argument('--event-bytes', type=int, default=32, help='Padding per SSE event')
+    parser.add_argument('--event-text', default=None, help='Token text of each SSE event')
+    parser.add_argument('--event-interval-ms', type=int, default=0, help='Delay between SSE events')
+    parser.add_argument('--split-done-ms', type=int, default=None,
+                        help='Split [DONE] across two chunks and hold the body open this long')
+    parser.add_argument('--close-after-request', action='store_true',
+                        help='Close the connection after reading each POST, without answering')
+    options = parser.parse_args()
+
+    MockBackendHandler.options = options
+    MockBackendHandler.timeout = options.idle_timeout
+    server = ThreadingHTTPServer(('0.0.0.0', options.port), MockBackendHandler)
+    server.daemon_threads = True
+    print(f"Mock backend running on port {options.port}")
+    sys.stdout.flush()
     server.serve_forever()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,282 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Fair Queue - Implementation of deficit round-robin admission with CoDel shedding
+ */
+
+#include "balancer/fair_queue.hpp"
+#include "util/metrics.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace ntonix::balancer {
+
+namespace {
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+               return std::tolower(x) == std::tolower(y);
+           });
+}
+
+} // namespace
+
+// ============================================================================
+// FairQueue::Slot Implementation
+// ============================================================================
+
+FairQueue::Slot::~Slot() {
+    release();
+}
+
+FairQueue::Slot::Slot(Slot&& other) noexcept
+    : owner_(other.owner_) {
+    other.owner_ = nullptr;
+}
+
+FairQueue::Slot& FairQueue::Slot::operator=(Slot&& other) noexcept {
+    if (this != &other) {
+        release();
+        owner_ = other.owner_;
+        other.owner_ = nullptr;
+    }
+    return *this;
+}
+
+void FairQueue::Slot::release() {
+    if (owner_) {
+        owner_->release_slot();
+        owner_ = nullptr;
+    }
+}
+
+// ============================================================================
+// FairQueue Implementation
+// ============================================================================
+
+FairQueue::FairQueue(const FairQueueConfig& config)
+    : config_(config) {
+    config_.max_concurrent = std::max<std::size_t>(config_.max_concurrent, 1);
+    spdlog::debug("FairQueue: Created with max_concurrent={}, max_depth={}, target_delay={}ms",
+                  config_.max_concurrent, config_.max_depth, config_.target_delay.count());
+}
+
+FairQueue::Admission FairQueue::admit(std::uint64_t tenant, Priority priority, clock::time_point deadline) {
+    auto& metrics = util::Metrics::instance();
+    auto now = clock::now();
+    deadline = std::min(deadline, now + config_.max_wait);
+
+    Admission admission;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // Fast path: a free slot and nobody ahead of us
+    if (depth_ == 0 && active_ < config_.max_concurrent) {
+        ++active_;
+        admission.status = AdmitStatus::admitted;
+        admission.slot = Slot(this);
+        metrics.queue_admitted(admission.waited);
+        return admission;
+    }
+
+    if (depth_ >= config_.max_depth) {
+        admission.status = AdmitStatus::rejected;
+        metrics.queue_rejected();
+        return admission;
+    }
+
+    auto waiter = std::make_shared<Waiter>();
+    waiter->enqueued = now;
+    waiter->deadline = deadline;
+
+    FlowKey key{tenant, priority};
+    auto [it, inserted] = flows_.try_emplace(key);
+    if (inserted) {
+        ring_.push_back(key);
+    }
+    it->second.waiters.push_back(waiter);
+    ++depth_;
+    metrics.set_queue_depth(depth_);
+
+    dispatch_locked(now);
+    waiter->cv.wait_until(lock, deadline, [&] { return waiter->state != WaiterState::queued; });
+
+    if (waiter->state == WaiterState::queued) {
+        // Left in place and skipped by pop_next_locked()
+        waiter->state = WaiterState::abandoned;
+        --depth_;
+        metrics.set_queue_depth(depth_);
+    }
+
+    admission.waited = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - waiter->enqueued);
+
+    switch (waiter->state) {
+    case WaiterState::admitted:
+        admission.status = AdmitStatus::admitted;
+        admission.slot = Slot(this);
+        metrics.queue_admitted(admission.waited);
+        break;
+    case WaiterState::dropped:
+        admission.status = AdmitStatus::dropped;
+        metrics.queue_dropped();
+        break;
+    default:
+        admission.status = AdmitStatus::expired;
+        metrics.queue_expired();
+        break;
+    }
+
+    if (admission.status != AdmitStatus::admitted) {
+        spdlog::debug("FairQueue: Request not admitted after {}ms (depth={}, active={})",
+                      admission.waited.count(), depth_, active_);
+    }
+    return admission;
+}
+
+void FairQueue::release_slot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --active_;
+    dispatch_locked(clock::now());
+}
+
+void FairQueue::dispatch_locked(clock::time_point now) {
+    while (active_ < config_.max_concurrent) {
+        auto waiter = pop_next_locked();
+        if (!waiter) {
+            break;
+        }
+        --depth_;
+
+        if (now >= waiter->deadline) {
+            waiter->state = WaiterState::expired;
+            waiter->cv.notify_one();
+            continue;
+        }
+
+        // CoDel (RFC 8289): enter the dropping state once the delay has
+        // stayed above target for an interval, then drop at a rate that
+        // grows with the square root of the drop count until it recovers
+        bool ok_to_drop = codel_should_drop_locked(now - waiter->enqueued, now);
+        bool drop = false;
+        if (dropping_) {
+            if (!ok_to_drop) {
+                dropping_ = false;
+            } else if (now >= drop_next_) {
+                drop = true;
+                ++drop_count_;
+                drop_next_ += std::chrono::duration_cast<clock::duration>(
+                    config_.interval / std::sqrt(static_cast<double>(drop_count_)));
+            }
+        } else if (ok_to_drop) {
+            drop = true;
+            dropping_ = true;
+            // Resume near the previous drop rate if we only just left the dropping state
+            drop_count_ = (drop_count_ > 2 && now - drop_next_ < 16 * config_.interval) ? drop_count_ - 2 : 1;
+            drop_next_ = now + std::chrono::duration_cast<clock::duration>(
+                config_.interval / std::sqrt(static_cast<double>(drop_count_)));
+        }
+
+        if (drop) {
+            waiter->state = WaiterState::dropped;
+            waiter->cv.notify_one();
+            continue;
+        }
+
+        ++active_;
+        waiter->state = WaiterState::admitted;
+        waiter->cv.notify_one();
+    }
+
+    util::Metrics::instance().set_queue_depth(depth_);
+}
+
+std::shared_ptr<FairQueue::Waiter> FairQueue::pop_next_locked() {
+    while (!ring_.empty()) {
+        auto it = flows_.find(ring_.front());
+        auto& flow = it->second;
+
+        while (!flow.waiters.empty() && flow.waiters.front()->state == WaiterState::abandoned) {
+            flow.waiters.pop_front();
+        }
+        if (flow.waiters.empty()) {
+            flows_.erase(it);
+            ring_.pop_front();
+            continue;
+        }
+
+        // Each turn adds the flow's quantum; a flow that cannot afford a
+        // request yet (low priority) keeps its credit for a later turn
+        if (!flow.in_turn) {
+            flow.deficit += weight(it->first.priority);
+            flow.in_turn = true;
+        }
+        if (flow.deficit < kRequestCost) {
+            flow.in_turn = false;
+            ring_.splice(ring_.end(), ring_, ring_.begin());
+            continue;
+        }
+
+        auto waiter = std::move(flow.waiters.front());
+        flow.waiters.pop_front();
+        flow.deficit -= kRequestCost;
+
+        if (flow.waiters.empty()) {
+            flows_.erase(it);
+            ring_.pop_front();
+        } else if (flow.deficit < kRequestCost) {
+            flow.in_turn = false;
+            ring_.splice(ring_.end(), ring_, ring_.begin());
+        }
+        return waiter;
+    }
+    return nullptr;
+}
+
+bool FairQueue::codel_should_drop_locked(std::chrono::nanoseconds sojourn, clock::time_point now) {
+    // Never shed the last queued request: an empty queue has no standing delay
+    if (sojourn < config_.target_delay || depth_ == 0) {
+        first_above_ = clock::time_point{};
+        return false;
+    }
+    if (first_above_ == clock::time_point{}) {
+        first_above_ = now + config_.interval;
+        return false;
+    }
+    return now >= first_above_;
+}
+
+std::size_t FairQueue::weight(Priority priority) {
+    switch (priority) {
+    case Priority::high:
+        return 16;
+    case Priority::low:
+        return 1;
+    default:
+        return 4;
+    }
+}
+
+Priority FairQueue::parse_priority(std::string_view value) {
+    if (iequals(value, "high")) {
+        return Priority::high;
+    }
+    if (iequals(value, "low")) {
+        return Priority::low;
+    }
+    return Priority::normal;
+}
+
+std::size_t FairQueue::depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return depth_;
+}
+
+std::size_t FairQueue::active() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_;
+}
+
+} // namespace ntonix::balancer
@@ -0,0 +1,224 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Fair Queue - Admission control shared fairly across tenants and priorities
+ */
+
+#ifndef NTONIX_BALANCER_FAIR_QUEUE_HPP
+#define NTONIX_BALANCER_FAIR_QUEUE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace ntonix::balancer {
+
+/**
+ * Request priority, taken from the X-Priority header
+ */
+enum class Priority {
+    low,
+    normal,
+    high
+};
+
+/**
+ * Configuration for the fair queue
+ */
+struct FairQueueConfig {
+    std::size_t max_concurrent{64};                  // Backend requests in flight before queueing
+    std::size_t max_depth{256};                      // Queued requests before rejecting new ones
+    std::chrono::milliseconds target_delay{100};     // CoDel: acceptable standing queue delay
+    std::chrono::milliseconds interval{1000};        // CoDel: how long delay may exceed target before dropping
+    std::chrono::milliseconds max_wait{30000};       // Longest any request waits for a slot
+};
+
+/**
+ * Outcome of asking for a backend slot
+ */
+enum class AdmitStatus {
+    admitted,   // Slot granted
+    rejected,   // Queue full
+    dropped,    // Shed by CoDel while the queue was persistently slow
+    expired     // Request deadline passed while waiting
+};
+
+/**
+ * Fair Queue - gateway-side request queue in front of backend selection
+ *
+ * At most max_concurrent requests hold a slot (are talking to a backend) at
+ * a time. Further requests wait in per-flow FIFOs, where a flow is one
+ * (tenant, priority) pair, and freed slots are handed out by deficit
+ * round-robin: per turn a normal flow sends one request, a high priority
+ * flow four, and a low priority flow one every four turns. A tenant with a
+ * deep batch backlog therefore cannot starve others, and high priority
+ * traffic gets a larger share without starving low.
+ *
+ * Queueing delay is controlled CoDel-style: once the head-of-line delay
+ * has stayed above target_delay for a whole interval, requests are shed
+ * at an increasing rate until the delay recovers. Requests whose own
+ * deadline passes while queued are dropped as well.
+ *
+ * Waiting blocks the calling thread, matching the synchronous request
+ * handlers. Thread-safe.
+ */
+class FairQueue {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * A granted backend slot; releasing it (destruction) admits the next request
+     */
+    class Slot {
+    public:
+        Slot() = default;
+        ~Slot();
+
+        // Move-only
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+        Slot(Slot&& other) noexcept;
+        Slot& operator=(Slot&& other) noexcept;
+
+        /**
+         * Release the slot early
+         */
+        void release();
+
+    private:
+        friend class FairQueue;
+        explicit Slot(FairQueue* owner) : owner_(owner) {}
+
+        FairQueue* owner_{nullptr};
+    };
+
+    /**
+     * Result of admit()
+     */
+    struct Admission {
+        AdmitStatus status{AdmitStatus::rejected};
+        Slot slot;                               // Valid if status == admitted
+        std::chrono::milliseconds waited{0};     // Time spent queued
+    };
+
+    explicit FairQueue(const FairQueueConfig& config = {});
+
+    // Non-copyable
+    FairQueue(const FairQueue&) = delete;
+    FairQueue& operator=(const FairQueue&) = delete;
+
+    /**
+     * Wait for a backend slot
+     * @param tenant Tenant identity (see proxy::tenant_id())
+     * @param priority Request priority
+     * @param deadline Give up at this time (capped at now + max_wait)
+     */
+    Admission admit(std::uint64_t tenant, Priority priority, clock::time_point deadline);
+
+    /**
+     * Parse an X-Priority header value ("high", "normal", "low"; default normal)
+     */
+    static Priority parse_priority(std::string_view value);
+
+    /**
+     * Number of requests currently waiting
+     */
+    std::size_t depth() const;
+
+    /**
+     * Number of slots currently held
+     */
+    std::size_t active() const;
+
+    const FairQueueConfig& config() const { return config_; }
+
+private:
+    enum class WaiterState {
+        queued,
+        admitted,
+        dropped,
+        expired,
+        abandoned    // Gave up on its own; skipped when reached
+    };
+
+    struct Waiter {
+        std::condition_variable cv;
+        WaiterState state{WaiterState::queued};
+        clock::time_point enqueued;
+        clock::time_point deadline;
+    };
+
+    struct FlowKey {
+        std::uint64_t tenant;
+        Priority priority;
+        bool operator==(const FlowKey& other) const {
+            return tenant == other.tenant && priority == other.priority;
+        }
+    };
+
+    struct FlowKeyHash {
+        std::size_t operator()(const FlowKey& key) const {
+            return std::hash<std::uint64_t>{}(key.tenant) ^ (static_cast<std::size_t>(key.priority) << 1);
+        }
+    };
+
+    struct Flow {
+        std::deque<std::shared_ptr<Waiter>> waiters;
+        std::size_t deficit{0};   // Credit in kRequestCost units per request
+        bool in_turn{false};      // Quantum already added for the current turn
+    };
+
+    /**
+     * Deficit charged per admitted request
+     */
+    static constexpr std::size_t kRequestCost = 4;
+
+    /**
+     * Deficit added per round-robin turn (kRequestCost = one request)
+     */
+    static std::size_t weight(Priority priority);
+
+    /**
+     * Return a slot and hand it to the next request
+     */
+    void release_slot();
+
+    /**
+     * Admit queued requests while slots are free (mutex_ held)
+     */
+    void dispatch_locked(clock::time_point now);
+
+    /**
+     * Next waiter in deficit round-robin order (mutex_ held)
+     */
+    std::shared_ptr<Waiter> pop_next_locked();
+
+    /**
+     * CoDel drop decision for a request that waited `sojourn` (mutex_ held)
+     */
+    bool codel_should_drop_locked(std::chrono::nanoseconds sojourn, clock::time_point now);
+
+    FairQueueConfig config_;
+
+    mutable std::mutex mutex_;
+    std::size_t active_{0};
+    std::size_t depth_{0};
+    std::unordered_map<FlowKey, Flow, FlowKeyHash> flows_;
+    std::list<FlowKey> ring_;   // Backlogged flows in round-robin order
+
+    // CoDel state
+    clock::time_point first_above_{};   // When the delay first exceeded target (+ interval)
+    clock::time_point drop_next_{};
+    std::uint32_t drop_count_{0};
+    bool dropping_{false};
+};
+
+} // namespace ntonix::balancer
+
+#endif // NTONIX_BALANCER_FAIR_QUEUE_HPP
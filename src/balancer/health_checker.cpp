@@ -9,11 +9,17 @@
 
 namespace ntonix::balancer {
 
-HealthChecker::HealthChecker(asio::io_context& io_context, const HealthCheckConfig& config)
+HealthChecker::HealthChecker(asio::io_context& io_context, const HealthCheckConfig& config,
+                             std::shared_ptr<util::DnsCache> dns_cache)
     : io_context_(io_context)
     , timer_(io_context)
     , config_(config)
+    , dns_cache_(dns_cache ? std::move(dns_cache)
+                           : std::make_shared<util::DnsCache>(io_context, std::chrono::seconds(30)))
 {
+    for (auto& healthy : healthy_) {
+        healthy.store(config::kNoBackendId, std::memory_order_relaxed);
+    }
     spdlog::debug("HealthChecker created with interval={}ms, timeout={}ms, "
                   "unhealthy_threshold={}, healthy_threshold={}",
                   config_.interval.count(), config_.timeout.count(),
@@ -28,10 +34,10 @@ void HealthChecker::set_backends(const std::vector<config::BackendConfig>& backe
     std::lock_guard<std::mutex> lock(mutex_);
 
     // Track existing backends to detect removed ones
-    std::unordered_map<std::string, BackendHealth> new_backends;
+    std::unordered_map<config::BackendId, BackendHealth> new_backends;
 
     for (const auto& backend : backends) {
-        std::string key = backend_key(backend);
+        auto key = backend.id;
 
         // Preserve existing health state if backend exists
         auto it = backends_.find(key);
@@ -56,10 +62,15 @@ void HealthChecker::set_backends(const std::vector<config::BackendConfig>& backe
     for (const auto& [key, health] : backends_) {
         if (new_backends.find(key) == new_backends.end()) {
             spdlog::info("Removed backend {}:{}", health.config.host, health.config.port);
+            healthy_[config::BackendRegistry::slot(key)].store(config::kNoBackendId, std::memory_order_relaxed);
         }
     }
 
     backends_ = std::move(new_backends);
+    for (const auto& [key, health] : backends_) {
+        healthy_[config::BackendRegistry::slot(key)].store(
+            health.state == BackendState::healthy ? key : config::kNoBackendId, std::memory_order_relaxed);
+    }
 }
 
 void HealthChecker::start() {
@@ -105,9 +116,8 @@ std::vector<BackendHealth> HealthChecker::get_all_backends() const {
 }
 
 bool HealthChecker::is_healthy(const config::BackendConfig& backend) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = backends_.find(backend_key(backend));
-    return it != backends_.end() && it->second.state == BackendState::healthy;
+    return backend.id != config::kNoBackendId &&
+           healthy_[config::BackendRegistry::slot(backend.id)].load(std::memory_order_relaxed) == backend.id;
 }
 
 void HealthChecker::on_state_change(StateChangeCallback callback) {
@@ -151,16 +161,15 @@ void HealthChecker::schedule_health_check() {
 void HealthChecker::check_backend(const config::BackendConfig& backend) {
     auto start_time = std::chrono::steady_clock::now();
 
-    // Create a new resolver and socket for this check
-    auto resolver = std::make_shared<tcp::resolver>(io_context_);
+    // Create a new socket for this check
     auto socket = std::make_shared<tcp::socket>(io_context_);
 
-    // Resolve the backend host
-    resolver->async_resolve(
+    // Resolve the backend host (cached; a stale answer is refreshed in the background)
+    dns_cache_->async_resolve(
         backend.host,
-        std::to_string(backend.port),
-        [self = shared_from_this(), backend, socket, resolver, start_time]
-        (boost::system::error_code ec, tcp::resolver::results_type results) {
+        backend.port,
+        [self = shared_from_this(), backend, socket, start_time]
+        (const boost::system::error_code& ec, std::vector<tcp::endpoint> results) {
             if (ec) {
                 spdlog::debug("Health check DNS resolution failed for {}:{}: {}",
                              backend.host, backend.port, ec.message());
@@ -254,8 +263,7 @@ void HealthChecker::handle_check_result(const config::BackendConfig& backend, bo
                                         std::chrono::milliseconds response_time) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    auto key = backend_key(backend);
-    auto it = backends_.find(key);
+    auto it = backends_.find(backend.id);
     if (it == backends_.end()) {
         return;  // Backend was removed
     }
@@ -287,6 +295,8 @@ void HealthChecker::handle_check_result(const config::BackendConfig& backend, bo
 
     if (new_state != old_state) {
         health.state = new_state;
+        healthy_[config::BackendRegistry::slot(backend.id)].store(
+            new_state == BackendState::healthy ? backend.id : config::kNoBackendId, std::memory_order_relaxed);
 
         // Log state transition
         spdlog::info("Backend {}:{} state changed: {} -> {}",
@@ -312,8 +322,7 @@ void HealthChecker::handle_check_result(const config::BackendConfig& backend, bo
 void HealthChecker::update_state(const config::BackendConfig& backend, BackendState new_state) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    auto key = backend_key(backend);
-    auto it = backends_.find(key);
+    auto it = backends_.find(backend.id);
     if (it == backends_.end()) {
         return;
     }
@@ -324,6 +333,8 @@ void HealthChecker::update_state(const config::BackendConfig& backend, BackendSt
     }
 
     it->second.state = new_state;
+    healthy_[config::BackendRegistry::slot(backend.id)].store(
+        new_state == BackendState::healthy ? backend.id : config::kNoBackendId, std::memory_order_relaxed);
 
     spdlog::info("Backend {}:{} state changed: {} -> {}",
                  backend.host, backend.port,
@@ -338,8 +349,4 @@ void HealthChecker::update_state(const config::BackendConfig& backend, BackendSt
     }
 }
 
-std::string HealthChecker::backend_key(const config::BackendConfig& backend) {
-    return backend.host + ":" + std::to_string(backend.port);
-}
-
 } // namespace ntonix::balancer
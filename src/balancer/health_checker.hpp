@@ -6,13 +6,16 @@
 #ifndef NTONIX_BALANCER_HEALTH_CHECKER_HPP
 #define NTONIX_BALANCER_HEALTH_CHECKER_HPP
 
+#include "config/backend_registry.hpp"
 #include "config/config.hpp"
+#include "util/dns_cache.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <spdlog/spdlog.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <functional>
@@ -98,8 +101,10 @@ public:
      * Create a health checker
      * @param io_context Asio io_context for async operations
      * @param config Health check configuration
+     * @param dns_cache Resolver cache shared with other components (a private one if null)
      */
-    HealthChecker(asio::io_context& io_context, const HealthCheckConfig& config = {});
+    HealthChecker(asio::io_context& io_context, const HealthCheckConfig& config = {},
+                  std::shared_ptr<util::DnsCache> dns_cache = nullptr);
     ~HealthChecker();
 
     // Non-copyable
@@ -133,7 +138,7 @@ public:
     std::vector<BackendHealth> get_all_backends() const;
 
     /**
-     * Check if a specific backend is healthy (thread-safe)
+     * Check if a specific backend is healthy (thread-safe, lock-free)
      */
     bool is_healthy(const config::BackendConfig& backend) const;
 
@@ -169,19 +174,19 @@ private:
      */
     void update_state(const config::BackendConfig& backend, BackendState new_state);
 
-    /**
-     * Generate unique key for backend
-     */
-    static std::string backend_key(const config::BackendConfig& backend);
-
     asio::io_context& io_context_;
     asio::steady_timer timer_;
     HealthCheckConfig config_;
+    std::shared_ptr<util::DnsCache> dns_cache_;
 
     mutable std::mutex mutex_;
-    std::unordered_map<std::string, BackendHealth> backends_;
+    std::unordered_map<config::BackendId, BackendHealth> backends_;
     std::vector<StateChangeCallback> state_callbacks_;
 
+    // Id of the backend in each slot if its state is healthy (else kNoBackendId),
+    // read by is_healthy() on every selection
+    std::array<std::atomic<config::BackendId>, config::BackendRegistry::kMaxBackends> healthy_;
+
     std::atomic<bool> running_{false};
 };
 
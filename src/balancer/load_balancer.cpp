@@ -43,6 +43,11 @@ void LoadBalancer::set_backends(const std::vector<config::BackendConfig>& backen
 }
 
 std::optional<BackendSelection> LoadBalancer::select_backend() {
+    return select_backend({});
+}
+
+std::optional<BackendSelection> LoadBalancer::select_backend(
+    const std::vector<config::BackendConfig>& exclude) {
     // Take a snapshot of backends under lock
     std::vector<std::shared_ptr<BackendState>> backends_snapshot;
     {
@@ -58,18 +63,31 @@ std::optional<BackendSelection> LoadBalancer::select_backend() {
     // Smooth Weighted Round-Robin (SWRR) algorithm
     // This is lock-free using atomics for the selection phase
 
-    // Calculate total weight of healthy backends
+    // A backend is eligible if it is healthy and not excluded by the caller
+    auto is_eligible = [&](const BackendState& backend) {
+        if (health_checker_ && !health_checker_->is_healthy(backend.config)) {
+            return false;
+        }
+        return std::none_of(exclude.begin(), exclude.end(), [&](const config::BackendConfig& excluded) {
+            return excluded.id == backend.config.id;
+        });
+    };
+
+    // Calculate total weight of eligible backends
     std::int64_t healthy_total = 0;
     for (const auto& backend : backends_snapshot) {
-        // Check if backend is healthy (if health checker is available)
-        if (health_checker_ && !health_checker_->is_healthy(backend->config)) {
+        if (!is_eligible(*backend)) {
             continue;
         }
         healthy_total += backend->config.weight;
     }
 
     if (healthy_total == 0) {
-        spdlog::warn("LoadBalancer: No healthy backends available");
+        if (exclude.empty()) {
+            spdlog::warn("LoadBalancer: No healthy backends available");
+        } else {
+            spdlog::debug("LoadBalancer: No healthy backends left after excluding {}", exclude.size());
+        }
         return std::nullopt;
     }
 
@@ -81,8 +99,8 @@ std::optional<BackendSelection> LoadBalancer::select_backend() {
     for (std::size_t i = 0; i < backends_snapshot.size(); ++i) {
         auto& backend = backends_snapshot[i];
 
-        // Skip unhealthy backends
-        if (health_checker_ && !health_checker_->is_healthy(backend->config)) {
+        // Skip unhealthy and excluded backends
+        if (!is_eligible(*backend)) {
             continue;
         }
 
@@ -71,6 +71,15 @@ public:
      */
     std::optional<BackendSelection> select_backend();
 
+    /**
+     * Select the next backend, skipping the given backends
+     * Used by retries so that a failed request is never re-sent to a backend
+     * that already failed it.
+     * @param exclude Backends that must not be selected
+     * @return Backend selection if an eligible healthy backend exists, nullopt otherwise
+     */
+    std::optional<BackendSelection> select_backend(const std::vector<config::BackendConfig>& exclude);
+
     /**
      * Get number of configured backends
      */
@@ -5,6 +5,7 @@
 
 #include "cache/cache_key.hpp"
 
+#include <nlohmann/json.hpp>
 #include <xxhash.h>
 
 #include <algorithm>
@@ -45,6 +46,20 @@ CacheKey generate_cache_key(std::string_view method, std::string_view target, st
     return key;
 }
 
+CacheKey generate_completion_cache_key(std::string_view method, std::string_view target, std::string_view body) {
+    auto request = nlohmann::json::parse(body, nullptr, false);
+    if (request.is_discarded() || !request.is_object()) {
+        return generate_cache_key(method, target, body);
+    }
+
+    // Streaming is a delivery choice, not a generation parameter
+    request.erase("stream");
+    request.erase("stream_options");
+
+    // nlohmann::json objects are key-ordered, so dump() is canonical
+    return generate_cache_key(method, target, request.dump());
+}
+
 bool should_bypass_cache(std::string_view cache_control) {
     if (cache_control.empty()) {
         return false;
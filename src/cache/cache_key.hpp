@@ -72,6 +72,21 @@ CacheKey generate_cache_key(std::string_view body);
  */
 CacheKey generate_cache_key(std::string_view method, std::string_view target, std::string_view body);
 
+/**
+ * Generate a cache key for a chat completion request
+ *
+ * The JSON body is normalized before hashing: transport-only fields
+ * ("stream", "stream_options") are removed and object keys are ordered,
+ * so streaming and non-streaming requests for the same generation share
+ * one key. Bodies that are not JSON objects are hashed as-is.
+ *
+ * @param method HTTP method
+ * @param target Request target (URI)
+ * @param body Request body
+ * @return Cache key
+ */
+CacheKey generate_completion_cache_key(std::string_view method, std::string_view target, std::string_view body);
+
 /**
  * Check if a request should bypass cache based on headers
  *
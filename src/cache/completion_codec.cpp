@@ -0,0 +1,393 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Completion Codec Implementation
+ */
+
+#include "cache/completion_codec.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <map>
+
+namespace ntonix::cache {
+
+namespace {
+
+constexpr std::string_view kDataPrefix = "data:";
+constexpr std::string_view kDoneMarker = "[DONE]";
+
+bool is_sse_field_line(std::string_view line) {
+    return line.starts_with(":") ||
+           line.starts_with("data:") ||
+           line.starts_with("event:") ||
+           line.starts_with("id:") ||
+           line.starts_with("retry:");
+}
+
+/**
+ * Payload of a "data:" line (leading space after the colon removed)
+ */
+std::string_view data_payload(std::string_view event) {
+    if (!event.starts_with(kDataPrefix)) {
+        return {};
+    }
+    event.remove_prefix(kDataPrefix.size());
+    if (event.starts_with(" ")) {
+        event.remove_prefix(1);
+    }
+    while (!event.empty() && (event.back() == '\n' || event.back() == '\r')) {
+        event.remove_suffix(1);
+    }
+    return event;
+}
+
+std::string format_event(const nlohmann::json& chunk) {
+    return "data: " + chunk.dump() + "\n\n";
+}
+
+/**
+ * Null, "", [] and {} carry nothing (e.g. "refusal": null, "annotations": [])
+ */
+bool is_empty(const nlohmann::json& value) {
+    return value.is_null() || (value.is_string() && value.get_ref<const std::string&>().empty()) ||
+           ((value.is_array() || value.is_object()) && value.empty());
+}
+
+/**
+ * Append a streamed function fragment ({"name": ..., "arguments": ...}) to a call
+ */
+bool merge_function(nlohmann::json& function, const nlohmann::json& fragment) {
+    if (!fragment.is_object()) {
+        return false;
+    }
+    for (const auto& [key, value] : fragment.items()) {
+        if (value.is_null()) {
+            continue;
+        }
+        if (!value.is_string()) {
+            return false;
+        }
+        auto& field = function[key];
+        if (!field.is_string()) {
+            field = "";
+        }
+        field.get_ref<std::string&>() += value.get_ref<const std::string&>();
+    }
+    return true;
+}
+
+/**
+ * Per-choice state while assembling a stream
+ */
+struct AssembledChoice {
+    std::string role{"assistant"};
+    std::string content;
+    bool has_content{false};
+    std::string refusal;
+    std::map<std::int64_t, nlohmann::json> tool_calls;   // By tool call index
+    nlohmann::json function_call;                        // Legacy single function call
+    nlohmann::json logprobs;                             // Token lists concatenated
+    nlohmann::json finish_reason;
+
+    /**
+     * Fold one delta in; false if it carries a field the completion could not represent
+     */
+    bool merge(const nlohmann::json& delta);
+
+    /**
+     * Append a chunk's logprobs; false if they are not token lists
+     */
+    bool merge_logprobs(const nlohmann::json& chunk_logprobs);
+
+    nlohmann::json message() const;
+};
+
+bool AssembledChoice::merge(const nlohmann::json& delta) {
+    for (const auto& [key, value] : delta.items()) {
+        if (key == "role") {
+            if (value.is_string()) {
+                role = value.get<std::string>();
+            }
+        } else if (key == "content" && value.is_string()) {
+            content += value.get_ref<const std::string&>();
+            has_content = true;
+        } else if (key == "refusal" && value.is_string()) {
+            refusal += value.get_ref<const std::string&>();
+        } else if (key == "tool_calls" && value.is_array()) {
+            for (const auto& fragment : value) {
+                if (!fragment.is_object()) {
+                    return false;
+                }
+                auto& call = tool_calls[fragment.value("index", std::int64_t{0})];
+                for (const auto& [field, part] : fragment.items()) {
+                    if (field == "function") {
+                        if (!merge_function(call["function"], part)) {
+                            return false;
+                        }
+                    } else if (field != "index" && !part.is_null()) {
+                        call[field] = part;
+                    }
+                }
+            }
+        } else if (key == "function_call") {
+            if (!merge_function(function_call, value)) {
+                return false;
+            }
+        } else if (!is_empty(value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AssembledChoice::merge_logprobs(const nlohmann::json& chunk_logprobs) {
+    if (chunk_logprobs.is_null()) {
+        return true;
+    }
+    if (!chunk_logprobs.is_object()) {
+        return false;
+    }
+    for (const auto& [key, tokens] : chunk_logprobs.items()) {
+        if (tokens.is_null()) {
+            continue;
+        }
+        if (!tokens.is_array()) {
+            return false;
+        }
+        auto& merged = logprobs[key];
+        if (!merged.is_array()) {
+            merged = nlohmann::json::array();
+        }
+        merged.insert(merged.end(), tokens.begin(), tokens.end());
+    }
+    return true;
+}
+
+nlohmann::json AssembledChoice::message() const {
+    nlohmann::json message = {{"role", role}};
+
+    // A message that only calls tools has null content, as in a non-streamed response
+    bool calls = !tool_calls.empty() || !function_call.is_null();
+    message["content"] = has_content || !calls ? nlohmann::json(content) : nlohmann::json(nullptr);
+    if (!refusal.empty()) {
+        message["refusal"] = refusal;
+    }
+    if (!tool_calls.empty()) {
+        message["tool_calls"] = nlohmann::json::array();
+        for (const auto& [index, call] : tool_calls) {
+            message["tool_calls"].push_back(call);
+        }
+    }
+    if (!function_call.is_null()) {
+        message["function_call"] = function_call;
+    }
+    return message;
+}
+
+} // namespace
+
+std::vector<std::string> split_sse_events(std::string_view body) {
+    std::vector<std::string> events;
+    std::string current;
+
+    std::size_t pos = 0;
+    while (pos < body.size()) {
+        auto end = body.find('\n', pos);
+        auto line = body.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        pos = end == std::string_view::npos ? body.size() : end + 1;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        if (line.empty()) {
+            // Blank line dispatches the event
+            if (!current.empty()) {
+                current += '\n';
+                events.push_back(std::move(current));
+                current.clear();
+            }
+            continue;
+        }
+
+        if (is_sse_field_line(line)) {
+            current.append(line);
+            current += '\n';
+        }
+    }
+
+    // A trailing event without its blank line is incomplete and dropped
+    return events;
+}
+
+std::optional<std::string> sse_to_completion(std::string_view sse_body) {
+    nlohmann::json first_chunk;
+    nlohmann::json usage;
+    std::map<std::int64_t, AssembledChoice> choices;
+    bool done = false;
+
+    for (const auto& event : split_sse_events(sse_body)) {
+        auto payload = data_payload(event);
+        if (payload.empty()) {
+            continue;
+        }
+        if (payload == kDoneMarker) {
+            done = true;
+            break;
+        }
+
+        auto chunk = nlohmann::json::parse(payload, nullptr, false);
+        if (chunk.is_discarded() || !chunk.is_object()) {
+            return std::nullopt;
+        }
+        if (first_chunk.is_null()) {
+            first_chunk = chunk;
+        }
+        if (chunk.contains("usage") && chunk["usage"].is_object()) {
+            usage = chunk["usage"];
+        }
+        if (!chunk.contains("choices") || !chunk["choices"].is_array()) {
+            continue;
+        }
+
+        for (const auto& choice : chunk["choices"]) {
+            auto& assembled = choices[choice.value("index", std::int64_t{0})];
+
+            // Anything the completion could not carry makes the entry unusable in this form
+            if (choice.contains("delta") && choice["delta"].is_object() && !assembled.merge(choice["delta"])) {
+                return std::nullopt;
+            }
+            if (choice.contains("logprobs") && !assembled.merge_logprobs(choice["logprobs"])) {
+                return std::nullopt;
+            }
+            if (choice.contains("finish_reason") && !choice["finish_reason"].is_null()) {
+                assembled.finish_reason = choice["finish_reason"];
+            }
+        }
+    }
+
+    if (!done || first_chunk.is_null()) {
+        return std::nullopt;
+    }
+
+    nlohmann::json completion = {
+        {"id", first_chunk.value("id", "")},
+        {"object", "chat.completion"},
+        {"created", first_chunk.value("created", std::int64_t{0})},
+        {"model", first_chunk.value("model", "")},
+        {"choices", nlohmann::json::array()}
+    };
+    for (const auto& [index, assembled] : choices) {
+        nlohmann::json choice = {{"index", index}, {"message", assembled.message()}};
+        if (!assembled.logprobs.is_null()) {
+            choice["logprobs"] = assembled.logprobs;
+        }
+        choice["finish_reason"] = assembled.finish_reason;
+        completion["choices"].push_back(std::move(choice));
+    }
+    if (!usage.is_null()) {
+        completion["usage"] = usage;
+    }
+
+    return completion.dump();
+}
+
+std::optional<std::vector<std::string>> completion_to_sse_events(std::string_view json_body,
+                                                                 bool split_content) {
+    auto completion = nlohmann::json::parse(json_body, nullptr, false);
+    if (completion.is_discarded() || !completion.is_object() ||
+        !completion.contains("choices") || !completion["choices"].is_array()) {
+        return std::nullopt;
+    }
+
+    nlohmann::json base = {
+        {"id", completion.value("id", "")},
+        {"object", "chat.completion.chunk"},
+        {"created", completion.value("created", std::int64_t{0})},
+        {"model", completion.value("model", "")}
+    };
+
+    auto make_chunk = [&base](std::int64_t index, nlohmann::json delta, nlohmann::json finish_reason,
+                              nlohmann::json logprobs = nullptr) {
+        nlohmann::json choice = {{"index", index}, {"delta", std::move(delta)}};
+        if (!logprobs.is_null()) {
+            choice["logprobs"] = std::move(logprobs);
+        }
+        choice["finish_reason"] = std::move(finish_reason);
+        auto chunk = base;
+        chunk["choices"] = nlohmann::json::array({std::move(choice)});
+        return format_event(chunk);
+    };
+
+    std::vector<std::string> events;
+    for (const auto& choice : completion["choices"]) {
+        if (!choice.is_object() || !choice.contains("message") || !choice["message"].is_object()) {
+            return std::nullopt;
+        }
+        auto index = choice.value("index", std::int64_t{0});
+        const auto& message = choice["message"];
+
+        // Anything the stream could not carry makes the entry unusable in this form
+        for (const auto& [key, value] : message.items()) {
+            if (key != "role" && key != "content" && key != "refusal" && key != "tool_calls" &&
+                key != "function_call" && !is_empty(value)) {
+                return std::nullopt;
+            }
+        }
+
+        auto role = message.value("role", "assistant");
+        auto content = message.contains("content") && message["content"].is_string()
+            ? message["content"].get<std::string>()
+            : std::string{};
+
+        // Tool-call-only messages keep their null content
+        auto first_content = message.contains("content") && message["content"].is_null()
+            ? nlohmann::json(nullptr) : nlohmann::json("");
+        events.push_back(make_chunk(index, {{"role", role}, {"content", first_content}}, nullptr));
+
+        if (split_content) {
+            // Word-sized pieces (each keeps its leading space) approximate token pacing
+            std::size_t start = 0;
+            while (start < content.size()) {
+                auto next = content.find(' ', start + 1);
+                auto piece = content.substr(start, next == std::string::npos ? std::string::npos : next - start);
+                events.push_back(make_chunk(index, {{"content", piece}}, nullptr));
+                start = next == std::string::npos ? content.size() : next;
+            }
+        } else if (!content.empty()) {
+            events.push_back(make_chunk(index, {{"content", content}}, nullptr));
+        }
+
+        if (message.contains("refusal") && message["refusal"].is_string() && !is_empty(message["refusal"])) {
+            events.push_back(make_chunk(index, {{"refusal", message["refusal"]}}, nullptr));
+        }
+        if (message.contains("tool_calls") && !is_empty(message["tool_calls"])) {
+            if (!message["tool_calls"].is_array()) {
+                return std::nullopt;
+            }
+            // Each call whole in one delta, indexed as streams number them
+            auto calls = nlohmann::json::array();
+            for (const auto& call : message["tool_calls"]) {
+                if (!call.is_object()) {
+                    return std::nullopt;
+                }
+                auto indexed = call;
+                indexed["index"] = calls.size();
+                calls.push_back(std::move(indexed));
+            }
+            events.push_back(make_chunk(index, {{"tool_calls", std::move(calls)}}, nullptr));
+        }
+        if (message.contains("function_call") && !is_empty(message["function_call"])) {
+            events.push_back(make_chunk(index, {{"function_call", message["function_call"]}}, nullptr));
+        }
+
+        auto finish_reason = choice.contains("finish_reason") ? choice["finish_reason"] : nlohmann::json("stop");
+        auto logprobs = choice.contains("logprobs") ? choice["logprobs"] : nlohmann::json(nullptr);
+        events.push_back(make_chunk(index, nlohmann::json::object(), finish_reason, logprobs));
+    }
+
+    events.push_back("data: [DONE]\n\n");
+    return events;
+}
+
+} // namespace ntonix::cache
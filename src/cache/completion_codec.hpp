@@ -0,0 +1,65 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Completion Codec - Conversion between streamed (SSE) and assembled (JSON) completions
+ *
+ * A completion is cached in whichever form the backend produced it. The codec
+ * lets a streamed completion answer a later non-streaming request (events are
+ * assembled into one chat.completion object) and a JSON completion answer a
+ * later streaming request (the object is replayed as chat.completion.chunk
+ * events followed by [DONE]).
+ */
+
+#ifndef NTONIX_CACHE_COMPLETION_CODEC_HPP
+#define NTONIX_CACHE_COMPLETION_CODEC_HPP
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ntonix::cache {
+
+/**
+ * Content types under which completions are stored in the cache
+ */
+inline constexpr std::string_view kSseContentType = "text/event-stream";
+inline constexpr std::string_view kJsonContentType = "application/json";
+
+/**
+ * Split an SSE body into complete events
+ *
+ * Only SSE field lines (data:, event:, id:, retry:, comments) are kept and each
+ * returned event ends with a blank line, so the events can be written to a
+ * client as-is. Anything else (e.g. transfer framing) is dropped.
+ *
+ * @param body Raw SSE text
+ * @return Events in order, each terminated by "\n\n"
+ */
+std::vector<std::string> split_sse_events(std::string_view body);
+
+/**
+ * Assemble a streamed chat completion into a chat.completion JSON object
+ *
+ * Content, refusals and logprobs are concatenated and tool_calls deltas merged
+ * by index.
+ *
+ * @param sse_body SSE text of a complete stream
+ * @return JSON body, or nullopt if the stream is incomplete (no [DONE]), unparseable
+ *         or has delta fields a completion message cannot carry
+ */
+std::optional<std::string> sse_to_completion(std::string_view sse_body);
+
+/**
+ * Convert a chat.completion JSON object into chat.completion.chunk SSE events
+ *
+ * @param json_body JSON body of a non-streaming completion
+ * @param split_content Emit message content word by word instead of in one event
+ * @return Events ending with "data: [DONE]", or nullopt if the body is not a completion
+ *         or its messages have fields the events cannot carry
+ */
+std::optional<std::vector<std::string>> completion_to_sse_events(std::string_view json_body,
+                                                                 bool split_content = false);
+
+} // namespace ntonix::cache
+
+#endif // NTONIX_CACHE_COMPLETION_CODEC_HPP
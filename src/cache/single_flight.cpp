@@ -0,0 +1,129 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Single-Flight Implementation
+ */
+
+#include "cache/single_flight.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace ntonix::cache {
+
+// ============================================================================
+// SingleFlight::Call Implementation
+// ============================================================================
+
+SingleFlight::Call::Call(SingleFlight* owner, CacheKey key, std::shared_ptr<Flight> flight, bool leader)
+    : owner_(owner)
+    , key_(key)
+    , flight_(std::move(flight))
+    , leader_(leader) {
+}
+
+SingleFlight::Call::~Call() {
+    abandon();
+}
+
+void SingleFlight::Call::abandon() {
+    if (!flight_) {
+        return;
+    }
+    if (!leader_) {
+        flight_->followers.fetch_sub(1, std::memory_order_relaxed);
+    } else if (!published_) {
+        // A leader that never published would leave followers waiting until timeout
+        publish(FlightResult{});
+    }
+}
+
+SingleFlight::Call::Call(Call&& other) noexcept
+    : owner_(other.owner_)
+    , key_(other.key_)
+    , flight_(std::move(other.flight_))
+    , leader_(other.leader_)
+    , published_(other.published_) {
+    other.leader_ = false;
+}
+
+SingleFlight::Call& SingleFlight::Call::operator=(Call&& other) noexcept {
+    if (this != &other) {
+        abandon();
+        owner_ = other.owner_;
+        key_ = other.key_;
+        flight_ = std::move(other.flight_);
+        leader_ = other.leader_;
+        published_ = other.published_;
+        other.leader_ = false;
+    }
+    return *this;
+}
+
+void SingleFlight::Call::publish(FlightResult result) {
+    if (!leader_ || published_ || !flight_) {
+        return;
+    }
+    published_ = true;
+    owner_->finish(key_, flight_, std::move(result));
+}
+
+bool SingleFlight::Call::has_followers() const {
+    return leader_ && flight_ && flight_->followers.load(std::memory_order_relaxed) > 0;
+}
+
+std::optional<FlightResult> SingleFlight::Call::wait(std::chrono::milliseconds timeout) {
+    if (leader_ || !flight_) {
+        return std::nullopt;
+    }
+
+    std::unique_lock<std::mutex> lock(flight_->mutex);
+    if (!flight_->cv.wait_for(lock, timeout, [this] { return flight_->done; })) {
+        spdlog::debug("SingleFlight: Timed out waiting for in-flight request key={}", key_.to_string());
+        return std::nullopt;
+    }
+    return flight_->result;
+}
+
+// ============================================================================
+// SingleFlight Implementation
+// ============================================================================
+
+SingleFlight::Call SingleFlight::begin(const CacheKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = flights_.find(key);
+    if (it != flights_.end()) {
+        spdlog::debug("SingleFlight: Joining in-flight request key={}", key.to_string());
+        it->second->followers.fetch_add(1, std::memory_order_relaxed);
+        return Call(this, key, it->second, false);
+    }
+
+    auto flight = std::make_shared<Flight>();
+    flights_.emplace(key, flight);
+    return Call(this, key, std::move(flight), true);
+}
+
+std::size_t SingleFlight::in_flight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flights_.size();
+}
+
+void SingleFlight::finish(const CacheKey& key, const std::shared_ptr<Flight>& flight, FlightResult result) {
+    // Remove from the table first so that requests arriving from now on
+    // go to the cache (or start a new flight) instead of joining this one
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = flights_.find(key);
+        if (it != flights_.end() && it->second == flight) {
+            flights_.erase(it);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(flight->mutex);
+        flight->result = std::move(result);
+        flight->done = true;
+    }
+    flight->cv.notify_all();
+}
+
+} // namespace ntonix::cache
@@ -0,0 +1,137 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Single-Flight - Coalesces identical in-flight requests into one backend call
+ *
+ * When a popular prompt is not cached, concurrent identical requests would
+ * all miss the cache and each trigger a full generation. The single-flight
+ * table lets the first miss for a CacheKey go to the backend (the leader)
+ * while later identical requests (followers) wait for the leader's result.
+ */
+
+#ifndef NTONIX_CACHE_SINGLE_FLIGHT_HPP
+#define NTONIX_CACHE_SINGLE_FLIGHT_HPP
+
+#include "cache/cache_key.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace ntonix::cache {
+
+/**
+ * Result shared by the leader with its followers
+ */
+struct FlightResult {
+    bool success{false};           // False if the leader failed (followers should forward themselves)
+    int status{0};                 // HTTP status code of the backend response (0 = leader abandoned the flight)
+    std::string body;              // Response body
+    std::string content_type;      // Content-Type header
+};
+
+/**
+ * Table of in-flight requests keyed by CacheKey
+ *
+ * Thread-safe. Followers block on a condition variable, which matches the
+ * synchronous request handler model used by the non-streaming path.
+ */
+class SingleFlight {
+private:
+    struct Flight {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done{false};
+        FlightResult result;
+        std::atomic<std::size_t> followers{0};  // Live follower Calls
+    };
+
+public:
+    /**
+     * Handle for one request's participation in a flight
+     *
+     * The leader must publish() its result; if it is destroyed without doing
+     * so (exception, early return), followers are released with a failed result.
+     */
+    class Call {
+    public:
+        Call() = default;
+        ~Call();
+
+        // Move-only
+        Call(const Call&) = delete;
+        Call& operator=(const Call&) = delete;
+        Call(Call&& other) noexcept;
+        Call& operator=(Call&& other) noexcept;
+
+        /**
+         * True if this request must go to the backend itself
+         */
+        bool is_leader() const { return leader_; }
+
+        /**
+         * Leader only: true while identical requests are waiting for this one
+         */
+        bool has_followers() const;
+
+        /**
+         * Leader only: share the result with followers and close the flight
+         */
+        void publish(FlightResult result);
+
+        /**
+         * Follower only: wait for the leader's result
+         * @return The leader's result, or nullopt on timeout
+         */
+        std::optional<FlightResult> wait(std::chrono::milliseconds timeout);
+
+    private:
+        friend class SingleFlight;
+
+        /**
+         * Leader: release followers with a failed result; follower: leave the flight
+         */
+        void abandon();
+
+        Call(SingleFlight* owner, CacheKey key, std::shared_ptr<Flight> flight, bool leader);
+
+        SingleFlight* owner_{nullptr};
+        CacheKey key_;
+        std::shared_ptr<Flight> flight_;
+        bool leader_{false};
+        bool published_{false};
+    };
+
+    SingleFlight() = default;
+
+    // Non-copyable
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    /**
+     * Join the flight for a key, becoming leader if none is in progress
+     */
+    Call begin(const CacheKey& key);
+
+    /**
+     * Number of distinct keys currently in flight
+     */
+    std::size_t in_flight() const;
+
+private:
+    /**
+     * Remove a finished flight from the table and wake its followers
+     */
+    void finish(const CacheKey& key, const std::shared_ptr<Flight>& flight, FlightResult result);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<CacheKey, std::shared_ptr<Flight>, CacheKeyHash> flights_;
+};
+
+} // namespace ntonix::cache
+
+#endif // NTONIX_CACHE_SINGLE_FLIGHT_HPP
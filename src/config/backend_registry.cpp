@@ -0,0 +1,136 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Backend Registry implementation
+ */
+
+#include "config/backend_registry.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace ntonix::config {
+
+BackendRegistry& BackendRegistry::instance() {
+    static BackendRegistry instance;
+    return instance;
+}
+
+std::string BackendRegistry::key(const std::string& host, std::uint16_t port) {
+    return host + ":" + std::to_string(port);
+}
+
+std::uint64_t BackendRegistry::assign(std::vector<BackendConfig>& backends) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto generation = generation_.load(std::memory_order_relaxed);
+    std::size_t size = size_.load(std::memory_order_relaxed);
+
+    // Bound backends keep their ids, the others need a slot
+    std::vector<bool> kept(kMaxBackends, false);
+    std::vector<std::string> unbound;
+    for (const auto& backend : backends) {
+        auto name = key(backend.host, backend.port);
+        auto it = ids_.find(name);
+        if (it != ids_.end()) {
+            kept[slot(it->second)] = true;
+        } else if (std::find(unbound.begin(), unbound.end(), name) == unbound.end()) {
+            unbound.push_back(std::move(name));
+        }
+    }
+
+    // Unused slots first, then the ones retired longest ago
+    std::vector<std::size_t> free;
+    for (std::size_t s = size; s < kMaxBackends && free.size() < unbound.size(); ++s) {
+        free.push_back(s);
+    }
+    if (free.size() < unbound.size()) {
+        std::vector<std::size_t> retired;
+        for (std::size_t s = 0; s < size; ++s) {
+            if (!kept[s]) {
+                retired.push_back(s);
+            }
+        }
+        std::sort(retired.begin(), retired.end(), [this](std::size_t a, std::size_t b) {
+            return generations_[a].load(std::memory_order_relaxed) < generations_[b].load(std::memory_order_relaxed);
+        });
+        for (std::size_t i = 0; i < retired.size() && free.size() < unbound.size(); ++i) {
+            free.push_back(retired[i]);
+        }
+    }
+    if (free.size() < unbound.size()) {
+        throw std::runtime_error("Configuration error: more than " + std::to_string(kMaxBackends) +
+                                 " backends configured");
+    }
+
+    // Counted before binding: a reused slot may still be in the current generation
+    std::size_t current = 0;
+    for (std::size_t s = 0; s < size; ++s) {
+        if (generations_[s].load(std::memory_order_relaxed) == generation) {
+            ++current;
+        }
+    }
+
+    for (std::size_t i = 0; i < unbound.size(); ++i) {
+        auto s = free[i];
+        auto id = static_cast<BackendId>(s);
+        if (s < size) {
+            // The next reuse count (wrapping after 2^22 reuses), never kNoBackendId
+            ids_.erase(keys_[s]);
+            id = slot_ids_[s].load(std::memory_order_relaxed) + static_cast<BackendId>(kMaxBackends);
+            if (id == kNoBackendId) {
+                id = static_cast<BackendId>(s);
+            }
+            spdlog::info("BackendRegistry: Slot {} of removed backend {} reused for {}", s, keys_[s], unbound[i]);
+        }
+        keys_[s] = unbound[i];
+        ids_[unbound[i]] = id;
+        slot_ids_[s].store(id, std::memory_order_release);
+        size = std::max(size, s + 1);
+    }
+    size_.store(size, std::memory_order_release);
+
+    std::vector<BackendId> ids;
+    ids.reserve(backends.size());
+    for (const auto& backend : backends) {
+        ids.push_back(ids_.at(key(backend.host, backend.port)));
+    }
+
+    std::vector<BackendId> unique_ids = ids;
+    std::sort(unique_ids.begin(), unique_ids.end());
+    unique_ids.erase(std::unique(unique_ids.begin(), unique_ids.end()), unique_ids.end());
+
+    // Same set as the current generation?
+    bool changed = generation == 0 || !unbound.empty() || current != unique_ids.size() ||
+        std::any_of(unique_ids.begin(), unique_ids.end(), [&](BackendId id) {
+            return generations_[slot(id)].load(std::memory_order_relaxed) != generation;
+        });
+
+    if (changed) {
+        ++generation;
+        for (auto id : unique_ids) {
+            generations_[slot(id)].store(generation, std::memory_order_relaxed);
+        }
+        generation_.store(generation, std::memory_order_release);
+        spdlog::info("BackendRegistry: Generation {} with {} backends ({} slots assigned)",
+                     generation, unique_ids.size(), size);
+    }
+
+    for (std::size_t i = 0; i < backends.size(); ++i) {
+        backends[i].id = ids[i];
+    }
+    return generation;
+}
+
+BackendId BackendRegistry::find(const std::string& host, std::uint16_t port) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(key(host, port));
+    return it != ids_.end() ? it->second : kNoBackendId;
+}
+
+bool BackendRegistry::is_current(BackendId id) const {
+    auto s = slot(id);
+    return s < size() && slot_ids_[s].load(std::memory_order_acquire) == id &&
+           generations_[s].load(std::memory_order_relaxed) == generation_.load(std::memory_order_acquire);
+}
+
+} // namespace ntonix::config
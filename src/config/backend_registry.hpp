@@ -0,0 +1,106 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Backend Registry - Dense integer ids for configured backends
+ *
+ * The pool, health checker, load balancer and metrics all keep per-backend
+ * state. Keying it by "host:port" strings meant building and hashing a
+ * string (under a mutex) several times per request. The registry instead
+ * stamps every configured backend with a small integer id when the
+ * configuration is loaded, and each subsystem indexes a flat array by it.
+ *
+ * A host:port keeps its id while it is configured, and after removal until
+ * its slot is needed again, so state survives reloads and a backend that
+ * comes back usually resumes where it left off. Each reload that changes
+ * the set of backends starts a new generation; is_current() tells whether
+ * an id belongs to it.
+ *
+ * Once every slot has been handed out, a new backend takes over the slot
+ * retired longest ago. The high bits of an id count its slot's reuses, so
+ * an id held across the reuse (by a request still using an older
+ * BackendConfig) no longer matches: subsystems index arrays by slot() and
+ * compare the full id before touching the state they find there.
+ */
+
+#ifndef NTONIX_CONFIG_BACKEND_REGISTRY_HPP
+#define NTONIX_CONFIG_BACKEND_REGISTRY_HPP
+
+#include "config/config.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ntonix::config {
+
+/**
+ * Backend Registry - process-wide, thread-safe
+ */
+class BackendRegistry {
+public:
+    /**
+     * Most backends configured at once (slots of removed backends are reused)
+     */
+    static constexpr std::size_t kMaxBackends = 1024;
+
+    /**
+     * Array index of an id (its low bits)
+     */
+    static constexpr std::size_t slot(BackendId id) { return id & (kMaxBackends - 1); }
+
+    static BackendRegistry& instance();
+
+    // Non-copyable
+    BackendRegistry(const BackendRegistry&) = delete;
+    BackendRegistry& operator=(const BackendRegistry&) = delete;
+
+    /**
+     * Stamp ids on a backend list that is about to be applied
+     * A new generation starts if the set of backends differs from the last call.
+     * @return The current generation
+     * @throws std::runtime_error if more than kMaxBackends backends are configured at once
+     */
+    std::uint64_t assign(std::vector<BackendConfig>& backends);
+
+    /**
+     * Id of a registered host:port, or kNoBackendId (builds a key; not for hot paths)
+     */
+    BackendId find(const std::string& host, std::uint16_t port) const;
+
+    /**
+     * Number of slots handed out so far
+     */
+    std::size_t size() const { return size_.load(std::memory_order_acquire); }
+
+    /**
+     * Generation of the backend set last passed to assign()
+     */
+    std::uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+    /**
+     * True if the backend is part of the current generation
+     */
+    bool is_current(BackendId id) const;
+
+private:
+    BackendRegistry() = default;
+
+    static std::string key(const std::string& host, std::uint16_t port);
+
+    static_assert((kMaxBackends & (kMaxBackends - 1)) == 0, "slot() masks the low bits");
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, BackendId> ids_;                        // Bound host:port -> id
+    std::array<std::string, kMaxBackends> keys_;                           // host:port bound to each slot
+    std::array<std::atomic<BackendId>, kMaxBackends> slot_ids_{};          // Id bound to each slot
+    std::array<std::atomic<std::uint64_t>, kMaxBackends> generations_{};   // Last generation each slot was in
+    std::atomic<std::size_t> size_{0};
+    std::atomic<std::uint64_t> generation_{0};
+};
+
+} // namespace ntonix::config
+
+#endif // NTONIX_CONFIG_BACKEND_REGISTRY_HPP
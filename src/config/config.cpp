@@ -4,11 +4,14 @@
  */
 
 #include "config/config.hpp"
+#include "config/backend_registry.hpp"
 
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <utility>
 
 #ifdef _WIN32
 #include <cstdlib>
@@ -53,7 +56,11 @@ void to_json(nlohmann::json& j, const CacheSettings& c) {
     j = nlohmann::json{
         {"enabled", c.enabled},
         {"max_size_mb", c.max_size_mb},
-        {"ttl_seconds", c.ttl_seconds}
+        {"ttl_seconds", c.ttl_seconds},
+        {"cache_streams", c.cache_streams},
+        {"stream_replay_interval_ms", c.stream_replay_interval_ms},
+        {"finish_streams_on_disconnect", c.finish_streams_on_disconnect},
+        {"finish_requests_on_disconnect", c.finish_requests_on_disconnect}
     };
 }
 
@@ -61,6 +68,160 @@ void from_json(const nlohmann::json& j, CacheSettings& c) {
     if (j.contains("enabled")) j.at("enabled").get_to(c.enabled);
     if (j.contains("max_size_mb")) j.at("max_size_mb").get_to(c.max_size_mb);
     if (j.contains("ttl_seconds")) j.at("ttl_seconds").get_to(c.ttl_seconds);
+    if (j.contains("cache_streams")) j.at("cache_streams").get_to(c.cache_streams);
+    if (j.contains("stream_replay_interval_ms")) j.at("stream_replay_interval_ms").get_to(c.stream_replay_interval_ms);
+    if (j.contains("finish_streams_on_disconnect")) j.at("finish_streams_on_disconnect").get_to(c.finish_streams_on_disconnect);
+    if (j.contains("finish_requests_on_disconnect")) j.at("finish_requests_on_disconnect").get_to(c.finish_requests_on_disconnect);
+}
+
+void to_json(nlohmann::json& j, const TimeoutSettings& t) {
+    j = nlohmann::json{
+        {"connect_ms", t.connect_ms},
+        {"send_ms", t.send_ms},
+        {"first_byte_ms", t.first_byte_ms},
+        {"request_ms", t.request_ms},
+        {"max_client_timeout_ms", t.max_client_timeout_ms},
+        {"cancel_on_half_close", t.cancel_on_half_close},
+        {"cancel_streams_on_half_close", t.cancel_streams_on_half_close},
+        {"routes", t.routes}
+    };
+}
+
+void from_json(const nlohmann::json& j, TimeoutSettings& t) {
+    if (j.contains("connect_ms")) j.at("connect_ms").get_to(t.connect_ms);
+    if (j.contains("send_ms")) j.at("send_ms").get_to(t.send_ms);
+    if (j.contains("first_byte_ms")) j.at("first_byte_ms").get_to(t.first_byte_ms);
+    if (j.contains("request_ms")) j.at("request_ms").get_to(t.request_ms);
+    if (j.contains("max_client_timeout_ms")) j.at("max_client_timeout_ms").get_to(t.max_client_timeout_ms);
+    if (j.contains("cancel_on_half_close")) j.at("cancel_on_half_close").get_to(t.cancel_on_half_close);
+    if (j.contains("cancel_streams_on_half_close")) {
+        j.at("cancel_streams_on_half_close").get_to(t.cancel_streams_on_half_close);
+    }
+    if (j.contains("routes")) j.at("routes").get_to(t.routes);
+}
+
+void to_json(nlohmann::json& j, const RetrySettings& r) {
+    j = nlohmann::json{
+        {"max_retries", r.max_retries},
+        {"budget_ratio", r.budget_ratio},
+        {"backoff_base_ms", r.backoff_base_ms},
+        {"backoff_max_ms", r.backoff_max_ms}
+    };
+}
+
+void from_json(const nlohmann::json& j, RetrySettings& r) {
+    if (j.contains("max_retries")) j.at("max_retries").get_to(r.max_retries);
+    if (j.contains("budget_ratio")) j.at("budget_ratio").get_to(r.budget_ratio);
+    if (j.contains("backoff_base_ms")) j.at("backoff_base_ms").get_to(r.backoff_base_ms);
+    if (j.contains("backoff_max_ms")) j.at("backoff_max_ms").get_to(r.backoff_max_ms);
+}
+
+void to_json(nlohmann::json& j, const DnsSettings& d) {
+    j = nlohmann::json{
+        {"ttl_ms", d.ttl_ms}
+    };
+}
+
+void from_json(const nlohmann::json& j, DnsSettings& d) {
+    if (j.contains("ttl_ms")) j.at("ttl_ms").get_to(d.ttl_ms);
+}
+
+void to_json(nlohmann::json& j, const PoolSettings& p) {
+    j = nlohmann::json{
+        {"size_per_backend", p.size_per_backend},
+        {"adaptive", p.adaptive},
+        {"min_size", p.min_size},
+        {"max_size", p.max_size},
+        {"min_idle", p.min_idle},
+        {"max_waiters", p.max_waiters},
+        {"max_wait_ms", p.max_wait_ms}
+    };
+}
+
+void from_json(const nlohmann::json& j, PoolSettings& p) {
+    if (j.contains("size_per_backend")) j.at("size_per_backend").get_to(p.size_per_backend);
+    if (j.contains("adaptive")) j.at("adaptive").get_to(p.adaptive);
+    if (j.contains("min_size")) j.at("min_size").get_to(p.min_size);
+    if (j.contains("max_size")) j.at("max_size").get_to(p.max_size);
+    if (j.contains("min_idle")) j.at("min_idle").get_to(p.min_idle);
+    if (j.contains("max_waiters")) j.at("max_waiters").get_to(p.max_waiters);
+    if (j.contains("max_wait_ms")) j.at("max_wait_ms").get_to(p.max_wait_ms);
+}
+
+void to_json(nlohmann::json& j, const QueueSettings& q) {
+    j = nlohmann::json{
+        {"enabled", q.enabled},
+        {"max_concurrent", q.max_concurrent},
+        {"max_depth", q.max_depth},
+        {"target_delay_ms", q.target_delay_ms},
+        {"interval_ms", q.interval_ms},
+        {"max_wait_ms", q.max_wait_ms}
+    };
+}
+
+void from_json(const nlohmann::json& j, QueueSettings& q) {
+    if (j.contains("enabled")) j.at("enabled").get_to(q.enabled);
+    if (j.contains("max_concurrent")) j.at("max_concurrent").get_to(q.max_concurrent);
+    if (j.contains("max_depth")) j.at("max_depth").get_to(q.max_depth);
+    if (j.contains("target_delay_ms")) j.at("target_delay_ms").get_to(q.target_delay_ms);
+    if (j.contains("interval_ms")) j.at("interval_ms").get_to(q.interval_ms);
+    if (j.contains("max_wait_ms")) j.at("max_wait_ms").get_to(q.max_wait_ms);
+}
+
+void to_json(nlohmann::json& j, const RateLimitSettings& r) {
+    j = nlohmann::json{
+        {"enabled", r.enabled},
+        {"key_tokens_per_minute", r.key_tokens_per_minute},
+        {"key_burst_tokens", r.key_burst_tokens},
+        {"ip_tokens_per_minute", r.ip_tokens_per_minute},
+        {"ip_burst_tokens", r.ip_burst_tokens},
+        {"default_max_tokens", r.default_max_tokens}
+    };
+}
+
+void from_json(const nlohmann::json& j, RateLimitSettings& r) {
+    if (j.contains("enabled")) j.at("enabled").get_to(r.enabled);
+    if (j.contains("key_tokens_per_minute")) j.at("key_tokens_per_minute").get_to(r.key_tokens_per_minute);
+    if (j.contains("key_burst_tokens")) j.at("key_burst_tokens").get_to(r.key_burst_tokens);
+    if (j.contains("ip_tokens_per_minute")) j.at("ip_tokens_per_minute").get_to(r.ip_tokens_per_minute);
+    if (j.contains("ip_burst_tokens")) j.at("ip_burst_tokens").get_to(r.ip_burst_tokens);
+    if (j.contains("default_max_tokens")) j.at("default_max_tokens").get_to(r.default_max_tokens);
+}
+
+void to_json(nlohmann::json& j, const BatchingSettings& b) {
+    j = nlohmann::json{
+        {"enabled", b.enabled},
+        {"max_batch_size", b.max_batch_size},
+        {"max_wait_ms", b.max_wait_ms}
+    };
+}
+
+void from_json(const nlohmann::json& j, BatchingSettings& b) {
+    if (j.contains("enabled")) j.at("enabled").get_to(b.enabled);
+    if (j.contains("max_batch_size")) j.at("max_batch_size").get_to(b.max_batch_size);
+    if (j.contains("max_wait_ms")) j.at("max_wait_ms").get_to(b.max_wait_ms);
+}
+
+void to_json(nlohmann::json& j, const StreamingSettings& s) {
+    j = nlohmann::json{
+        {"coalesce_window_ms", s.coalesce_window_ms},
+        {"coalesce_bytes", s.coalesce_bytes},
+        {"routes", s.routes},
+        {"client_buffer_bytes", s.client_buffer_bytes},
+        {"slow_client_policy", s.slow_client_policy},
+        {"slow_client_timeout_ms", s.slow_client_timeout_ms},
+        {"spill_budget_bytes", s.spill_budget_bytes}
+    };
+}
+
+void from_json(const nlohmann::json& j, StreamingSettings& s) {
+    if (j.contains("coalesce_window_ms")) j.at("coalesce_window_ms").get_to(s.coalesce_window_ms);
+    if (j.contains("coalesce_bytes")) j.at("coalesce_bytes").get_to(s.coalesce_bytes);
+    if (j.contains("routes")) j.at("routes").get_to(s.routes);
+    if (j.contains("client_buffer_bytes")) j.at("client_buffer_bytes").get_to(s.client_buffer_bytes);
+    if (j.contains("slow_client_policy")) j.at("slow_client_policy").get_to(s.slow_client_policy);
+    if (j.contains("slow_client_timeout_ms")) j.at("slow_client_timeout_ms").get_to(s.slow_client_timeout_ms);
+    if (j.contains("spill_budget_bytes")) j.at("spill_budget_bytes").get_to(s.spill_budget_bytes);
 }
 
 void to_json(nlohmann::json& j, const SslSettings& s) {
@@ -102,6 +263,14 @@ void to_json(nlohmann::json& j, const Config& c) {
         {"server", c.server},
         {"backends", c.backends},
         {"cache", c.cache},
+        {"timeouts", c.timeouts},
+        {"retry", c.retry},
+        {"dns", c.dns},
+        {"pool", c.pool},
+        {"queue", c.queue},
+        {"rate_limit", c.rate_limit},
+        {"batching", c.batching},
+        {"streaming", c.streaming},
         {"ssl", c.ssl},
         {"logging", c.logging}
     };
@@ -111,11 +280,39 @@ void from_json(const nlohmann::json& j, Config& c) {
     if (j.contains("server")) j.at("server").get_to(c.server);
     if (j.contains("backends")) j.at("backends").get_to(c.backends);
     if (j.contains("cache")) j.at("cache").get_to(c.cache);
+    if (j.contains("timeouts")) j.at("timeouts").get_to(c.timeouts);
+    if (j.contains("retry")) j.at("retry").get_to(c.retry);
+    if (j.contains("dns")) j.at("dns").get_to(c.dns);
+    if (j.contains("pool")) j.at("pool").get_to(c.pool);
+    if (j.contains("queue")) j.at("queue").get_to(c.queue);
+    if (j.contains("rate_limit")) j.at("rate_limit").get_to(c.rate_limit);
+    if (j.contains("batching")) j.at("batching").get_to(c.batching);
+    if (j.contains("streaming")) j.at("streaming").get_to(c.streaming);
     if (j.contains("ssl")) j.at("ssl").get_to(c.ssl);
     if (j.contains("logging")) j.at("logging").get_to(c.logging);
 }
 
 // Config validation
+std::size_t ServerSettings::io_threads() const {
+    return threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::uint32_t Config::queue_max_concurrent() const {
+    if (queue.max_concurrent > 0) {
+        return queue.max_concurrent;
+    }
+    return static_cast<std::uint32_t>(std::max<std::size_t>(1, server.io_threads() / 2));
+}
+
+std::uint32_t Config::queue_max_depth() const {
+    if (queue.max_depth > 0) {
+        return queue.max_depth;
+    }
+    auto threads = server.io_threads();
+    auto slots = queue_max_concurrent();
+    return static_cast<std::uint32_t>(threads > slots ? threads - slots : 0);
+}
+
 void Config::validate() const {
     // Validate server settings
     if (server.port == 0) {
@@ -150,6 +347,94 @@ void Config::validate() const {
         throw std::runtime_error("Configuration error: cache.max_size_mb must be non-zero when cache is enabled");
     }
 
+    // Validate timeouts
+    if (timeouts.connect_ms == 0 || timeouts.send_ms == 0 ||
+        timeouts.first_byte_ms == 0 || timeouts.request_ms == 0) {
+        throw std::runtime_error("Configuration error: timeouts must be non-zero");
+    }
+    for (const auto& [route, timeout_ms] : timeouts.routes) {
+        if (timeout_ms == 0) {
+            throw std::runtime_error("Configuration error: timeouts.routes[\"" + route + "\"] must be non-zero");
+        }
+    }
+
+    // Validate retries
+    if (!(retry.budget_ratio >= 0.0 && retry.budget_ratio <= 10.0)) {
+        throw std::runtime_error("Configuration error: retry.budget_ratio must be between 0 and 10");
+    }
+    if (retry.backoff_base_ms > retry.backoff_max_ms) {
+        throw std::runtime_error("Configuration error: retry.backoff_base_ms must not exceed retry.backoff_max_ms");
+    }
+
+    // Validate DNS cache
+    if (dns.ttl_ms == 0) {
+        throw std::runtime_error("Configuration error: dns.ttl_ms must be non-zero");
+    }
+
+    // Validate connection pools
+    if (pool.size_per_backend == 0) {
+        throw std::runtime_error("Configuration error: pool.size_per_backend must be non-zero");
+    }
+    if (!pool.adaptive && pool.min_idle > pool.size_per_backend) {
+        throw std::runtime_error("Configuration error: pool.min_idle cannot exceed pool.size_per_backend");
+    }
+    if (pool.adaptive) {
+        if (pool.min_size == 0 || pool.min_size > pool.max_size) {
+            throw std::runtime_error("Configuration error: pool.min_size must be non-zero and at most pool.max_size");
+        }
+        if (pool.min_idle > pool.min_size) {
+            throw std::runtime_error("Configuration error: pool.min_idle cannot exceed pool.min_size when pool.adaptive is set");
+        }
+    }
+    if (pool.max_waiters > 0 && pool.max_wait_ms == 0) {
+        throw std::runtime_error("Configuration error: pool.max_wait_ms must be non-zero when pool.max_waiters is set");
+    }
+
+    // Validate request queue: a request blocks an I/O thread while it waits
+    // for a slot and while it holds one (streams release theirs once relayed
+    // asynchronously), so slots plus queue depth cannot exceed the threads
+    if (queue.enabled) {
+        if (queue.interval_ms == 0) {
+            throw std::runtime_error("Configuration error: queue.interval_ms must be non-zero");
+        }
+        auto threads = server.io_threads();
+        if (threads < 2) {
+            throw std::runtime_error("Configuration error: queue.enabled needs at least 2 I/O threads, but server.threads "
+                                     "resolves to " + std::to_string(threads) + "; raise server.threads or disable the queue");
+        }
+        auto slots = queue_max_concurrent();
+        if (slots >= threads) {
+            throw std::runtime_error("Configuration error: queue.max_concurrent (" + std::to_string(slots) +
+                                     ") must be below server.threads (" + std::to_string(threads) +
+                                     "), otherwise no request can ever queue");
+        }
+        if (slots + queue_max_depth() > threads) {
+            throw std::runtime_error("Configuration error: queue.max_concurrent + queue.max_depth cannot exceed server.threads (" +
+                                     std::to_string(threads) + ")");
+        }
+    }
+
+    // Validate rate limits
+    if (rate_limit.enabled &&
+        (rate_limit.key_tokens_per_minute == 0 || rate_limit.key_burst_tokens == 0 ||
+         rate_limit.ip_tokens_per_minute == 0 || rate_limit.ip_burst_tokens == 0)) {
+        throw std::runtime_error("Configuration error: rate_limit rates and burst sizes must be non-zero");
+    }
+
+    // Validate micro-batching
+    if (batching.enabled && batching.max_batch_size < 2) {
+        throw std::runtime_error("Configuration error: batching.max_batch_size must be at least 2");
+    }
+
+    // Validate stream coalescing and slow-client buffering
+    if (streaming.coalesce_bytes == 0 || streaming.client_buffer_bytes == 0) {
+        throw std::runtime_error("Configuration error: streaming.coalesce_bytes and streaming.client_buffer_bytes must be non-zero");
+    }
+    if (streaming.slow_client_policy != "block" && streaming.slow_client_policy != "drop" &&
+        streaming.slow_client_policy != "spill") {
+        throw std::runtime_error("Configuration error: streaming.slow_client_policy must be block, drop or spill");
+    }
+
     // Validate SSL settings
     if (ssl.enabled) {
         if (ssl.cert_file.empty()) {
@@ -204,6 +489,7 @@ bool ConfigManager::load(int argc, char* argv[]) {
 
     // Validate final configuration
     config_.validate();
+    BackendRegistry::instance().assign(config_.backends);
 
     spdlog::info("Configuration loaded successfully");
     return true;
@@ -224,10 +510,12 @@ void ConfigManager::reload() {
 
     spdlog::info("Reloading configuration from {}", config_path_.string());
 
-    try {
-        // Store current backends for comparison
-        auto old_backends = config_.backends;
+    // The loaders write config_: keep the running configuration to compare
+    // against and to fall back to, and only commit the new one once it has
+    // been validated and stamped with backend ids
+    Config previous = config_;
 
+    try {
         // Reload from file
         load_from_file(config_path_);
 
@@ -240,23 +528,28 @@ void ConfigManager::reload() {
         if (cli_threads_) config_.server.threads = *cli_threads_;
         if (cli_bind_address_) config_.server.bind_address = *cli_bind_address_;
 
-        // Validate
-        config_.validate();
-
-        // Notify callbacks if backends changed
-        if (config_.backends != old_backends) {
-            spdlog::info("Backend configuration changed, notifying {} listeners",
-                        reload_callbacks_.size());
-            for (const auto& callback : reload_callbacks_) {
-                callback(config_.backends);
-            }
-        } else {
-            spdlog::info("Configuration reloaded, no backend changes");
-        }
+        // Validate and assign ids on a copy
+        Config next = std::exchange(config_, previous);
+        next.validate();
+        BackendRegistry::instance().assign(next.backends);
+        config_ = std::move(next);
 
     } catch (const std::exception& e) {
         spdlog::error("Configuration reload failed: {}", e.what());
         // Keep existing configuration on error
+        config_ = std::move(previous);
+        return;
+    }
+
+    // Notify callbacks if backends changed
+    if (config_.backends != previous.backends) {
+        spdlog::info("Backend configuration changed, notifying {} listeners",
+                    reload_callbacks_.size());
+        for (const auto& callback : reload_callbacks_) {
+            callback(config_.backends);
+        }
+    } else {
+        spdlog::info("Configuration reloaded, no backend changes");
     }
 }
 
@@ -294,6 +587,12 @@ void ConfigManager::print_help(const char* program_name) {
               << "  NTONIX_CACHE_ENABLED    Enable/disable cache (true/false)\n"
               << "  NTONIX_CACHE_SIZE_MB    Cache size in MB\n"
               << "  NTONIX_CACHE_TTL        Cache TTL in seconds\n"
+              << "  NTONIX_CANCEL_ON_HALF_CLOSE  Cancel requests of clients that half-close (true/false)\n"
+              << "  NTONIX_CANCEL_STREAMS_ON_HALF_CLOSE  Same for streaming requests (true/false)\n"
+              << "  NTONIX_MAX_RETRIES      Other backends tried after a connection failure\n"
+              << "  NTONIX_RETRY_BUDGET_RATIO  Retries allowed per request (e.g. 0.2)\n"
+              << "  NTONIX_RETRY_BACKOFF_BASE_MS  Backoff before the first retry\n"
+              << "  NTONIX_RETRY_BACKOFF_MAX_MS   Longest backoff before a retry\n"
               << "  NTONIX_LOG_LEVEL        Log level (trace/debug/info/warn/error/critical/off)\n"
               << "  NTONIX_LOG_FILE         Log file path (stdout if not set)\n"
               << "\n"
@@ -318,6 +617,51 @@ void ConfigManager::print_help(const char* program_name) {
               << "      \"max_size_mb\": 512,\n"
               << "      \"ttl_seconds\": 3600\n"
               << "    },\n"
+              << "    \"timeouts\": {\n"
+              << "      \"connect_ms\": 5000,\n"
+              << "      \"request_ms\": 60000,\n"
+              << "      \"routes\": {\"/v1/chat/completions\": 120000}\n"
+              << "    },\n"
+              << "    \"retry\": {\n"
+              << "      \"max_retries\": 2,\n"
+              << "      \"budget_ratio\": 0.2,\n"
+              << "      \"backoff_base_ms\": 25,\n"
+              << "      \"backoff_max_ms\": 250\n"
+              << "    },\n"
+              << "    \"dns\": {\n"
+              << "      \"ttl_ms\": 30000\n"
+              << "    },\n"
+              << "    \"pool\": {\n"
+              << "      \"size_per_backend\": 10,\n"
+              << "      \"adaptive\": false,\n"
+              << "      \"min_size\": 2,\n"
+              << "      \"max_size\": 64,\n"
+              << "      \"min_idle\": 0,\n"
+              << "      \"max_waiters\": 64,\n"
+              << "      \"max_wait_ms\": 1000\n"
+              << "    },\n"
+              << "    \"queue\": {\n"
+              << "      \"enabled\": false,\n"
+              << "      \"max_concurrent\": 0,\n"
+              << "      \"target_delay_ms\": 100\n"
+              << "    },\n"
+              << "    \"rate_limit\": {\n"
+              << "      \"enabled\": false,\n"
+              << "      \"key_tokens_per_minute\": 100000,\n"
+              << "      \"ip_tokens_per_minute\": 200000\n"
+              << "    },\n"
+              << "    \"batching\": {\n"
+              << "      \"enabled\": false,\n"
+              << "      \"max_batch_size\": 16,\n"
+              << "      \"max_wait_ms\": 5\n"
+              << "    },\n"
+              << "    \"streaming\": {\n"
+              << "      \"coalesce_window_ms\": 0,\n"
+              << "      \"coalesce_bytes\": 4096,\n"
+              << "      \"routes\": {\"/v1/completions\": 5},\n"
+              << "      \"client_buffer_bytes\": 65536,\n"
+              << "      \"slow_client_policy\": \"block\"\n"
+              << "    },\n"
               << "    \"ssl\": {\n"
               << "      \"enabled\": false,\n"
               << "      \"cert_file\": \"server.crt\",\n"
@@ -455,6 +799,53 @@ void ConfigManager::apply_environment_overrides() {
         }
     }
 
+    // Timeout settings
+    if (auto env = get_env("NTONIX_CANCEL_ON_HALF_CLOSE")) {
+        config_.timeouts.cancel_on_half_close = (*env == "true" || *env == "1" || *env == "yes");
+        spdlog::debug("Applied NTONIX_CANCEL_ON_HALF_CLOSE={}", config_.timeouts.cancel_on_half_close);
+    }
+    if (auto env = get_env("NTONIX_CANCEL_STREAMS_ON_HALF_CLOSE")) {
+        config_.timeouts.cancel_streams_on_half_close = (*env == "true" || *env == "1" || *env == "yes");
+        spdlog::debug("Applied NTONIX_CANCEL_STREAMS_ON_HALF_CLOSE={}", config_.timeouts.cancel_streams_on_half_close);
+    }
+
+    // Retry settings
+    if (auto env = get_env("NTONIX_MAX_RETRIES")) {
+        try {
+            config_.retry.max_retries = static_cast<std::uint32_t>(std::stoul(*env));
+            spdlog::debug("Applied NTONIX_MAX_RETRIES={}", config_.retry.max_retries);
+        } catch (...) {
+            throw std::runtime_error("Invalid NTONIX_MAX_RETRIES value: " + *env);
+        }
+    }
+
+    if (auto env = get_env("NTONIX_RETRY_BUDGET_RATIO")) {
+        try {
+            config_.retry.budget_ratio = std::stod(*env);
+            spdlog::debug("Applied NTONIX_RETRY_BUDGET_RATIO={}", config_.retry.budget_ratio);
+        } catch (...) {
+            throw std::runtime_error("Invalid NTONIX_RETRY_BUDGET_RATIO value: " + *env);
+        }
+    }
+
+    if (auto env = get_env("NTONIX_RETRY_BACKOFF_BASE_MS")) {
+        try {
+            config_.retry.backoff_base_ms = static_cast<std::uint32_t>(std::stoul(*env));
+            spdlog::debug("Applied NTONIX_RETRY_BACKOFF_BASE_MS={}", config_.retry.backoff_base_ms);
+        } catch (...) {
+            throw std::runtime_error("Invalid NTONIX_RETRY_BACKOFF_BASE_MS value: " + *env);
+        }
+    }
+
+    if (auto env = get_env("NTONIX_RETRY_BACKOFF_MAX_MS")) {
+        try {
+            config_.retry.backoff_max_ms = static_cast<std::uint32_t>(std::stoul(*env));
+            spdlog::debug("Applied NTONIX_RETRY_BACKOFF_MAX_MS={}", config_.retry.backoff_max_ms);
+        } catch (...) {
+            throw std::runtime_error("Invalid NTONIX_RETRY_BACKOFF_MAX_MS value: " + *env);
+        }
+    }
+
     // Logging settings
     if (auto env = get_env("NTONIX_LOG_LEVEL")) {
         config_.logging.level = *env;
@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <map>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -26,6 +27,12 @@
 
 namespace ntonix::config {
 
+/**
+ * Dense backend id, see BackendRegistry
+ */
+using BackendId = std::uint32_t;
+inline constexpr BackendId kNoBackendId = UINT32_MAX;
+
 /**
  * Backend server configuration
  */
@@ -33,6 +40,7 @@ struct BackendConfig {
     std::string host{"localhost"};
     std::uint16_t port{8001};
     std::uint32_t weight{1};
+    BackendId id{kNoBackendId};     // Assigned by BackendRegistry, stable while host:port is configured
 
     bool operator==(const BackendConfig&) const = default;
 };
@@ -45,6 +53,11 @@ struct ServerSettings {
     std::uint16_t ssl_port{8443};
     std::size_t threads{0};  // 0 = hardware_concurrency
     std::string bind_address{"0.0.0.0"};
+
+    /**
+     * I/O threads the server will run (threads, or hardware_concurrency if 0)
+     */
+    std::size_t io_threads() const;
 };
 
 /**
@@ -54,6 +67,105 @@ struct CacheSettings {
     bool enabled{true};
     std::size_t max_size_mb{512};
     std::uint32_t ttl_seconds{3600};
+    bool cache_streams{true};                      // Cache completed SSE streams
+    std::uint32_t stream_replay_interval_ms{0};    // Pause between replayed events (0 = no pacing)
+    bool finish_streams_on_disconnect{false};      // Keep reading a stream for the cache after client leaves
+    bool finish_requests_on_disconnect{false};     // Complete a non-streaming request for the cache after client leaves
+};
+
+/**
+ * Backend request deadlines
+ */
+struct TimeoutSettings {
+    std::uint32_t connect_ms{5000};                // Establishing a backend connection
+    std::uint32_t send_ms{10000};                  // Writing the request to the backend
+    std::uint32_t first_byte_ms{60000};            // Waiting for the response header
+    std::uint32_t request_ms{60000};               // Whole backend exchange (non-streaming)
+    std::uint32_t max_client_timeout_ms{600000};   // Cap on X-Request-Timeout (0 = header ignored)
+    bool cancel_on_half_close{false};              // Cancel when the client only shuts down its sending side
+    bool cancel_streams_on_half_close{true};       // Same for streaming requests
+    std::map<std::string, std::uint32_t> routes;   // Per-path request_ms overrides
+};
+
+/**
+ * Retrying connection-level failures on other backends
+ */
+struct RetrySettings {
+    std::uint32_t max_retries{2};                  // Other backends tried after a failure (0 = no retry)
+    double budget_ratio{0.2};                      // Retries allowed per request (0.2 = 20% extra load)
+    std::uint32_t backoff_base_ms{25};             // Backoff before the first retry (jittered, doubling)
+    std::uint32_t backoff_max_ms{250};             // Longest backoff before a retry
+};
+
+/**
+ * Resolution of backend host names
+ */
+struct DnsSettings {
+    std::uint32_t ttl_ms{30000};                   // Answer lifetime before a background refresh
+};
+
+/**
+ * Backend connection pools
+ */
+struct PoolSettings {
+    std::uint32_t size_per_backend{10};            // Most connections open to one backend (initial size if adaptive)
+    bool adaptive{false};                          // Size each backend's pool from its observed concurrency
+    std::uint32_t min_size{2};                     // Adaptive size bounds per backend
+    std::uint32_t max_size{64};
+    std::uint32_t min_idle{0};                     // Idle connections kept open (and pre-connected) per backend
+    std::uint32_t max_waiters{64};                 // Requests queued per backend while its pool is exhausted
+    std::uint32_t max_wait_ms{1000};               // Longest a queued request waits for a connection
+};
+
+/**
+ * Request queue in front of backend selection
+ *
+ * A request holds an I/O thread while it is queued and until the backend
+ * answers, so slots and queue depth both come out of server.threads. A
+ * streamed response gives its slot back once the asynchronous relay takes
+ * over, so streams in progress count against neither.
+ */
+struct QueueSettings {
+    bool enabled{false};
+    std::uint32_t max_concurrent{0};               // Backend requests in flight before queueing (0 = half the threads)
+    std::uint32_t max_depth{0};                    // Queued requests before rejecting with 503 (0 = remaining threads)
+    std::uint32_t target_delay_ms{100};            // CoDel: acceptable standing queue delay
+    std::uint32_t interval_ms{1000};               // CoDel: window the delay must exceed target before shedding
+    std::uint32_t max_wait_ms{30000};              // Longest any request waits for a slot
+};
+
+/**
+ * Token-aware rate limits (LLM tokens, not requests)
+ */
+struct RateLimitSettings {
+    bool enabled{false};
+    std::uint32_t key_tokens_per_minute{100000};   // Refill rate per API key
+    std::uint32_t key_burst_tokens{100000};        // Bucket size per API key
+    std::uint32_t ip_tokens_per_minute{200000};    // Refill rate per client IP
+    std::uint32_t ip_burst_tokens{200000};         // Bucket size per client IP
+    std::uint32_t default_max_tokens{256};         // Completion estimate when max_tokens is absent
+};
+
+/**
+ * Micro-batching of non-streaming /v1/completions requests
+ */
+struct BatchingSettings {
+    bool enabled{false};
+    std::uint32_t max_batch_size{16};              // Prompts per backend request
+    std::uint32_t max_wait_ms{5};                  // Longest the first request waits for others
+};
+
+/**
+ * Client side of relayed SSE streams: write coalescing and slow-client buffering
+ */
+struct StreamingSettings {
+    std::uint32_t coalesce_window_ms{0};           // Longest a chunk is held for more to join it (0 = write each chunk)
+    std::uint32_t coalesce_bytes{4096};            // Write as soon as this many bytes are held
+    std::map<std::string, std::uint32_t> routes;   // Per-path coalesce_window_ms overrides
+    std::uint32_t client_buffer_bytes{65536};      // Stream bytes held for a client that reads slowly
+    std::string slow_client_policy{"block"};       // block, drop, spill (once client_buffer_bytes are held)
+    std::uint32_t slow_client_timeout_ms{2000};    // Stall after which the drop policy disconnects the client
+    std::uint64_t spill_budget_bytes{67108864};    // Memory all spilling streams may hold beyond client_buffer_bytes
 };
 
 /**
@@ -84,9 +196,27 @@ struct Config {
     ServerSettings server;
     std::vector<BackendConfig> backends;
     CacheSettings cache;
+    TimeoutSettings timeouts;
+    RetrySettings retry;
+    DnsSettings dns;
+    PoolSettings pool;
+    QueueSettings queue;
+    RateLimitSettings rate_limit;
+    BatchingSettings batching;
+    StreamingSettings streaming;
     SslSettings ssl;
     LogSettings logging;
 
+    /**
+     * Queue slots in effect (queue.max_concurrent, or derived from the threads)
+     */
+    std::uint32_t queue_max_concurrent() const;
+
+    /**
+     * Queue depth in effect (queue.max_depth, or the threads left after the slots)
+     */
+    std::uint32_t queue_max_depth() const;
+
     /**
      * Validate configuration and throw if invalid
      */
@@ -186,6 +316,22 @@ void to_json(nlohmann::json& j, const ServerSettings& s);
 void from_json(const nlohmann::json& j, ServerSettings& s);
 void to_json(nlohmann::json& j, const CacheSettings& c);
 void from_json(const nlohmann::json& j, CacheSettings& c);
+void to_json(nlohmann::json& j, const TimeoutSettings& t);
+void from_json(const nlohmann::json& j, TimeoutSettings& t);
+void to_json(nlohmann::json& j, const RetrySettings& r);
+void from_json(const nlohmann::json& j, RetrySettings& r);
+void to_json(nlohmann::json& j, const DnsSettings& d);
+void from_json(const nlohmann::json& j, DnsSettings& d);
+void to_json(nlohmann::json& j, const PoolSettings& p);
+void from_json(const nlohmann::json& j, PoolSettings& p);
+void to_json(nlohmann::json& j, const QueueSettings& q);
+void from_json(const nlohmann::json& j, QueueSettings& q);
+void to_json(nlohmann::json& j, const RateLimitSettings& r);
+void from_json(const nlohmann::json& j, RateLimitSettings& r);
+void to_json(nlohmann::json& j, const BatchingSettings& b);
+void from_json(const nlohmann::json& j, BatchingSettings& b);
+void to_json(nlohmann::json& j, const StreamingSettings& s);
+void from_json(const nlohmann::json& j, StreamingSettings& s);
 void to_json(nlohmann::json& j, const SslSettings& s);
 void from_json(const nlohmann::json& j, SslSettings& s);
 void to_json(nlohmann::json& j, const LogSettings& l);
@@ -9,12 +9,21 @@
 #include "server/connection.hpp"
 #include "server/ssl_server.hpp"
 #include "server/ssl_connection.hpp"
+#include "balancer/fair_queue.hpp"
 #include "balancer/health_checker.hpp"
 #include "balancer/load_balancer.hpp"
 #include "proxy/connection_pool.hpp"
+#include "proxy/embedding_cache.hpp"
 #include "proxy/forwarder.hpp"
+#include "proxy/micro_batcher.hpp"
+#include "proxy/rate_limiter.hpp"
+#include "proxy/stream_cache.hpp"
+#include "proxy/tenant.hpp"
 #include "cache/lru_cache.hpp"
 #include "cache/cache_key.hpp"
+#include "cache/completion_codec.hpp"
+#include "cache/single_flight.hpp"
+#include "util/dns_cache.hpp"
 #include "util/logger.hpp"
 #include "util/metrics.hpp"
 
@@ -22,9 +31,11 @@
 #include <boost/beast/ssl.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
 
 namespace asio = boost::asio;
@@ -48,6 +59,103 @@ ntonix::util::LogConfig make_log_config(const ntonix::config::LogSettings& setti
     return log_config;
 }
 
+// Observer giving a streaming request's queue slot back once the backend's
+// headers arrive: the relay then runs asynchronously and holds no I/O thread,
+// and the queue's slots are sized from the threads
+class QueueSlotReleaser : public ntonix::proxy::StreamObserver {
+public:
+    explicit QueueSlotReleaser(std::shared_ptr<ntonix::balancer::FairQueue::Slot> slot)
+        : slot_(std::move(slot)) {}
+
+    void on_stream_start(const boost::beast::http::response_header<>& /*header*/) override {
+        slot_->release();
+    }
+
+private:
+    std::shared_ptr<ntonix::balancer::FairQueue::Slot> slot_;
+};
+
+// Helper to write a complete response from a streaming handler
+void write_response(boost::beast::tcp_stream& stream, const ntonix::server::HttpResponse& resp) {
+    namespace http = boost::beast::http;
+    http::response<http::string_body> response{resp.status, 11};
+    response.set(http::field::server, "NTONIX/0.1.0");
+    response.set(http::field::content_type, resp.content_type);
+    for (const auto& [name, value] : resp.headers) {
+        response.set(name, value);
+    }
+    response.body() = resp.body;
+    response.prepare_payload();
+    boost::beast::error_code ec;
+    http::write(stream, response, ec);
+}
+
+// Helper to charge a request against the token rate limits
+// Returns the 429 response to send if the request is over its limit
+std::optional<ntonix::server::HttpResponse> charge_rate_limit(ntonix::proxy::RateLimiter& limiter,
+                                                              const ntonix::server::HttpRequest& req,
+                                                              const ntonix::proxy::TokenEstimate& estimate,
+                                                              ntonix::proxy::RateCharge& charge) {
+    auto decision = limiter.try_acquire(req.authorization, req.client_ip, estimate.total());
+    if (decision.allowed) {
+        charge = std::move(decision.charge);
+        return std::nullopt;
+    }
+
+    NTONIX_LOG_WARN("ratelimit", "Rate limit exceeded for client {} ({} estimated tokens), retry after {}s",
+                req.client_ip, estimate.total(), decision.retry_after.count());
+    ntonix::util::Metrics::instance().request_rate_limited();
+    return ntonix::server::HttpResponse{
+        .status = boost::beast::http::status::too_many_requests,
+        .content_type = "application/json",
+        .body = R"({"error": "Rate limit exceeded"})",
+        .headers = {{"Retry-After", std::to_string(decision.retry_after.count())}}
+    };
+}
+
+// Helper to wait for a backend slot in the request queue
+// Returns the error response to send if the request was not admitted
+std::optional<ntonix::server::HttpResponse> admit_request(ntonix::balancer::FairQueue& queue,
+                                                          const ntonix::proxy::Forwarder& forwarder,
+                                                          const ntonix::server::HttpRequest& req,
+                                                          ntonix::balancer::FairQueue::Slot& slot) {
+    using ntonix::balancer::AdmitStatus;
+    using ntonix::balancer::FairQueue;
+    namespace http = boost::beast::http;
+
+    std::string_view priority;
+    if (auto it = req.raw_request.find("X-Priority"); it != req.raw_request.end()) {
+        priority = std::string_view(it->value().data(), it->value().size());
+    }
+
+    auto admission = queue.admit(ntonix::proxy::tenant_id(req.authorization, req.client_ip),
+                                 FairQueue::parse_priority(priority),
+                                 forwarder.make_deadline(req).total());
+    if (admission.status == AdmitStatus::admitted) {
+        slot = std::move(admission.slot);
+        return std::nullopt;
+    }
+
+    NTONIX_LOG_WARN("queue", "Request not admitted ({}) after {}ms in queue",
+                admission.status == AdmitStatus::rejected ? "queue full" :
+                admission.status == AdmitStatus::dropped ? "shed" : "deadline expired",
+                admission.waited.count());
+
+    if (admission.status == AdmitStatus::expired) {
+        return ntonix::server::HttpResponse{
+            .status = http::status::gateway_timeout,
+            .content_type = "application/json",
+            .body = R"({"error": "Request deadline expired while queued"})"
+        };
+    }
+    return ntonix::server::HttpResponse{
+        .status = http::status::service_unavailable,
+        .content_type = "application/json",
+        .body = R"({"error": "Gateway overloaded, retry later"})",
+        .headers = {{"Retry-After", "1"}}
+    };
+}
+
 int main(int argc, char* argv[]) {
     // Initialize with default logging until config is loaded
     ntonix::util::Logger::init_default();
@@ -73,9 +181,7 @@ int main(int argc, char* argv[]) {
         // Configure server from loaded config
         ntonix::server::ServerConfig server_config;
         server_config.port = config.server.port;
-        server_config.thread_count = config.server.threads > 0
-            ? config.server.threads
-            : std::max(1u, std::thread::hardware_concurrency());
+        server_config.thread_count = config.server.io_threads();
         server_config.bind_address = config.server.bind_address;
 
         NTONIX_LOG_INFO("config", "Configuration: port={}, threads={}, bind={}",
@@ -110,6 +216,15 @@ int main(int argc, char* argv[]) {
         // Create and start server
         ntonix::server::Server server(server_config);
 
+        // Backend name resolution, shared by health checks and the connection pool
+        auto dns_cache = std::make_shared<ntonix::util::DnsCache>(
+            server.get_io_context(), std::chrono::milliseconds(config.dns.ttl_ms));
+
+        // Initialize metrics system (before the pools, which report their sizes from the start)
+        auto& metrics = ntonix::util::Metrics::instance();
+        metrics.init(config.backends);
+        NTONIX_LOG_INFO("metrics", "Metrics system initialized");
+
         // Create health checker for backend monitoring
         ntonix::balancer::HealthCheckConfig health_config;
         health_config.interval = std::chrono::milliseconds(5000);  // Check every 5 seconds
@@ -118,7 +233,7 @@ int main(int argc, char* argv[]) {
         health_config.healthy_threshold = 2;                        // Mark healthy after 2 successes
 
         auto health_checker = std::make_shared<ntonix::balancer::HealthChecker>(
-            server.get_io_context(), health_config);
+            server.get_io_context(), health_config, dns_cache);
 
         // Set initial backends
         health_checker->set_backends(config.backends);
@@ -141,28 +256,80 @@ int main(int argc, char* argv[]) {
 
         // Create connection pool manager for backend connections
         ntonix::proxy::ConnectionPoolConfig pool_config;
-        pool_config.pool_size_per_backend = 10;    // Max 10 connections per backend
+        pool_config.pool_size_per_backend = config.pool.size_per_backend;
+        pool_config.adaptive_size = config.pool.adaptive;
+        pool_config.min_size = config.pool.min_size;
+        pool_config.max_size = config.pool.max_size;
+        pool_config.min_idle = config.pool.min_idle;
+        pool_config.max_waiters = config.pool.max_waiters;
+        pool_config.max_wait = std::chrono::milliseconds(config.pool.max_wait_ms);
         pool_config.idle_timeout = std::chrono::seconds(60);
         pool_config.cleanup_interval = std::chrono::seconds(30);
+        pool_config.connection_timeout = std::chrono::milliseconds(config.timeouts.connect_ms);
         pool_config.enable_keep_alive = true;
 
         auto connection_pool = std::make_shared<ntonix::proxy::ConnectionPoolManager>(
-            server.get_io_context(), pool_config);
+            server.get_io_context(), pool_config, dns_cache);
         connection_pool->set_backends(config.backends);
-        NTONIX_LOG_INFO("pool", "Connection pool manager configured (pool_size={} per backend)",
-                    pool_config.pool_size_per_backend);
+        NTONIX_LOG_INFO("pool", "Connection pool manager configured (pool_size={}{}, min_idle={}, max_waiters={} per backend)",
+                    pool_config.pool_size_per_backend,
+                    pool_config.adaptive_size
+                        ? fmt::format(", adaptive {}-{}", pool_config.min_size, pool_config.max_size) : "",
+                    pool_config.min_idle, pool_config.max_waiters);
+
+        // A recovered backend gets its idle connections back before traffic returns
+        health_checker->on_state_change([weak_pool = std::weak_ptr(connection_pool)](
+            const ntonix::config::BackendConfig& backend,
+            ntonix::balancer::BackendState /*old_state*/,
+            ntonix::balancer::BackendState new_state) {
+            auto pool = weak_pool.lock();
+            if (pool && new_state == ntonix::balancer::BackendState::healthy) {
+                pool->prewarm(backend);
+            }
+        });
 
         // Create request forwarder for proxying to backends
         ntonix::proxy::ForwarderConfig forwarder_config;
-        forwarder_config.request_timeout = std::chrono::seconds(60);  // LLM requests can be slow
-        forwarder_config.connect_timeout = std::chrono::seconds(5);
+        forwarder_config.request_timeout = std::chrono::milliseconds(config.timeouts.request_ms);
+        forwarder_config.connect_timeout = std::chrono::milliseconds(config.timeouts.connect_ms);
+        forwarder_config.send_timeout = std::chrono::milliseconds(config.timeouts.send_ms);
+        forwarder_config.first_byte_timeout = std::chrono::milliseconds(config.timeouts.first_byte_ms);
+        forwarder_config.max_client_timeout = std::chrono::milliseconds(config.timeouts.max_client_timeout_ms);
+        forwarder_config.cancel_on_half_close = config.timeouts.cancel_on_half_close;
+        forwarder_config.cancel_streams_on_half_close = config.timeouts.cancel_streams_on_half_close;
+        for (const auto& [route, timeout_ms] : config.timeouts.routes) {
+            forwarder_config.route_timeouts[route] = std::chrono::milliseconds(timeout_ms);
+        }
         forwarder_config.add_forwarded_headers = true;
         forwarder_config.generate_request_id = true;
+        forwarder_config.max_retries = config.retry.max_retries;
+        forwarder_config.retry_budget.retry_ratio = config.retry.budget_ratio;
+        forwarder_config.retry_backoff_base = std::chrono::milliseconds(config.retry.backoff_base_ms);
+        forwarder_config.retry_backoff_max = std::chrono::milliseconds(config.retry.backoff_max_ms);
+        forwarder_config.stream_config.replay_event_interval =
+            std::chrono::milliseconds(config.cache.stream_replay_interval_ms);
+        forwarder_config.stream_config.coalesce_window =
+            std::chrono::milliseconds(config.streaming.coalesce_window_ms);
+        forwarder_config.stream_config.coalesce_bytes = config.streaming.coalesce_bytes;
+        for (const auto& [route, window_ms] : config.streaming.routes) {
+            forwarder_config.route_coalesce_windows[route] = std::chrono::milliseconds(window_ms);
+        }
+        forwarder_config.stream_config.client_buffer_bytes = config.streaming.client_buffer_bytes;
+        forwarder_config.stream_config.slow_client_timeout =
+            std::chrono::milliseconds(config.streaming.slow_client_timeout_ms);
+        if (config.streaming.slow_client_policy == "drop") {
+            forwarder_config.stream_config.slow_client_policy = ntonix::proxy::SlowClientPolicy::drop;
+        } else if (config.streaming.slow_client_policy == "spill") {
+            forwarder_config.stream_config.slow_client_policy = ntonix::proxy::SlowClientPolicy::spill;
+            forwarder_config.stream_config.spill_budget =
+                std::make_shared<ntonix::proxy::SpillBudget>(config.streaming.spill_budget_bytes);
+        }
 
         auto forwarder = std::make_shared<ntonix::proxy::Forwarder>(
             server.get_io_context(), connection_pool, forwarder_config);
-        NTONIX_LOG_INFO("proxy", "Request forwarder configured (timeout={}s)",
-                    forwarder_config.request_timeout.count());
+        forwarder->set_load_balancer(load_balancer);
+        NTONIX_LOG_INFO("proxy", "Request forwarder configured (timeout={}ms, max_retries={})",
+                    forwarder_config.request_timeout.count(), forwarder_config.max_retries);
 
         // Create LRU cache for response caching
         ntonix::cache::LruCacheConfig cache_config;
@@ -171,6 +338,9 @@ int main(int argc, char* argv[]) {
         cache_config.enabled = config.cache.enabled;
 
         auto response_cache = std::make_shared<ntonix::cache::LruCache>(cache_config);
+
+        // In-flight table used to coalesce identical concurrent cache misses
+        auto inflight_requests = std::make_shared<ntonix::cache::SingleFlight>();
         if (config.cache.enabled) {
             NTONIX_LOG_INFO("cache", "Response cache configured: max_size={}MB, ttl={}s",
                         config.cache.max_size_mb, config.cache.ttl_seconds);
@@ -178,10 +348,84 @@ int main(int argc, char* argv[]) {
             NTONIX_LOG_INFO("cache", "Response cache: disabled");
         }
 
-        // Initialize metrics system
-        auto& metrics = ntonix::util::Metrics::instance();
-        metrics.init(config.backends);
-        NTONIX_LOG_INFO("metrics", "Metrics system initialized");
+        // Per-input embedding cache, sharing the response cache's memory budget
+        auto embedding_cache = std::make_shared<ntonix::proxy::EmbeddingCache>(response_cache);
+
+        // Registry of in-flight streams that identical streaming requests can join
+        ntonix::proxy::StreamBroadcastConfig broadcast_config;
+        broadcast_config.max_buffer_bytes = 1024 * 1024;    // 1 MB replay buffer per shared stream
+        auto stream_broadcasts = std::make_shared<ntonix::proxy::StreamBroadcastRegistry>(broadcast_config);
+
+        // Fair queue in front of backend selection (null when disabled)
+        std::shared_ptr<ntonix::balancer::FairQueue> request_queue;
+        if (config.queue.enabled) {
+            ntonix::balancer::FairQueueConfig queue_config;
+            queue_config.max_concurrent = config.queue_max_concurrent();
+            queue_config.max_depth = config.queue_max_depth();
+            queue_config.target_delay = std::chrono::milliseconds(config.queue.target_delay_ms);
+            queue_config.interval = std::chrono::milliseconds(config.queue.interval_ms);
+            queue_config.max_wait = std::chrono::milliseconds(config.queue.max_wait_ms);
+            request_queue = std::make_shared<ntonix::balancer::FairQueue>(queue_config);
+            NTONIX_LOG_INFO("queue", "Request queue configured: max_concurrent={}, max_depth={}, target_delay={}ms",
+                        queue_config.max_concurrent, queue_config.max_depth, queue_config.target_delay.count());
+        }
+
+        // Token-aware rate limiter (null when disabled)
+        std::shared_ptr<ntonix::proxy::RateLimiter> rate_limiter;
+        if (config.rate_limit.enabled) {
+            ntonix::proxy::RateLimiterConfig limiter_config;
+            limiter_config.per_key.tokens_per_second = config.rate_limit.key_tokens_per_minute / 60.0;
+            limiter_config.per_key.burst_tokens = config.rate_limit.key_burst_tokens;
+            limiter_config.per_ip.tokens_per_second = config.rate_limit.ip_tokens_per_minute / 60.0;
+            limiter_config.per_ip.burst_tokens = config.rate_limit.ip_burst_tokens;
+            limiter_config.default_max_tokens = config.rate_limit.default_max_tokens;
+            rate_limiter = std::make_shared<ntonix::proxy::RateLimiter>(limiter_config);
+            NTONIX_LOG_INFO("ratelimit", "Rate limits configured: {} tokens/min per key, {} tokens/min per IP",
+                        config.rate_limit.key_tokens_per_minute, config.rate_limit.ip_tokens_per_minute);
+        }
+
+        // Forward a request (or micro-batch) through the queue to a backend
+        auto forward_to_backend = [load_balancer, forwarder, request_queue](
+            const ntonix::server::HttpRequest& req) -> ntonix::server::HttpResponse {
+            namespace http = boost::beast::http;
+
+            ntonix::balancer::FairQueue::Slot queue_slot;
+            if (request_queue) {
+                if (auto rejection = admit_request(*request_queue, *forwarder, req, queue_slot)) {
+                    return *rejection;
+                }
+            }
+
+            auto backend_selection = load_balancer->select_backend();
+            if (!backend_selection) {
+                NTONIX_LOG_WARN("balancer", "No healthy backends available - returning 503");
+                return ntonix::server::HttpResponse{
+                    .status = http::status::service_unavailable,
+                    .content_type = "application/json",
+                    .body = R"({"error": "No healthy backends available"})"
+                };
+            }
+
+            auto result = forwarder->forward(req, backend_selection->backend, req.client_ip);
+            ntonix::util::Metrics::instance().backend_request(result.backend_id, result.success, result.latency);
+            if (!result.success) {
+                NTONIX_LOG_WARN("proxy", "Forward failed: {}", result.error_message);
+            }
+            return result.response;
+        };
+
+        // Micro-batcher for /v1/completions (null when disabled)
+        std::shared_ptr<ntonix::proxy::MicroBatcher> micro_batcher;
+        if (config.batching.enabled) {
+            ntonix::proxy::MicroBatcherConfig batcher_config;
+            batcher_config.max_batch_size = config.batching.max_batch_size;
+            batcher_config.max_wait = std::chrono::milliseconds(config.batching.max_wait_ms);
+            batcher_config.result_timeout = std::max(forwarder_config.request_timeout,
+                                                     forwarder_config.max_client_timeout);
+            micro_batcher = std::make_shared<ntonix::proxy::MicroBatcher>(batcher_config, forward_to_backend);
+            NTONIX_LOG_INFO("batching", "Micro-batching configured for /v1/completions: max_batch_size={}, max_wait={}ms",
+                        config.batching.max_batch_size, config.batching.max_wait_ms);
+        }
 
         // Register SIGHUP handler for config reload (Unix only, handled in server via signal_set)
         config_manager.on_reload([health_checker, load_balancer, connection_pool](const std::vector<ntonix::config::BackendConfig>& backends) {
@@ -189,17 +433,20 @@ int main(int argc, char* argv[]) {
             for (const auto& backend : backends) {
                 NTONIX_LOG_INFO("config", "  - {}:{} (weight={})", backend.host, backend.port, backend.weight);
             }
-            // Update health checker, load balancer, connection pool, and metrics with new backend list
+            // Update metrics, health checker, load balancer and connection pool with new backend list
+            // (metrics first: new pools report their pre-connects straight away)
+            ntonix::util::Metrics::instance().set_backends(backends);
             health_checker->set_backends(backends);
             load_balancer->set_backends(backends);
             connection_pool->set_backends(backends);
-            ntonix::util::Metrics::instance().set_backends(backends);
         });
 
         // Streaming request handler - handles SSE streaming responses
-        auto streaming_handler = [load_balancer, forwarder](
+        auto streaming_handler = [load_balancer, forwarder, response_cache, stream_broadcasts, request_queue,
+                                  rate_limiter, cache_settings = config.cache](
             const ntonix::server::HttpRequest& req,
-            boost::beast::tcp_stream& client_stream) -> bool {
+            boost::beast::tcp_stream& client_stream,
+            std::function<void()> done) -> bool {
 
             using namespace ntonix::server;
             namespace http = boost::beast::http;
@@ -229,72 +476,240 @@ int main(int argc, char* argv[]) {
                 error_response.prepare_payload();
                 boost::beast::error_code ec;
                 http::write(client_stream, error_response, ec);
+                done();
                 return true;  // We handled it
             }
 
-            // Select backend using load balancer
-            auto backend_selection = load_balancer->select_backend();
-            if (!backend_selection) {
-                NTONIX_LOG_WARN("balancer", "No healthy backends available for streaming request");
-                http::response<http::string_body> error_response{http::status::service_unavailable, 11};
-                error_response.set(http::field::server, "NTONIX/0.1.0");
-                error_response.set(http::field::content_type, "application/json");
-                error_response.body() = R"({"error": "No healthy backends available"})";
-                error_response.prepare_payload();
-                boost::beast::error_code ec;
-                http::write(client_stream, error_response, ec);
-                return true;
+            // Streams are cached and shared under the same rules as JSON responses
+            std::string cache_control;
+            if (auto it = req.raw_request.find(http::field::cache_control); it != req.raw_request.end()) {
+                cache_control = std::string(it->value());
             }
+            bool use_cache = response_cache->is_enabled() &&
+                             !ntonix::cache::should_bypass_cache(cache_control);
+            auto cache_key = ntonix::cache::generate_completion_cache_key(
+                std::string(http::to_string(req.method)), req.target, req.body);
+
+            // Replay a cached completion (streamed or JSON) as SSE events
+            if (use_cache) {
+                if (auto cached = response_cache->get(cache_key)) {
+                    std::optional<std::vector<std::string>> events;
+                    if (cached->content_type == ntonix::cache::kSseContentType) {
+                        events = ntonix::cache::split_sse_events(cached->body);
+                    } else {
+                        events = ntonix::cache::completion_to_sse_events(
+                            cached->body, cache_settings.stream_replay_interval_ms > 0);
+                    }
 
-            const auto& backend = backend_selection->backend;
-            NTONIX_LOG_DEBUG("balancer", "Load balancer selected backend {}:{} for streaming (index={})",
-                        backend.host, backend.port, backend_selection->index);
+                    if (events && !events->empty()) {
+                        NTONIX_LOG_DEBUG("cache", "Cache HIT (stream): key={}", cache_key.to_string());
+                        ntonix::util::Metrics::instance().cache_hit();
 
-            // Forward with streaming support
-            auto result = forwarder->forward_with_streaming(req, backend, client_stream, req.client_ip);
+                        forwarder->forward_cached_stream(req, std::move(*events), client_stream,
+                            [done, request_id = req.x_request_id, client_ip = req.client_ip,
+                             method = std::string(http::to_string(req.method)),
+                             target = req.target](ntonix::proxy::ForwardResult result) {
+                                ntonix::util::AccessLogEntry access_entry;
+                                access_entry.request_id = request_id;
+                                access_entry.client_ip = client_ip;
+                                access_entry.method = method;
+                                access_entry.path = target;
+                                access_entry.status_code = 200;
+                                access_entry.response_size = result.stream_result.bytes_forwarded;
+                                access_entry.latency = result.latency;
+                                access_entry.cache_hit = true;
+                                ntonix::util::Logger::instance().access(access_entry);
+
+                                if (!result.success && !result.stream_result.client_disconnected) {
+                                    NTONIX_LOG_WARN("proxy", "Cached stream replay failed: {}",
+                                                    result.error_message);
+                                }
+                                done();
+                            });
+                        return true;
+                    }
+                }
+                NTONIX_LOG_DEBUG("cache", "Cache MISS (stream): key={}", cache_key.to_string());
+                ntonix::util::Metrics::instance().cache_miss();
+            }
 
-            if (result.is_streaming) {
-                // Log access for streaming request
-                ntonix::util::AccessLogEntry access_entry;
-                access_entry.request_id = req.x_request_id;
-                access_entry.client_ip = req.client_ip;
-                access_entry.method = std::string(http::to_string(req.method));
-                access_entry.path = req.target;
-                access_entry.status_code = 200;  // Streaming always starts with 200
-                access_entry.response_size = result.stream_result.bytes_forwarded;
-                access_entry.latency = result.latency;
-                access_entry.cache_hit = false;
-                access_entry.backend_host = result.backend_host;
-                access_entry.backend_port = result.backend_port;
-                ntonix::util::Logger::instance().access(access_entry);
+            // Forward to a backend ourselves, leading `broadcast` if there is one
+            auto forward_stream = [load_balancer, forwarder, response_cache, stream_broadcasts, request_queue,
+                                   rate_limiter, cache_settings, use_cache, cache_key, &client_stream, done](
+                const ntonix::server::HttpRequest& req, ntonix::proxy::StreamBroadcast::Ptr broadcast) {
+                // Close the shared stream to new joiners once the leader is done
+                auto release_broadcast = [stream_broadcasts, cache_key, broadcast]() {
+                    if (broadcast) {
+                        broadcast->abandon();
+                        stream_broadcasts->release(cache_key, broadcast);
+                    }
+                };
 
-                NTONIX_LOG_DEBUG("proxy", "Streaming complete: {} bytes forwarded from {}:{} in {}ms",
-                            result.stream_result.bytes_forwarded,
-                            result.backend_host, result.backend_port,
-                            result.latency.count());
+                // Charge the estimated token cost; the usage meter corrects it from the stream
+                ntonix::proxy::TokenEstimate token_estimate;
+                std::shared_ptr<ntonix::proxy::StreamUsageMeter> usage_meter;
+                if (rate_limiter) {
+                    token_estimate = ntonix::proxy::estimate_request_tokens(
+                        req.body, rate_limiter->config().default_max_tokens, rate_limiter->capacity());
+                    ntonix::proxy::RateCharge charge;
+                    if (auto rejection = charge_rate_limit(*rate_limiter, req, token_estimate, charge)) {
+                        release_broadcast();
+                        write_response(client_stream, *rejection);
+                        done();
+                        return;
+                    }
+                    usage_meter = std::make_shared<ntonix::proxy::StreamUsageMeter>(
+                        std::move(charge), token_estimate.prompt_tokens);
+                }
 
-                // Track backend metrics for streaming
-                ntonix::util::Metrics::instance().backend_request(
-                    result.backend_host, result.backend_port,
-                    result.success, result.latency);
-            } else {
-                // Backend returned non-streaming response, send it to client
-                http::response<http::string_body> response{result.response.status, 11};
-                response.set(http::field::server, "NTONIX/0.1.0");
-                response.set(http::field::content_type, result.response.content_type);
-                for (const auto& [name, value] : result.response.headers) {
-                    response.set(name, value);
+                // Wait for our fair share of backend capacity
+                ntonix::balancer::FairQueue::Slot queue_slot;
+                if (request_queue) {
+                    if (auto rejection = admit_request(*request_queue, *forwarder, req, queue_slot)) {
+                        release_broadcast();
+                        write_response(client_stream, *rejection);
+                        done();
+                        return;
+                    }
                 }
-                response.body() = result.response.body;
-                response.prepare_payload();
-                boost::beast::error_code ec;
-                http::write(client_stream, response, ec);
-            }
 
-            if (!result.success) {
-                NTONIX_LOG_WARN("proxy", "Streaming forward failed: {}", result.error_message);
+                // Select backend using load balancer
+                auto backend_selection = load_balancer->select_backend();
+                if (!backend_selection) {
+                    release_broadcast();
+                    NTONIX_LOG_WARN("balancer", "No healthy backends available for streaming request");
+                    http::response<http::string_body> error_response{http::status::service_unavailable, 11};
+                    error_response.set(http::field::server, "NTONIX/0.1.0");
+                    error_response.set(http::field::content_type, "application/json");
+                    error_response.body() = R"({"error": "No healthy backends available"})";
+                    error_response.prepare_payload();
+                    boost::beast::error_code ec;
+                    http::write(client_stream, error_response, ec);
+                    done();
+                    return;
+                }
+
+                const auto& backend = backend_selection->backend;
+                NTONIX_LOG_DEBUG("balancer", "Load balancer selected backend {}:{} for streaming (index={})",
+                            backend.host, backend.port, backend_selection->index);
+
+                // Forward with streaming support
+                ntonix::proxy::StreamObservers observers;
+                if (broadcast) {
+                    observers.push_back(broadcast);
+                }
+                if (use_cache && cache_settings.cache_streams) {
+                    observers.push_back(std::make_shared<ntonix::proxy::StreamCacheWriter>(
+                        response_cache, cache_key, stream_broadcasts->config().max_buffer_bytes,
+                        cache_settings.finish_streams_on_disconnect));
+                }
+                if (usage_meter) {
+                    observers.push_back(usage_meter);
+                }
+                // The stream is relayed asynchronously: everything that must wait
+                // for its end moves into the completion. The queue slot (and
+                // request_queue, which the slot refers to) goes too, but is given
+                // back as soon as the relay starts
+                auto slot = std::make_shared<ntonix::balancer::FairQueue::Slot>(std::move(queue_slot));
+                if (request_queue) {
+                    observers.push_back(std::make_shared<QueueSlotReleaser>(slot));
+                }
+                forwarder->forward_with_streaming(req, backend, client_stream, req.client_ip, observers,
+                    [release_broadcast, usage_meter, token_estimate, slot, request_queue, done, &client_stream,
+                     request_id = req.x_request_id, client_ip = req.client_ip,
+                     method = std::string(http::to_string(req.method)), target = req.target,
+                     model = ntonix::proxy::Forwarder::request_model(req)](ntonix::proxy::ForwardResult result) {
+                        slot->release();
+                        release_broadcast();
+                        if (usage_meter && !result.is_streaming) {
+                            usage_meter->charge().settle_response(result.response.body, result.success,
+                                                                  token_estimate.prompt_tokens);
+                        }
+
+                        if (result.is_streaming) {
+                            // Log access for streaming request
+                            ntonix::util::AccessLogEntry access_entry;
+                            access_entry.request_id = request_id;
+                            access_entry.client_ip = client_ip;
+                            access_entry.method = method;
+                            access_entry.path = target;
+                            access_entry.status_code = 200;  // Streaming always starts with 200
+                            access_entry.response_size = result.stream_result.bytes_forwarded;
+                            access_entry.latency = result.latency;
+                            access_entry.cache_hit = false;
+                            access_entry.backend_host = result.backend_host;
+                            access_entry.backend_port = result.backend_port;
+                            ntonix::util::Logger::instance().access(access_entry);
+
+                            NTONIX_LOG_DEBUG("proxy", "Streaming complete: {} bytes forwarded from {}:{} in {}ms",
+                                        result.stream_result.bytes_forwarded,
+                                        result.backend_host, result.backend_port,
+                                        result.latency.count());
+
+                            // Track backend metrics for streaming
+                            ntonix::util::Metrics::instance().backend_request(
+                                result.backend_id, result.success, result.latency);
+                            ntonix::util::Metrics::instance().stream_timing(
+                                result.backend_id, model, result.stream_result.timing);
+                        } else {
+                            // Backend returned non-streaming response, send it to client
+                            http::response<http::string_body> response{result.response.status, 11};
+                            response.set(http::field::server, "NTONIX/0.1.0");
+                            response.set(http::field::content_type, result.response.content_type);
+                            for (const auto& [name, value] : result.response.headers) {
+                                response.set(name, value);
+                            }
+                            response.body() = result.response.body;
+                            response.prepare_payload();
+                            boost::beast::error_code ec;
+                            http::write(client_stream, response, ec);
+                        }
+
+                        if (!result.success) {
+                            NTONIX_LOG_WARN("proxy", "Streaming forward failed: {}", result.error_message);
+                        }
+                        done();
+                    });
+            };
+
+            // Identical streaming requests share one backend stream. A joiner
+            // waits for the leader without holding this thread, and streams on
+            // its own if the leader fails or the replay window has been exceeded.
+            ntonix::proxy::StreamBroadcast::Ptr broadcast;
+            if (use_cache) {
+                bool leader = false;
+                broadcast = stream_broadcasts->acquire(cache_key, leader);
+                if (!leader) {
+                    NTONIX_LOG_DEBUG("proxy", "Joining in-flight stream: key={}", cache_key.to_string());
+                    auto request = std::make_shared<ntonix::server::HttpRequest>(req);
+                    forwarder->forward_shared_stream(req, broadcast, client_stream,
+                        [forward_stream, request, cache_key]() {
+                            NTONIX_LOG_DEBUG("proxy", "Cannot join in-flight stream, forwarding: key={}",
+                                             cache_key.to_string());
+                            forward_stream(*request, nullptr);
+                        },
+                        [request, done](ntonix::proxy::ForwardResult result) {
+                            ntonix::util::AccessLogEntry access_entry;
+                            access_entry.request_id = request->x_request_id;
+                            access_entry.client_ip = request->client_ip;
+                            access_entry.method = std::string(http::to_string(request->method));
+                            access_entry.path = request->target;
+                            access_entry.status_code = 200;
+                            access_entry.response_size = result.stream_result.bytes_forwarded;
+                            access_entry.latency = result.latency;
+                            access_entry.cache_hit = true;
+                            ntonix::util::Logger::instance().access(access_entry);
+
+                            if (!result.success && !result.stream_result.client_disconnected) {
+                                NTONIX_LOG_WARN("proxy", "Shared stream failed: {}", result.error_message);
+                            }
+                            done();
+                        });
+                    return true;
+                }
             }
 
+            forward_stream(req, broadcast);
             return true;  // We handled the request
         };
 
@@ -305,7 +720,9 @@ int main(int argc, char* argv[]) {
         ntonix::server::SslStreamingRequestHandler ssl_streaming_handler = nullptr;
 
         // HTTP request handler using Boost.Beast (non-streaming requests)
-        auto request_handler = [load_balancer, forwarder, response_cache](const ntonix::server::HttpRequest& req) -> ntonix::server::HttpResponse {
+        auto request_handler = [load_balancer, forwarder, response_cache, inflight_requests, request_queue,
+                                rate_limiter, micro_batcher, embedding_cache, forward_to_backend,
+                                cache_settings = config.cache](const ntonix::server::HttpRequest& req) -> ntonix::server::HttpResponse {
             using namespace ntonix::server;
             namespace http = boost::beast::http;
 
@@ -392,8 +809,8 @@ int main(int argc, char* argv[]) {
                 }
                 bool bypass_cache = ntonix::cache::should_bypass_cache(cache_control);
 
-                // Generate cache key from request
-                auto cache_key = ntonix::cache::generate_cache_key(
+                // Generate cache key from request (shared with streaming requests)
+                auto cache_key = ntonix::cache::generate_completion_cache_key(
                     std::string(http::to_string(req.method)),
                     req.target,
                     req.body
@@ -402,6 +819,17 @@ int main(int argc, char* argv[]) {
                 // Try cache lookup (unless bypass requested)
                 if (!bypass_cache && response_cache->is_enabled()) {
                     auto cached = response_cache->get(cache_key);
+
+                    // A cached stream is served as the assembled completion
+                    if (cached && cached->content_type == ntonix::cache::kSseContentType) {
+                        if (auto assembled = ntonix::cache::sse_to_completion(cached->body)) {
+                            cached->body = std::move(*assembled);
+                            cached->content_type = ntonix::cache::kJsonContentType;
+                        } else {
+                            cached.reset();
+                        }
+                    }
+
                     if (cached) {
                         NTONIX_LOG_DEBUG("cache", "Cache HIT: key={}", cache_key.to_string());
                         ntonix::util::Metrics::instance().cache_hit();
@@ -433,6 +861,91 @@ int main(int argc, char* argv[]) {
                     ntonix::util::Metrics::instance().cache_miss();
                 }
 
+                // Charge the estimated token cost (corrected from usage below) before
+                // joining a flight, so a rate-limited caller never leads one; followers
+                // are refunded if they end up sharing the leader's response
+                ntonix::proxy::TokenEstimate token_estimate;
+                ntonix::proxy::RateCharge rate_charge;
+                if (rate_limiter) {
+                    token_estimate = ntonix::proxy::estimate_request_tokens(
+                        req.body, rate_limiter->config().default_max_tokens, rate_limiter->capacity());
+                    if (auto rejection = charge_rate_limit(*rate_limiter, req, token_estimate, rate_charge)) {
+                        rejection->headers.push_back({"X-Request-ID", request_id});
+                        return *rejection;
+                    }
+                }
+
+                // Coalesce identical in-flight misses: the first request forwards,
+                // later identical requests wait (within their own deadline) and share its response
+                ntonix::cache::SingleFlight::Call flight;
+                auto flight_deadline = forwarder->make_deadline(req);
+                while (!bypass_cache && response_cache->is_enabled()) {
+                    flight = inflight_requests->begin(cache_key);
+                    if (flight.is_leader()) {
+                        break;
+                    }
+
+                    auto shared = flight.wait(flight_deadline.remaining());
+                    if (!shared) {
+                        NTONIX_LOG_DEBUG("cache", "Deadline expired waiting for in-flight request: key={}",
+                                    cache_key.to_string());
+                        ntonix::util::Metrics::instance().request_timed_out();
+                        rate_charge.settle(0);
+                        return HttpResponse{
+                            .status = http::status::gateway_timeout,
+                            .content_type = "application/json",
+                            .body = R"({"error": "Backend request timed out"})",
+                            .headers = {{"X-Request-ID", request_id}}
+                        };
+                    }
+                    if (shared->success) {
+                        NTONIX_LOG_DEBUG("cache", "Coalesced with in-flight request: key={}", cache_key.to_string());
+                        ntonix::util::Metrics::instance().cache_coalesced();
+                        rate_charge.settle(0);
+
+                        auto end_time = std::chrono::steady_clock::now();
+                        auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+
+                        ntonix::util::AccessLogEntry access_entry;
+                        access_entry.request_id = request_id;
+                        access_entry.client_ip = req.client_ip;
+                        access_entry.method = std::string(http::to_string(req.method));
+                        access_entry.path = req.target;
+                        access_entry.status_code = shared->status;
+                        access_entry.request_size = req.body.size();
+                        access_entry.response_size = shared->body.size();
+                        access_entry.latency = latency;
+                        access_entry.cache_hit = true;
+                        ntonix::util::Logger::instance().access(access_entry);
+
+                        return HttpResponse{
+                            .status = static_cast<http::status>(shared->status),
+                            .content_type = shared->content_type,
+                            .body = std::move(shared->body),
+                            .headers = {{"X-Cache", "COALESCED"}, {"X-Request-ID", request_id}}
+                        };
+                    }
+                    if (shared->status != 0) {
+                        // Leader got a backend response we don't share (e.g. an error) - forward independently
+                        NTONIX_LOG_DEBUG("cache", "In-flight request failed, forwarding: key={}",
+                                    cache_key.to_string());
+                        flight = {};
+                        break;
+                    }
+                    // Leader gave up before reaching a backend (e.g. queue full): elect a new one
+                    NTONIX_LOG_DEBUG("cache", "In-flight request was abandoned, rejoining: key={}",
+                                cache_key.to_string());
+                }
+
+                // Wait for our fair share of backend capacity
+                ntonix::balancer::FairQueue::Slot queue_slot;
+                if (request_queue) {
+                    if (auto rejection = admit_request(*request_queue, *forwarder, req, queue_slot)) {
+                        rejection->headers.push_back({"X-Request-ID", request_id});
+                        return *rejection;
+                    }
+                }
+
                 // Select backend using load balancer
                 auto backend_selection = load_balancer->select_backend();
                 if (!backend_selection) {
@@ -449,8 +962,19 @@ int main(int argc, char* argv[]) {
                 NTONIX_LOG_DEBUG("balancer", "Load balancer selected backend {}:{} (index={})",
                             backend.host, backend.port, backend_selection->index);
 
+                // Abandon the backend request if the client goes away, unless
+                // coalesced followers or the cache still want the response
+                bool finish_for_cache = cache_settings.finish_requests_on_disconnect &&
+                                        response_cache->is_enabled() && !bypass_cache;
+                ntonix::proxy::DisconnectWatch disconnect;
+                if (!finish_for_cache) {
+                    disconnect.fd = req.client_socket;
+                    disconnect.keep_result = [&flight] { return flight.has_followers(); };
+                }
+
                 // Forward the request to the selected backend (non-streaming)
-                auto result = forwarder->forward(req, backend, req.client_ip);
+                auto result = forwarder->forward(req, backend, req.client_ip, disconnect);
+                rate_charge.settle_response(result.response.body, result.success, token_estimate.prompt_tokens);
 
                 // Calculate total latency for access log
                 auto end_time = std::chrono::steady_clock::now();
@@ -462,7 +986,7 @@ int main(int argc, char* argv[]) {
                 access_entry.client_ip = req.client_ip;
                 access_entry.method = std::string(http::to_string(req.method));
                 access_entry.path = req.target;
-                access_entry.status_code = static_cast<int>(result.response.status);
+                access_entry.status_code = result.cancelled ? 499 : static_cast<int>(result.response.status);  // 499: client closed request
                 access_entry.request_size = req.body.size();
                 access_entry.response_size = result.response.body.size();
                 access_entry.latency = total_latency;
@@ -476,29 +1000,153 @@ int main(int argc, char* argv[]) {
                             result.backend_host, result.backend_port,
                             result.latency.count());
 
-                // Track backend metrics
-                ntonix::util::Metrics::instance().backend_request(
-                    result.backend_host, result.backend_port,
-                    result.success, result.latency);
+                // Track backend metrics (a client disconnect says nothing about the backend)
+                if (!result.cancelled) {
+                    ntonix::util::Metrics::instance().backend_request(
+                        result.backend_id, result.success, result.latency);
+                }
 
-                if (!result.success) {
+                if (!result.success && !result.cancelled) {
                     NTONIX_LOG_WARN("proxy", "Forward failed: {}", result.error_message);
                 }
 
                 // Cache successful responses (2xx status codes only)
-                if (result.success && response_cache->is_enabled() && !bypass_cache &&
+                bool cacheable = result.success &&
                     static_cast<int>(result.response.status) >= 200 &&
-                    static_cast<int>(result.response.status) < 300) {
+                    static_cast<int>(result.response.status) < 300;
+                if (cacheable && response_cache->is_enabled() && !bypass_cache) {
                     response_cache->put(cache_key, result.response.body, result.response.content_type);
                     NTONIX_LOG_DEBUG("cache", "Cached response: key={}, size={}", cache_key.to_string(), result.response.body.size());
                 }
 
+                // Release coalesced followers (after the cache put, so new arrivals hit the cache)
+                if (flight.is_leader()) {
+                    flight.publish(ntonix::cache::FlightResult{
+                        .success = cacheable,
+                        .status = static_cast<int>(result.response.status),
+                        .body = result.response.body,
+                        .content_type = result.response.content_type
+                    });
+                }
+
                 // Add cache and request ID headers to response
                 result.response.headers.push_back({"X-Cache", "MISS"});
                 result.response.headers.push_back({"X-Request-ID", request_id});
                 return result.response;
             }
 
+            // Handle OpenAI-compatible completions endpoint (non-streaming),
+            // micro-batched with compatible concurrent requests when enabled
+            if (req.target == "/v1/completions" && req.method == http::verb::post) {
+                if (req.content_type.find("application/json") == std::string::npos) {
+                    return HttpResponse{
+                        .status = http::status::unsupported_media_type,
+                        .content_type = "application/json",
+                        .body = R"({"error": "Content-Type must be application/json"})"
+                    };
+                }
+
+                // Charge the estimated token cost (corrected from usage below)
+                ntonix::proxy::TokenEstimate token_estimate;
+                ntonix::proxy::RateCharge rate_charge;
+                if (rate_limiter) {
+                    token_estimate = ntonix::proxy::estimate_request_tokens(
+                        req.body, rate_limiter->config().default_max_tokens, rate_limiter->capacity());
+                    if (auto rejection = charge_rate_limit(*rate_limiter, req, token_estimate, rate_charge)) {
+                        rejection->headers.push_back({"X-Request-ID", request_id});
+                        return *rejection;
+                    }
+                }
+
+                std::optional<HttpResponse> response;
+                if (micro_batcher) {
+                    response = micro_batcher->submit(req);
+                }
+                if (!response) {
+                    response = forward_to_backend(req);
+                }
+
+                auto status = static_cast<int>(response->status);
+                rate_charge.settle_response(response->body, status >= 200 && status < 300,
+                                            token_estimate.prompt_tokens);
+
+                auto end_time = std::chrono::steady_clock::now();
+                ntonix::util::AccessLogEntry access_entry;
+                access_entry.request_id = request_id;
+                access_entry.client_ip = req.client_ip;
+                access_entry.method = std::string(http::to_string(req.method));
+                access_entry.path = req.target;
+                access_entry.status_code = status;
+                access_entry.request_size = req.body.size();
+                access_entry.response_size = response->body.size();
+                access_entry.latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+                access_entry.cache_hit = false;
+                ntonix::util::Logger::instance().access(access_entry);
+
+                response->headers.push_back({"X-Request-ID", request_id});
+                return *response;
+            }
+
+            // Handle OpenAI-compatible embeddings endpoint: inputs are cached
+            // individually and only the misses are forwarded, as one batch
+            if (req.target == "/v1/embeddings" && req.method == http::verb::post) {
+                if (req.content_type.find("application/json") == std::string::npos) {
+                    return HttpResponse{
+                        .status = http::status::unsupported_media_type,
+                        .content_type = "application/json",
+                        .body = R"({"error": "Content-Type must be application/json"})"
+                    };
+                }
+
+                std::string cache_control;
+                if (auto it = req.raw_request.find(http::field::cache_control); it != req.raw_request.end()) {
+                    cache_control = std::string(it->value());
+                }
+                bool bypass_cache = ntonix::cache::should_bypass_cache(cache_control);
+
+                // Charges only what actually reaches a backend
+                auto dispatch = [&](const HttpRequest& backend_req) -> HttpResponse {
+                    ntonix::proxy::TokenEstimate token_estimate;
+                    ntonix::proxy::RateCharge rate_charge;
+                    if (rate_limiter) {
+                        token_estimate = ntonix::proxy::estimate_request_tokens(backend_req.body, 0, rate_limiter->capacity());
+                        if (auto rejection = charge_rate_limit(*rate_limiter, backend_req, token_estimate, rate_charge)) {
+                            return *rejection;
+                        }
+                    }
+                    auto response = forward_to_backend(backend_req);
+                    auto status = static_cast<int>(response.status);
+                    rate_charge.settle_response(response.body, status >= 200 && status < 300,
+                                                token_estimate.prompt_tokens);
+                    return response;
+                };
+
+                std::optional<HttpResponse> response;
+                if (!bypass_cache && response_cache->is_enabled()) {
+                    response = embedding_cache->handle(req, dispatch);
+                }
+                if (!response) {
+                    response = dispatch(req);
+                }
+
+                auto end_time = std::chrono::steady_clock::now();
+                ntonix::util::AccessLogEntry access_entry;
+                access_entry.request_id = request_id;
+                access_entry.client_ip = req.client_ip;
+                access_entry.method = std::string(http::to_string(req.method));
+                access_entry.path = req.target;
+                access_entry.status_code = static_cast<int>(response->status);
+                access_entry.request_size = req.body.size();
+                access_entry.response_size = response->body.size();
+                access_entry.latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+                access_entry.cache_hit = std::find(response->headers.begin(), response->headers.end(),
+                    std::pair<std::string, std::string>{"X-Cache", "HIT"}) != response->headers.end();
+                ntonix::util::Logger::instance().access(access_entry);
+
+                response->headers.push_back({"X-Request-ID", request_id});
+                return *response;
+            }
+
             // Handle root path - gateway info
             if (req.target == "/" && req.method == http::verb::get) {
                 return HttpResponse{
@@ -512,7 +1160,9 @@ int main(int argc, char* argv[]) {
     "health": "/health",
     "metrics": "/metrics",
     "cache_stats": "/cache/stats",
-    "chat_completions": "/v1/chat/completions"
+    "chat_completions": "/v1/chat/completions",
+    "completions": "/v1/completions",
+    "embeddings": "/v1/embeddings"
   }
 })"
                 };
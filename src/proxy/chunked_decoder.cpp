@@ -0,0 +1,162 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Chunked Decoder implementation
+ */
+
+#include "proxy/chunked_decoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ntonix::proxy {
+
+namespace {
+
+constexpr std::size_t kMaxSizeDigits = 15;   // Chunk sizes below 2^60
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+void ChunkedDecoder::end_size_line() {
+    if (size_digits_ == 0) {
+        state_ = State::failed;
+    } else if (chunk_size_ == 0) {
+        state_ = State::trailer_start;
+    } else {
+        remaining_ = chunk_size_;
+        state_ = State::data;
+    }
+}
+
+std::size_t ChunkedDecoder::decode(char* data, std::size_t size) {
+    char* out = data;
+    const char* p = data;
+    const char* end = data + size;
+
+    while (p != end) {
+        switch (state_) {
+        case State::size: {
+            char c = *p++;
+            if (int digit = hex_value(c); digit >= 0) {
+                if (++size_digits_ > kMaxSizeDigits) {
+                    state_ = State::failed;
+                    break;
+                }
+                chunk_size_ = chunk_size_ * 16 + static_cast<std::uint64_t>(digit);
+            } else if (c == ';' || c == ' ' || c == '\t') {
+                state_ = State::extension;
+            } else if (c == '\r') {
+                state_ = State::size_lf;
+            } else if (c == '\n') {
+                end_size_line();
+            } else {
+                state_ = State::failed;
+            }
+            break;
+        }
+
+        case State::extension: {
+            auto line_end = std::find(p, end, '\n');
+            if (line_end == end) {
+                p = end;
+                break;
+            }
+            p = line_end + 1;
+            end_size_line();
+            break;
+        }
+
+        case State::size_lf:
+            if (*p++ != '\n') {
+                state_ = State::failed;
+                break;
+            }
+            end_size_line();
+            break;
+
+        case State::data: {
+            auto n = static_cast<std::size_t>(
+                std::min<std::uint64_t>(remaining_, static_cast<std::uint64_t>(end - p)));
+            if (out != p) {
+                std::memmove(out, p, n);
+            }
+            out += n;
+            p += n;
+            remaining_ -= n;
+            if (remaining_ == 0) {
+                state_ = State::data_cr;
+            }
+            break;
+        }
+
+        case State::data_cr: {
+            char c = *p++;
+            if (c == '\r') {
+                state_ = State::data_lf;
+            } else if (c == '\n') {
+                chunk_size_ = 0;
+                size_digits_ = 0;
+                state_ = State::size;
+            } else {
+                state_ = State::failed;
+            }
+            break;
+        }
+
+        case State::data_lf:
+            if (*p++ != '\n') {
+                state_ = State::failed;
+                break;
+            }
+            chunk_size_ = 0;
+            size_digits_ = 0;
+            state_ = State::size;
+            break;
+
+        case State::trailer_start: {
+            char c = *p++;
+            if (c == '\r') {
+                state_ = State::final_lf;
+            } else if (c == '\n') {
+                state_ = State::done;
+            } else {
+                state_ = State::trailer;
+            }
+            break;
+        }
+
+        case State::trailer: {
+            auto line_end = std::find(p, end, '\n');
+            if (line_end == end) {
+                p = end;
+                break;
+            }
+            p = line_end + 1;
+            state_ = State::trailer_start;
+            break;
+        }
+
+        case State::final_lf:
+            state_ = *p++ == '\n' ? State::done : State::failed;
+            break;
+
+        case State::done:
+            excess_ += static_cast<std::size_t>(end - p);
+            p = end;
+            break;
+
+        case State::failed:
+            return static_cast<std::size_t>(out - data);
+        }
+    }
+
+    return static_cast<std::size_t>(out - data);
+}
+
+} // namespace ntonix::proxy
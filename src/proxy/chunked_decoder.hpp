@@ -0,0 +1,81 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Chunked Decoder - Incremental decoding of HTTP/1.1 chunked message bodies
+ *
+ * Streamed backend responses are relayed read by read, so the chunk framing
+ * (size lines, CRLFs, terminal chunk and trailers) can be split anywhere.
+ * The decoder carries its position across reads, strips the framing in
+ * place and reports the exact end of the body, which is what lets a
+ * streamed connection go back to the pool.
+ */
+
+#ifndef NTONIX_PROXY_CHUNKED_DECODER_HPP
+#define NTONIX_PROXY_CHUNKED_DECODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ntonix::proxy {
+
+/**
+ * Chunked Decoder - one per response body, not thread-safe
+ *
+ * Chunk extensions and trailers are skipped. A bare LF is accepted where
+ * CRLF is expected.
+ */
+class ChunkedDecoder {
+public:
+    /**
+     * Decode the next bytes of the body in place
+     * Payload bytes are moved to the front of `data`; bytes after the end of
+     * the body are left alone and counted in excess().
+     *
+     * @return Number of payload bytes now at the start of data
+     */
+    std::size_t decode(char* data, std::size_t size);
+
+    /**
+     * True once the terminal chunk and trailers have been consumed
+     */
+    bool done() const { return state_ == State::done; }
+
+    /**
+     * True if the framing was malformed (decoding stops)
+     */
+    bool failed() const { return state_ == State::failed; }
+
+    /**
+     * Bytes received after the end of the body
+     */
+    std::size_t excess() const { return excess_; }
+
+private:
+    enum class State {
+        size,           // Hex chunk size
+        extension,      // Chunk extension, up to the end of the size line
+        size_lf,        // LF ending the size line
+        data,           // Chunk payload
+        data_cr,        // CR after the payload
+        data_lf,        // LF after the payload
+        trailer_start,  // Start of a trailer line, or the blank line ending the body
+        trailer,        // Rest of a trailer line
+        final_lf,       // LF of the blank line ending the body
+        done,
+        failed
+    };
+
+    /**
+     * The size line is complete
+     */
+    void end_size_line();
+
+    State state_{State::size};
+    std::uint64_t chunk_size_{0};
+    std::uint64_t remaining_{0};    // Payload bytes left in the current chunk
+    std::size_t size_digits_{0};
+    std::size_t excess_{0};
+};
+
+} // namespace ntonix::proxy
+
+#endif // NTONIX_PROXY_CHUNKED_DECODER_HPP
@@ -4,12 +4,106 @@
  */
 
 #include "proxy/connection_pool.hpp"
+#include "config/backend_registry.hpp"
+#include "proxy/deadline_stream.hpp"
+#include "util/metrics.hpp"
 
 #include <boost/asio/connect.hpp>
-#include <unordered_set>
+
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <vector>
 
 namespace ntonix::proxy {
 
+namespace {
+
+/**
+ * Connect to the first reachable endpoint, giving up at the deadline
+ * (asio's synchronous connect would block for the kernel's SYN timeout)
+ *
+ * This still waits on the calling thread. Requests are forwarded
+ * synchronously from I/O threads, so a connect to a backend that drops
+ * SYNs holds one of the server's threads for up to timeouts.connect_ms;
+ * only prewarm() connects asynchronously.
+ */
+void connect_with_deadline(tcp::socket& socket,
+                           const std::vector<tcp::endpoint>& endpoints,
+                           std::chrono::steady_clock::time_point deadline,
+                           boost::system::error_code& ec) {
+    ec = asio::error::host_not_found;
+    for (const auto& endpoint : endpoints) {
+        boost::system::error_code close_ec;
+        socket.close(close_ec);
+
+        socket.open(endpoint.protocol(), ec);
+        if (ec) continue;
+        socket.non_blocking(true, ec);
+        if (ec) continue;
+
+        if (::connect(socket.native_handle(), endpoint.data(), endpoint.size()) == 0) {
+            ec.clear();
+        } else if (errno != EINPROGRESS) {
+            ec = boost::system::error_code(errno, boost::system::system_category());
+            continue;
+        } else {
+            auto status = wait_socket(socket.native_handle(), true, deadline);
+            if (status == WaitStatus::timeout) {
+                ec = asio::error::timed_out;
+                break;  // The deadline covers all endpoints
+            }
+
+            int error = 0;
+            socklen_t len = sizeof(error);
+            if (::getsockopt(socket.native_handle(), SOL_SOCKET, SO_ERROR, &error, &len) != 0) {
+                error = errno;
+            }
+            if (error != 0) {
+                ec = boost::system::error_code(error, boost::system::system_category());
+                continue;
+            }
+            ec.clear();
+        }
+
+        socket.non_blocking(false, ec);
+        return;
+    }
+
+    boost::system::error_code close_ec;
+    socket.close(close_ec);
+}
+
+/**
+ * Connections used more recently than this skip the liveness probe
+ */
+constexpr std::chrono::milliseconds kLivenessCheckAfter{5};
+
+/**
+ * Pool sizing: spare capacity over the estimated concurrency, and the
+ * weight of a new estimate when demand falls (it takes effect at once
+ * when demand rises)
+ */
+constexpr double kSizeHeadroom = 1.25;
+constexpr double kShrinkSmoothing = 0.3;
+
+std::atomic<std::uint64_t> next_manager_id{1};
+
+/**
+ * A thread's copy of one manager's pools (see thread_pools())
+ */
+struct ThreadPools {
+    std::uint64_t manager{0};
+    std::uint64_t generation{0};
+    std::vector<std::shared_ptr<BackendPool>> pools;   // Indexed by BackendRegistry::slot()
+};
+
+thread_local ThreadPools thread_pools_copy;
+
+} // namespace
+
 // ============================================================================
 // PooledConnection Implementation
 // ============================================================================
@@ -34,6 +128,22 @@ bool PooledConnection::is_valid() const {
     return socket_.is_open();
 }
 
+bool PooledConnection::is_alive() const {
+    if (!socket_.is_open()) {
+        return false;
+    }
+    if (idle_time() < kLivenessCheckAfter) {
+        return true;
+    }
+
+    // An idle HTTP/1.1 connection has nothing to read: EOF means the
+    // backend closed it, an error means it was reset, and stray bytes
+    // would be mistaken for the next response
+    char byte;
+    auto n = ::recv(const_cast<tcp::socket&>(socket_).native_handle(), &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
 bool PooledConnection::is_idle(std::chrono::seconds max_idle) const {
     if (in_use_) return false;
     auto now = std::chrono::steady_clock::now();
@@ -104,95 +214,442 @@ void ConnectionGuard::release() {
 
 BackendPool::BackendPool(asio::io_context& io_context,
                          const config::BackendConfig& backend,
-                         const ConnectionPoolConfig& config)
+                         const ConnectionPoolConfig& config,
+                         std::shared_ptr<util::DnsCache> dns_cache)
     : io_context_(io_context)
     , backend_(backend)
     , config_(config)
+    , dns_cache_(std::move(dns_cache))
     , in_use_(0)
-    , total_created_(0) {
+    , total_created_(0)
+    , limit_(config.adaptive_size
+                 ? std::clamp(config.pool_size_per_backend, config.min_size, config.max_size)
+                 : config.pool_size_per_backend)
+    , target_(limit_.load()) {
+    // Until the first resize the configured size is the estimate
+    util::Metrics::instance().set_backend_pool_size(backend_.id, 0, limit_.load(), target_.load());
 }
 
 BackendPool::~BackendPool() {
     close_all();
 }
 
-std::optional<ConnectionGuard> BackendPool::get_connection() {
-    PooledConnection::Ptr conn;
+std::optional<ConnectionGuard> BackendPool::get_connection(std::chrono::milliseconds connect_timeout,
+                                                          bool fresh) {
+    auto start = std::chrono::steady_clock::now();
 
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
+    // Fast path: a connection this thread returned, without locking
+    PooledConnection::Ptr conn = fresh ? nullptr : unpark(false);
+    bool reserved = false;
+    if (conn) {
+        in_use_++;
+        parked_--;   // After counting it in use, so the pool never looks under-full
+    }
+
+    if (!conn) {
+        std::unique_lock<std::mutex> lock(mutex_);
 
         // Try to get an existing connection from the pool
-        while (!available_.empty()) {
+        while (!fresh && !available_.empty()) {
             auto candidate = available_.front();
             available_.pop_front();
 
-            if (candidate->is_valid()) {
+            if (usable(*candidate)) {
                 conn = candidate;
+                in_use_++;
                 break;
             }
-            // Invalid connection, discard it
-            spdlog::debug("Discarding invalid pooled connection to {}:{}",
-                         backend_.host, backend_.port);
         }
-    }
 
-    // If no available connection, create a new one if under limit
-    if (!conn) {
-        std::size_t current_total = available_count() + in_use_.load();
-        if (current_total < config_.pool_size_per_backend) {
-            conn = create_connection();
+        // Then one parked by another thread
+        if (!fresh && !conn && parked_.load() > 0 && (conn = unpark(true))) {
+            in_use_++;
+            parked_--;
+        }
+
+        // Otherwise reserve a slot for a new connection if under limit;
+        // an adaptive pool grows rather than queue (resize() shrinks it back)
+        if (!conn) {
+            auto open = available_.size() + parked_.load() + in_use_.load() + warming_;
+            auto limit = limit_.load();
+            if (open >= limit && config_.adaptive_size && open < config_.max_size) {
+                limit = open + 1;
+                limit_.store(limit);
+                spdlog::debug("Growing connection pool for {}:{} to {}", backend_.host, backend_.port, limit);
+            }
+            if (open < limit) {
+                in_use_++;
+                reserved = true;
+            }
+        }
+
+        // A fresh connection may take the slot of the oldest idle one
+        if (fresh && !conn && !reserved) {
+            PooledConnection::Ptr idle;
+            if (!available_.empty()) {
+                idle = std::move(available_.back());
+                available_.pop_back();
+            } else if ((idle = unpark(true))) {
+                parked_--;
+            }
+            if (idle) {
+                in_use_++;
+                reserved = true;
+            }
+        }
+
+        // Otherwise queue for the next connection or slot given back
+        if (!conn && !reserved) {
+            if (waiters_.size() >= config_.max_waiters) {
+                lock.unlock();
+                util::Metrics::instance().backend_pool_wait_rejected(backend_.id);
+                spdlog::warn("Connection pool exhausted for {}:{} (max={}, waiting={})",
+                            backend_.host, backend_.port, limit_.load(), config_.max_waiters);
+                return std::nullopt;
+            }
+
+            auto waiter = std::make_shared<Waiter>();
+            waiters_.push_back(waiter);
+            waiting_++;
+
+            // A lock-free return that missed waiting_ parked its connection
+            // before the increment; take it now rather than wait for it
+            if (auto late = unpark(true)) {
+                waiters_.pop_back();
+                waiting_--;
+                in_use_++;
+                parked_--;
+                conn = std::move(late);
+            }
+        }
+
+        if (!conn && !reserved) {
+            auto waiter = waiters_.back();
+            util::Metrics::instance().backend_pool_wait_started(backend_.id);
+
+            waiter->cv.wait_until(lock, start + std::min(connect_timeout, config_.max_wait),
+                                  [&] { return waiter->served; });
+            if (waiter->served) {
+                conn = std::move(waiter->conn);
+                reserved = !conn;
+            } else {
+                waiters_.erase(std::find(waiters_.begin(), waiters_.end(), waiter));
+                waiting_--;
+            }
+            lock.unlock();
+
+            auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+            util::Metrics::instance().backend_pool_wait_finished(backend_.id, waited, waiter->served);
+            if (!waiter->served) {
+                spdlog::warn("Timed out waiting for a pooled connection to {}:{} after {}ms",
+                            backend_.host, backend_.port, waited.count() / 1000);
+                return std::nullopt;
+            }
         }
     }
 
+    bool reused = conn != nullptr;
     if (!conn) {
-        spdlog::warn("Connection pool exhausted for {}:{} (max={})",
-                    backend_.host, backend_.port, config_.pool_size_per_backend);
-        return std::nullopt;
+        // The wait, if any, came out of the connect budget
+        auto remaining = connect_timeout - std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        conn = create_connection(std::min(remaining, config_.connection_timeout));
+        if (!conn) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_use_--;
+            hand_off(conn);   // The slot, to whoever is waiting
+            return std::nullopt;
+        }
     }
 
     conn->mark_in_use();
-    in_use_++;
+    conn->reused_ = reused;
+
+    checkouts_++;
+    auto in_use = in_use_.load();
+    auto peak = peak_in_use_.load();
+    while (in_use > peak && !peak_in_use_.compare_exchange_weak(peak, in_use)) {
+    }
 
-    // Create release function that returns to this pool
-    auto release_func = [this](PooledConnection::Ptr c, bool reusable) {
-        return_connection(std::move(c), reusable);
+    // Create release function that returns to this pool while it exists
+    auto release_func = [weak = weak_from_this()](PooledConnection::Ptr c, bool reusable) {
+        if (auto pool = weak.lock()) {
+            pool->return_connection(std::move(c), reusable);
+        }
     };
 
     return ConnectionGuard(std::move(conn), std::move(release_func));
 }
 
 void BackendPool::return_connection(PooledConnection::Ptr conn, bool reusable) {
-    if (in_use_ > 0) {
-        in_use_--;
+    if (conn) {
+        auto held = std::chrono::steady_clock::now() - conn->last_used_;
+        hold_us_ += std::chrono::duration_cast<std::chrono::microseconds>(held).count();
+        returns_++;
+        conn->mark_returned();
+    }
+    bool keep = conn && reusable && conn->is_valid() && !retired_.load();
+    if (!keep) {
+        conn.reset();
     }
 
-    if (!conn) return;
+    // Fast path: park it for this thread's next checkout, without locking
+    if (keep && waiting_.load() == 0 && park(conn)) {
+        in_use_--;   // After parking, so the pool never looks under-full
 
-    conn->mark_returned();
+        // Retired while parking: retire() may have drained the shards already
+        if (retired_.load()) {
+            close_all();
+            return;
+        }
+
+        // A checkout that started waiting meanwhile may have missed it
+        if (waiting_.load() > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!waiters_.empty()) {
+                if (auto parked = unpark(true)) {
+                    hand_off(parked);
+                    parked_--;
+                }
+            }
+        }
+        return;
+    }
 
-    if (reusable && conn->is_valid()) {
+    bool handed_off = false;
+    {
         std::lock_guard<std::mutex> lock(mutex_);
-        // Add back to the front (LIFO) for better cache locality
-        available_.push_front(std::move(conn));
-        spdlog::debug("Returned connection to pool for {}:{} (available={}, in_use={})",
-                     backend_.host, backend_.port, available_.size(), in_use_.load());
-    } else {
+        if (in_use_ > 0) {
+            in_use_--;
+        }
+
+        // A waiting checkout gets the connection (or the freed slot) first
+        handed_off = hand_off(conn);
+        if (keep && !handed_off && !retired_.load()) {
+            // Add back to the front (LIFO) for better cache locality
+            available_.push_front(std::move(conn));
+            spdlog::debug("Returned connection to pool for {}:{} (available={}, in_use={})",
+                         backend_.host, backend_.port, available_.size(), in_use_.load());
+        }
+    }
+
+    if (handed_off) {
+        spdlog::debug("Handed {} to a waiting request for {}:{}",
+                     keep ? "returned connection" : "freed slot", backend_.host, backend_.port);
+    }
+    if (!keep) {
         spdlog::debug("Discarding non-reusable connection to {}:{}",
                      backend_.host, backend_.port);
+        if (!handed_off) {
+            prewarm();
+        }
+    }
+}
+
+std::size_t BackendPool::shard_index() {
+    static std::atomic<std::size_t> next_thread{0};
+    thread_local const std::size_t index = next_thread.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return index;
+}
+
+bool BackendPool::park(PooledConnection::Ptr& conn) {
+    auto& shard = shards_[shard_index()];
+    for (auto& slot : shard.slots) {
+        if (slot.load(std::memory_order_relaxed) != nullptr) {
+            continue;
+        }
+        auto* raw = conn.get();
+        raw->parked_self_ = std::move(conn);
+        PooledConnection* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, raw)) {
+            parked_++;
+            return true;
+        }
+        conn = std::move(raw->parked_self_);
+    }
+    return false;
+}
+
+PooledConnection::Ptr BackendPool::unpark(bool steal) {
+    auto own = shard_index();
+    auto shards = steal ? kShards : 1;
+    for (std::size_t i = 0; i < shards; ++i) {
+        auto& shard = shards_[(own + i) % kShards];
+        // Newest first: the last slots filled are the most recently used
+        for (auto it = shard.slots.rbegin(); it != shard.slots.rend(); ++it) {
+            if (it->load(std::memory_order_relaxed) == nullptr) {
+                continue;
+            }
+            if (auto* raw = it->exchange(nullptr)) {
+                auto conn = std::move(raw->parked_self_);
+                if (usable(*conn)) {
+                    return conn;
+                }
+                // Closed while parked; its slot in the pool is free again
+                parked_--;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool BackendPool::usable(const PooledConnection& conn) const {
+    if (!conn.is_valid()) {
+        spdlog::debug("Discarding invalid pooled connection to {}:{}",
+                     backend_.host, backend_.port);
+        return false;
+    }
+    if (!conn.is_alive()) {
+        util::Metrics::instance().backend_stale_connection(backend_.id, false);
+        spdlog::debug("Discarding pooled connection to {}:{} closed by the backend",
+                     backend_.host, backend_.port);
+        return false;
+    }
+    return true;
+}
+
+void BackendPool::drain_shards() {
+    for (auto& shard : shards_) {
+        for (auto& slot : shard.slots) {
+            if (auto* raw = slot.exchange(nullptr)) {
+                available_.push_front(std::move(raw->parked_self_));
+                parked_--;
+            }
+        }
+    }
+}
+
+bool BackendPool::hand_off(PooledConnection::Ptr& conn) {
+    if (waiters_.empty()) {
+        return false;
+    }
+
+    auto waiter = std::move(waiters_.front());
+    waiters_.pop_front();
+    waiting_--;
+    waiter->conn = std::move(conn);
+    waiter->served = true;
+    in_use_++;
+    waiter->cv.notify_one();
+    return true;
+}
+
+void BackendPool::prewarm() {
+    if (config_.min_idle == 0 || retired_.load()) {
+        return;
+    }
+
+    std::size_t wanted = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto idle = available_.size() + parked_.load() + warming_;
+        auto total = idle + in_use_.load();
+        auto limit = limit_.load();
+        if (idle < config_.min_idle && total < limit) {
+            wanted = std::min(config_.min_idle - idle, limit - total);
+            warming_ += wanted;
+        }
+    }
+
+    if (wanted > 0) {
+        spdlog::debug("Pre-connecting {} idle connections to {}:{}", wanted, backend_.host, backend_.port);
+    }
+    for (std::size_t i = 0; i < wanted; ++i) {
+        connect_idle();
+    }
+}
+
+void BackendPool::connect_idle() {
+    auto start = std::chrono::steady_clock::now();
+    dns_cache_->async_resolve(backend_.host, backend_.port,
+        [self = shared_from_this(), start]
+        (const boost::system::error_code& ec, std::vector<tcp::endpoint> endpoints) {
+            if (ec) {
+                self->finish_idle_connect(nullptr, ec, start);
+                return;
+            }
+
+            // The timer closes the socket, failing the connect with operation_aborted
+            auto socket = std::make_shared<tcp::socket>(self->io_context_);
+            auto timer = std::make_shared<asio::steady_timer>(self->io_context_);
+            timer->expires_at(start + self->config_.connection_timeout);
+            timer->async_wait([socket](const boost::system::error_code& timer_ec) {
+                if (!timer_ec) {
+                    boost::system::error_code close_ec;
+                    socket->close(close_ec);
+                }
+            });
+
+            asio::async_connect(*socket, endpoints,
+                [self, socket, timer, start](const boost::system::error_code& connect_ec, const tcp::endpoint&) {
+                    timer->cancel();
+                    self->finish_idle_connect(socket, connect_ec, start);
+                });
+        });
+}
+
+void BackendPool::finish_idle_connect(std::shared_ptr<tcp::socket> socket,
+                                      const boost::system::error_code& ec,
+                                      std::chrono::steady_clock::time_point start) {
+    auto& metrics = util::Metrics::instance();
+
+    if (ec || !socket || !socket->is_open()) {
+        bool timed_out = ec == asio::error::operation_aborted;
+        metrics.backend_connect_failed(backend_.id, timed_out);
+        spdlog::debug("Pre-connect to {}:{} failed: {}", backend_.host, backend_.port,
+                      timed_out ? "timed out" : ec.message());
+        std::lock_guard<std::mutex> lock(mutex_);
+        warming_--;
+        PooledConnection::Ptr none;
+        hand_off(none);
+        return;
+    }
+
+    metrics.backend_connected(backend_.id,
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+    configure_socket(*socket);
+    boost::system::error_code mode_ec;
+    socket->non_blocking(false, mode_ec);  // As create_connection() leaves it
+    auto conn = std::make_shared<PooledConnection>(std::move(*socket), backend_);
+    total_created_++;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    warming_--;
+    if (hand_off(conn) || retired_.load()) {
+        return;
+    }
+    // Behind the recently used connections, which checkouts take first
+    available_.push_back(std::move(conn));
+    spdlog::debug("Pre-connected idle connection to {}:{} (available={})",
+                  backend_.host, backend_.port, available_.size());
+}
+
+void BackendPool::configure_socket(tcp::socket& socket) const {
+    boost::system::error_code ec;
+    socket.set_option(tcp::no_delay(true), ec);  // Disable Nagle's algorithm
+
+    if (config_.enable_keep_alive) {
+        socket.set_option(asio::socket_base::keep_alive(true), ec);
     }
 }
 
 void BackendPool::cleanup_idle() {
     std::lock_guard<std::mutex> lock(mutex_);
+    drain_shards();
 
+    // Connections nearer the front were used more recently; the first
+    // min_idle valid ones stay however long they have been idle
     std::size_t removed = 0;
+    std::size_t kept = 0;
     auto it = available_.begin();
     while (it != available_.end()) {
-        if ((*it)->is_idle(config_.idle_timeout) || !(*it)->is_valid()) {
+        bool valid = (*it)->is_valid();
+        if (!valid || (kept >= config_.min_idle && (*it)->is_idle(config_.idle_timeout))) {
             it = available_.erase(it);
             removed++;
         } else {
+            ++kept;
             ++it;
         }
     }
@@ -203,15 +660,87 @@ void BackendPool::cleanup_idle() {
     }
 }
 
+void BackendPool::resize(std::chrono::steady_clock::duration elapsed) {
+    auto seconds = std::chrono::duration<double>(elapsed).count();
+    if (seconds <= 0.0) {
+        return;
+    }
+
+    auto checkouts = checkouts_.exchange(0);
+    auto returns = returns_.exchange(0);
+    auto hold_us = hold_us_.exchange(0);
+    std::size_t peak = peak_in_use_.exchange(in_use_.load());
+
+    // Little's law: connections in use = checkout rate x time each is held
+    if (returns > 0) {
+        hold_seconds_ = static_cast<double>(hold_us) / 1e6 / static_cast<double>(returns);
+    }
+    double concurrency = static_cast<double>(checkouts) / seconds * hold_seconds_;
+    concurrency_ = concurrency >= concurrency_
+        ? concurrency
+        : concurrency_ + kShrinkSmoothing * (concurrency - concurrency_);
+
+    auto target = std::max(static_cast<std::size_t>(std::ceil(concurrency_ * kSizeHeadroom)), peak);
+    if (config_.adaptive_size) {
+        target = std::clamp(target, config_.min_size, config_.max_size);
+    }
+    target_.store(target);
+
+    std::size_t old_limit;
+    std::size_t limit;
+    std::size_t open;
+    std::size_t closed = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        old_limit = limit = limit_.load();
+        open = available_.size() + parked_.load() + in_use_.load() + warming_;
+
+        if (config_.adaptive_size && target != limit) {
+            limit = target > limit ? target : std::max(target, limit - std::max<std::size_t>(1, limit / 4));
+            limit_.store(limit);
+
+            // Slots opened by growth go to waiting checkouts
+            while (open < limit && !waiters_.empty()) {
+                PooledConnection::Ptr none;
+                hand_off(none);
+                ++open;
+            }
+
+            // Close idle connections above the limit, least recently used first
+            if (open > limit) {
+                drain_shards();
+                while (open > limit && available_.size() > config_.min_idle) {
+                    available_.pop_back();
+                    --open;
+                    ++closed;
+                }
+            }
+        }
+    }
+
+    if (limit != old_limit) {
+        spdlog::debug("Resized connection pool for {}:{} from {} to {} (target={}, {:.1f} in use on average, "
+                     "{} idle closed)", backend_.host, backend_.port, old_limit, limit, target, concurrency_, closed);
+    }
+    util::Metrics::instance().set_backend_pool_size(backend_.id, open, limit, target);
+}
+
 void BackendPool::close_all() {
     std::lock_guard<std::mutex> lock(mutex_);
+    drain_shards();
     available_.clear();
     spdlog::debug("Closed all pooled connections for {}:{}", backend_.host, backend_.port);
 }
 
+void BackendPool::retire() {
+    // Set first, so a connection returned meanwhile is closed rather than kept
+    retired_ = true;
+    close_all();
+}
+
 std::size_t BackendPool::available_count() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return available_.size();
+    return available_.size() + parked_.load();
 }
 
 std::size_t BackendPool::in_use_count() const {
@@ -222,30 +751,40 @@ std::size_t BackendPool::total_count() const {
     return available_count() + in_use_.load();
 }
 
-PooledConnection::Ptr BackendPool::create_connection() {
+std::size_t BackendPool::waiting_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiters_.size();
+}
+
+PooledConnection::Ptr BackendPool::create_connection(std::chrono::milliseconds connect_timeout) {
+    auto& metrics = util::Metrics::instance();
+    auto start = std::chrono::steady_clock::now();
+
     try {
         tcp::socket socket(io_context_);
 
-        // Resolve the backend address
-        tcp::resolver resolver(io_context_);
-        auto endpoints = resolver.resolve(backend_.host, std::to_string(backend_.port));
+        // Resolve the backend address (cached; rotated across the host's addresses).
+        // A first lookup joins the one in flight, and the connect deadline covers it
+        auto deadline = start + connect_timeout;
+        boost::system::error_code ec;
+        auto endpoints = dns_cache_->resolve(backend_.host, backend_.port, deadline, ec);
 
         // Connect with timeout
-        boost::system::error_code ec;
-        asio::connect(socket, endpoints, ec);
+        if (!ec) {
+            connect_with_deadline(socket, endpoints, deadline, ec);
+        }
 
         if (ec) {
+            bool timed_out = ec == asio::error::timed_out;
+            metrics.backend_connect_failed(backend_.id, timed_out);
             spdlog::warn("Failed to connect to backend {}:{}: {}",
                         backend_.host, backend_.port, ec.message());
             return nullptr;
         }
+        metrics.backend_connected(backend_.id,
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
 
-        // Configure socket options
-        socket.set_option(tcp::no_delay(true), ec);  // Disable Nagle's algorithm
-
-        if (config_.enable_keep_alive) {
-            socket.set_option(asio::socket_base::keep_alive(true), ec);
-        }
+        configure_socket(socket);
 
         total_created_++;
         spdlog::debug("Created new connection to {}:{} (total_created={})",
@@ -254,6 +793,7 @@ PooledConnection::Ptr BackendPool::create_connection() {
         return std::make_shared<PooledConnection>(std::move(socket), backend_);
 
     } catch (const std::exception& e) {
+        metrics.backend_connect_failed(backend_.id, false);
         spdlog::error("Exception creating connection to {}:{}: {}",
                      backend_.host, backend_.port, e.what());
         return nullptr;
@@ -265,10 +805,15 @@ PooledConnection::Ptr BackendPool::create_connection() {
 // ============================================================================
 
 ConnectionPoolManager::ConnectionPoolManager(asio::io_context& io_context,
-                                             const ConnectionPoolConfig& config)
+                                             const ConnectionPoolConfig& config,
+                                             std::shared_ptr<util::DnsCache> dns_cache)
     : io_context_(io_context)
     , cleanup_timer_(io_context)
+    , resize_timer_(io_context)
     , config_(config)
+    , dns_cache_(dns_cache ? std::move(dns_cache)
+                           : std::make_shared<util::DnsCache>(io_context, std::chrono::seconds(30)))
+    , id_(next_manager_id.fetch_add(1, std::memory_order_relaxed))
     , running_(false) {
 }
 
@@ -279,16 +824,16 @@ ConnectionPoolManager::~ConnectionPoolManager() {
 void ConnectionPoolManager::set_backends(const std::vector<config::BackendConfig>& backends) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    // Create a set of new backend keys
-    std::unordered_set<std::string> new_keys;
-    for (const auto& backend : backends) {
-        new_keys.insert(backend_key(backend));
-    }
-
     // Remove pools for backends that no longer exist
     for (auto it = pools_.begin(); it != pools_.end(); ) {
-        if (new_keys.find(it->first) == new_keys.end()) {
-            spdlog::info("Removing connection pool for backend {}", it->first);
+        auto id = it->first;
+        bool kept = std::any_of(backends.begin(), backends.end(),
+                                [id](const config::BackendConfig& backend) { return backend.id == id; });
+        if (!kept) {
+            const auto& removed = it->second->backend();
+            spdlog::info("Removing connection pool for backend {}:{}", removed.host, removed.port);
+            // Threads' copies of the pool list may keep it alive until their next checkout
+            it->second->retire();
             it = pools_.erase(it);
         } else {
             ++it;
@@ -297,27 +842,61 @@ void ConnectionPoolManager::set_backends(const std::vector<config::BackendConfig
 
     // Add pools for new backends
     for (const auto& backend : backends) {
-        std::string key = backend_key(backend);
-        if (pools_.find(key) == pools_.end()) {
+        if (pools_.find(backend.id) == pools_.end()) {
             spdlog::info("Creating connection pool for backend {}:{}", backend.host, backend.port);
-            pools_[key] = std::make_unique<BackendPool>(io_context_, backend, config_);
+            auto& pool = pools_[backend.id];
+            pool = std::make_shared<BackendPool>(io_context_, backend, config_, dns_cache_);
+            dns_cache_->prefetch(backend.host);
+            pool->prewarm();
         }
     }
+
+    generation_.fetch_add(1, std::memory_order_release);
+}
+
+const std::vector<std::shared_ptr<BackendPool>>& ConnectionPoolManager::thread_pools() {
+    auto& copy = thread_pools_copy;
+    auto generation = generation_.load(std::memory_order_acquire);
+    if (copy.manager != id_ || copy.generation != generation) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        copy.pools.clear();
+        for (const auto& [id, pool] : pools_) {
+            auto slot = config::BackendRegistry::slot(id);
+            if (copy.pools.size() <= slot) {
+                copy.pools.resize(slot + 1);
+            }
+            copy.pools[slot] = pool;
+        }
+        copy.manager = id_;
+        copy.generation = generation_.load(std::memory_order_relaxed);
+    }
+    return copy.pools;
 }
 
 std::optional<ConnectionGuard> ConnectionPoolManager::get_connection(
     const config::BackendConfig& backend) {
-    std::string key = backend_key(backend);
+    return get_connection(backend, config_.connection_timeout);
+}
 
-    std::lock_guard<std::mutex> lock(mutex_);
+std::optional<ConnectionGuard> ConnectionPoolManager::get_connection(
+    const config::BackendConfig& backend,
+    std::chrono::milliseconds connect_timeout,
+    bool fresh) {
+    // The thread's copy keeps the pool alive for the call
+    const auto& pools = thread_pools();
+    auto slot = config::BackendRegistry::slot(backend.id);
+    BackendPool* pool = slot < pools.size() ? pools[slot].get() : nullptr;
+    if (pool && pool->backend().id != backend.id) {
+        pool = nullptr;   // The slot went to another backend since this one was selected
+    }
 
-    auto it = pools_.find(key);
-    if (it == pools_.end()) {
+    if (!pool) {
         spdlog::warn("No connection pool for backend {}:{}", backend.host, backend.port);
         return std::nullopt;
     }
 
-    return it->second->get_connection();
+    // Waiting and connecting may take up to connect_timeout; other backends are not held up
+    return pool->get_connection(connect_timeout, fresh);
 }
 
 void ConnectionPoolManager::start_cleanup() {
@@ -328,6 +907,9 @@ void ConnectionPoolManager::start_cleanup() {
     spdlog::info("Starting connection pool cleanup timer (interval={}s)",
                 config_.cleanup_interval.count());
     schedule_cleanup();
+
+    last_resize_ = std::chrono::steady_clock::now();
+    schedule_resize();
 }
 
 void ConnectionPoolManager::stop_cleanup() {
@@ -336,6 +918,7 @@ void ConnectionPoolManager::stop_cleanup() {
     }
 
     cleanup_timer_.cancel();
+    resize_timer_.cancel();
     spdlog::info("Stopped connection pool cleanup timer");
 }
 
@@ -356,21 +939,62 @@ void ConnectionPoolManager::schedule_cleanup() {
     });
 }
 
+void ConnectionPoolManager::schedule_resize() {
+    if (!running_) return;
+
+    auto self = shared_from_this();
+    resize_timer_.expires_after(config_.resize_interval);
+    resize_timer_.async_wait([self](const boost::system::error_code& ec) {
+        if (ec) {
+            if (ec != asio::error::operation_aborted) {
+                spdlog::error("Resize timer error: {}", ec.message());
+            }
+            return;
+        }
+        self->do_resize();
+        self->schedule_resize();
+    });
+}
+
+void ConnectionPoolManager::do_resize() {
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = now - last_resize_;
+    last_resize_ = now;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [id, pool] : pools_) {
+        pool->resize(elapsed);
+    }
+}
+
 void ConnectionPoolManager::do_cleanup() {
     std::lock_guard<std::mutex> lock(mutex_);
 
     for (auto& [key, pool] : pools_) {
         pool->cleanup_idle();
+        pool->prewarm();  // Replace connections found closed
+    }
+}
+
+void ConnectionPoolManager::prewarm(const config::BackendConfig& backend) {
+    std::shared_ptr<BackendPool> pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pools_.find(backend.id);
+        if (it != pools_.end()) {
+            pool = it->second;
+        }
+    }
+    if (pool) {
+        pool->prewarm();
     }
 }
 
 std::optional<ConnectionPoolManager::PoolStats> ConnectionPoolManager::get_pool_stats(
     const config::BackendConfig& backend) const {
-    std::string key = backend_key(backend);
-
     std::lock_guard<std::mutex> lock(mutex_);
 
-    auto it = pools_.find(key);
+    auto it = pools_.find(backend.id);
     if (it == pools_.end()) {
         return std::nullopt;
     }
@@ -394,8 +1018,4 @@ ConnectionPoolManager::PoolStats ConnectionPoolManager::get_total_stats() const
     return total;
 }
 
-std::string ConnectionPoolManager::backend_key(const config::BackendConfig& backend) {
-    return backend.host + ":" + std::to_string(backend.port);
-}
-
 } // namespace ntonix::proxy
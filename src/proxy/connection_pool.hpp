@@ -7,19 +7,23 @@
 #define NTONIX_PROXY_CONNECTION_POOL_HPP
 
 #include "config/config.hpp"
+#include "util/dns_cache.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/beast/core.hpp>
 #include <spdlog/spdlog.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace ntonix::proxy {
 
@@ -31,9 +35,16 @@ using tcp = asio::ip::tcp;
  * Configuration for connection pool
  */
 struct ConnectionPoolConfig {
-    std::size_t pool_size_per_backend{10};              // Max connections per backend
+    std::size_t pool_size_per_backend{10};              // Max connections per backend (initial size if adaptive)
+    bool adaptive_size{false};                          // Resize each pool from its observed concurrency
+    std::size_t min_size{2};                            // Adaptive size bounds per backend
+    std::size_t max_size{64};
+    std::chrono::milliseconds resize_interval{1000};    // Interval for re-estimating pool sizes
+    std::size_t min_idle{0};                            // Idle connections kept open (and pre-connected) per backend
+    std::size_t max_waiters{64};                        // Checkouts queued while the pool is exhausted (0 = fail at once)
+    std::chrono::milliseconds max_wait{1000};           // Longest a queued checkout waits for a connection
     std::chrono::seconds idle_timeout{60};              // Close idle connections after this time
-    std::chrono::seconds connection_timeout{5};         // Timeout for establishing connection
+    std::chrono::milliseconds connection_timeout{5000}; // Upper bound for establishing a connection
     std::chrono::seconds cleanup_interval{30};          // Interval for idle connection cleanup
     bool enable_keep_alive{true};                       // Enable TCP keep-alive
 };
@@ -70,6 +81,12 @@ public:
      */
     bool is_valid() const;
 
+    /**
+     * Check that the backend has not closed or reset the connection while
+     * it sat idle (non-blocking MSG_PEEK; skipped if used very recently)
+     */
+    bool is_alive() const;
+
     /**
      * Check if connection has been idle too long
      */
@@ -95,12 +112,22 @@ public:
      */
     std::size_t usage_count() const { return usage_count_; }
 
+    /**
+     * True if the current checkout took an idle connection rather than
+     * connecting (so the backend may have closed it in the meantime)
+     */
+    bool reused() const { return reused_; }
+
 private:
+    friend class BackendPool;
+
     tcp::socket socket_;
     config::BackendConfig backend_;
     std::chrono::steady_clock::time_point last_used_;
     std::size_t usage_count_{0};
     bool in_use_{false};
+    bool reused_{false};
+    Ptr parked_self_;   // Owns the connection while a pool shard holds it by raw pointer
 };
 
 /**
@@ -151,12 +178,27 @@ private:
 
 /**
  * Connection pool for a single backend
+ *
+ * Idle connections are returned to a small per-thread shard of atomic
+ * slots, and a checkout on the same thread takes them back without
+ * locking. Full shards overflow into a shared, locked deque. Checkouts that
+ * miss both steal from other threads' shards before connecting or waiting.
+ *
+ * Checked-out connections hold the pool alive through their release
+ * function, so a pool dropped by set_backends() outlives its last guard.
+ * Such a pool is retired first, so it holds no idle connections while
+ * threads' copies of the pool list still refer to it.
  */
-class BackendPool {
+class BackendPool : public std::enable_shared_from_this<BackendPool> {
 public:
+    static constexpr std::size_t kShards = 16;          // Threads beyond this share shards
+    static constexpr std::size_t kSlotsPerShard = 4;    // Idle connections per shard
+
+
     BackendPool(asio::io_context& io_context,
                 const config::BackendConfig& backend,
-                const ConnectionPoolConfig& config);
+                const ConnectionPoolConfig& config,
+                std::shared_ptr<util::DnsCache> dns_cache);
     ~BackendPool();
 
     // Non-copyable
@@ -164,10 +206,18 @@ public:
     BackendPool& operator=(const BackendPool&) = delete;
 
     /**
-     * Get a connection from the pool (synchronous, blocks until available)
-     * Returns nullopt if cannot get connection within timeout
+     * Get a connection from the pool, connecting a new one if none is idle
+     * If the pool is full, waits in FIFO order for a returned connection (or
+     * a freed slot) for up to max_wait. Returns nullopt if the wait queue is
+     * full, the wait times out, or the connect fails or times out.
+     * The pool's slot is reserved first, so no lock is held while connecting.
+     * @param connect_timeout Limit for waiting plus establishing a new connection
+     *                        (the connect is capped by ConnectionPoolConfig::connection_timeout)
+     * @param fresh Connect a new connection rather than reuse an idle one
+     *              (closing an idle one if the pool is full)
      */
-    std::optional<ConnectionGuard> get_connection();
+    std::optional<ConnectionGuard> get_connection(std::chrono::milliseconds connect_timeout,
+                                                  bool fresh = false);
 
     /**
      * Return a connection to the pool
@@ -177,15 +227,39 @@ public:
     void return_connection(PooledConnection::Ptr conn, bool reusable);
 
     /**
-     * Clean up idle connections
+     * Connect in the background until min_idle connections are idle
+     * (without exceeding pool_size_per_backend)
+     */
+    void prewarm();
+
+    /**
+     * Clean up idle connections, keeping the most recently used min_idle
      */
     void cleanup_idle();
 
+    /**
+     * Re-estimate the connections this backend needs from the checkouts
+     * since the last call, by Little's law: checkout rate times mean hold
+     * time, smoothed, plus headroom, and at least the peak in use. With
+     * adaptive_size the limit follows it within [min_size, max_size],
+     * shrinking by at most a quarter per call; idle connections above the
+     * limit are closed. (A checkout that would queue grows the limit at
+     * once instead.)
+     * @param elapsed Time since the previous call
+     */
+    void resize(std::chrono::steady_clock::duration elapsed);
+
     /**
      * Close all connections and reset pool
      */
     void close_all();
 
+    /**
+     * Close idle connections and close returned ones from now on
+     * (the backend was removed)
+     */
+    void retire();
+
     /**
      * Get current number of available connections in pool
      */
@@ -201,6 +275,21 @@ public:
      */
     std::size_t total_count() const;
 
+    /**
+     * Get number of checkouts waiting for a connection
+     */
+    std::size_t waiting_count() const;
+
+    /**
+     * Get the most connections the pool opens at once
+     */
+    std::size_t size_limit() const { return limit_.load(); }
+
+    /**
+     * Get the size estimated by the last resize()
+     */
+    std::size_t size_target() const { return target_.load(); }
+
     /**
      * Get backend configuration
      */
@@ -208,18 +297,104 @@ public:
 
 private:
     /**
-     * Create a new connection to the backend
+     * A checkout waiting for the pool to free up
+     */
+    struct Waiter {
+        std::condition_variable cv;
+        PooledConnection::Ptr conn;   // Connection handed over (null: a slot to connect in)
+        bool served{false};
+    };
+
+    /**
+     * Open and still alive; counts connections the backend closed (mutex_ held or not)
+     */
+    bool usable(const PooledConnection& conn) const;
+
+    /**
+     * Idle connections parked by (mostly) one thread
+     */
+    struct alignas(64) Shard {
+        std::array<std::atomic<PooledConnection*>, kSlotsPerShard> slots{};
+    };
+
+    /**
+     * Shard of the calling thread
+     */
+    static std::size_t shard_index();
+
+    /**
+     * Park an idle connection in the calling thread's shard, without locking
+     * @return false if the shard is full (conn is left alone)
+     */
+    bool park(PooledConnection::Ptr& conn);
+
+    /**
+     * Take a parked connection: from the calling thread's shard, or from
+     * any shard (own first) if steal is set. Not yet counted in use.
+     */
+    PooledConnection::Ptr unpark(bool steal);
+
+    /**
+     * Move all parked connections to available_ (mutex_ held)
+     */
+    void drain_shards();
+
+    /**
+     * Give a freed connection, or a freed slot if conn is null, to the
+     * longest waiting checkout and count it in use (mutex_ held)
+     * @return false if nobody is waiting (conn is left alone)
+     */
+    bool hand_off(PooledConnection::Ptr& conn);
+
+    /**
+     * Create a new connection to the backend and record its connect latency
+     * (blocks the calling thread for at most connect_timeout)
+     * @param connect_timeout Give up resolving and connecting after this long
+     */
+    PooledConnection::Ptr create_connection(std::chrono::milliseconds connect_timeout);
+
+    /**
+     * Start one asynchronous connect for prewarm() (slot already counted in warming_)
+     */
+    void connect_idle();
+
+    /**
+     * Pool a connection made by connect_idle(), or count its failure
+     */
+    void finish_idle_connect(std::shared_ptr<tcp::socket> socket,
+                             const boost::system::error_code& ec,
+                             std::chrono::steady_clock::time_point start);
+
+    /**
+     * Socket options of every backend connection
      */
-    PooledConnection::Ptr create_connection();
+    void configure_socket(tcp::socket& socket) const;
 
     asio::io_context& io_context_;
     config::BackendConfig backend_;
     ConnectionPoolConfig config_;
+    std::shared_ptr<util::DnsCache> dns_cache_;
 
     mutable std::mutex mutex_;
     std::deque<PooledConnection::Ptr> available_;  // Available connections
-    std::atomic<std::size_t> in_use_{0};           // Number of connections currently in use
+    std::size_t warming_{0};                       // Background connects in flight
+    std::deque<std::shared_ptr<Waiter>> waiters_;  // Checkouts waiting, oldest first
+    std::array<Shard, kShards> shards_;            // Idle connections parked per thread
+    std::atomic<std::size_t> parked_{0};           // Connections in shards_
+    std::atomic<std::size_t> waiting_{0};          // waiters_.size(), for lock-free returns
+    std::atomic<std::size_t> in_use_{0};           // Connections in use or being connected
     std::atomic<std::size_t> total_created_{0};    // Total connections ever created
+    std::atomic<bool> retired_{false};             // Backend removed: keep no idle connections
+
+    // Sizing (see resize()); counters cover the time since the last resize
+    std::atomic<std::size_t> limit_;               // Most connections open at once
+    std::atomic<std::size_t> target_{0};           // Last estimate of the connections needed
+    std::atomic<std::uint64_t> checkouts_{0};
+    std::atomic<std::uint64_t> returns_{0};
+    std::atomic<std::uint64_t> hold_us_{0};        // Total time returned connections were checked out
+    std::atomic<std::size_t> peak_in_use_{0};
+    double concurrency_{0.0};                      // Smoothed checkout rate x hold time (resize() only)
+    double hold_seconds_{0.0};                     // Last mean hold time (resize() only)
 };
 
 /**
@@ -227,8 +402,15 @@ private:
  *
  * Features:
  * - Maintains a pool of persistent connections per backend
- * - Thread-safe connection checkout/checkin
- * - Automatic cleanup of idle/stale connections
+ * - Thread-safe connection checkout/checkin; connects happen outside all locks,
+ *   so an unreachable backend delays only the requests sent to it
+ * - Lock-free pool lookup and, for connections reused on the same thread,
+ *   lock-free checkout and return
+ * - Bounded FIFO wait for a connection when a backend's pool is exhausted
+ * - Automatic cleanup of idle/stale connections, keeping min_idle per backend
+ * - Background pre-connecting up to min_idle when a pool is created or refilled
+ * - Per-backend size estimated from observed concurrency, and followed if adaptive_size
+ * - Backend addresses from a DnsCache, prefetched when a backend is added
  * - RAII-based connection lifecycle via ConnectionGuard
  */
 class ConnectionPoolManager : public std::enable_shared_from_this<ConnectionPoolManager> {
@@ -239,9 +421,11 @@ public:
      * Create a connection pool manager
      * @param io_context Asio io_context for async operations
      * @param config Pool configuration
+     * @param dns_cache Resolver cache shared with other components (a private one if null)
      */
     ConnectionPoolManager(asio::io_context& io_context,
-                          const ConnectionPoolConfig& config = {});
+                          const ConnectionPoolConfig& config = {},
+                          std::shared_ptr<util::DnsCache> dns_cache = nullptr);
     ~ConnectionPoolManager();
 
     // Non-copyable
@@ -262,12 +446,27 @@ public:
     std::optional<ConnectionGuard> get_connection(const config::BackendConfig& backend);
 
     /**
-     * Start the cleanup timer for idle connections
+     * Get a connection to a specific backend with an explicit connect timeout
+     * (e.g. the time left before the request's deadline)
+     * @param fresh Connect a new connection rather than reuse an idle one
+     */
+    std::optional<ConnectionGuard> get_connection(const config::BackendConfig& backend,
+                                                  std::chrono::milliseconds connect_timeout,
+                                                  bool fresh = false);
+
+    /**
+     * Pre-connect a backend's pool up to min_idle in the background
+     * (e.g. when the backend becomes healthy again)
+     */
+    void prewarm(const config::BackendConfig& backend);
+
+    /**
+     * Start the timers for idle connection cleanup and pool sizing
      */
     void start_cleanup();
 
     /**
-     * Stop the cleanup timer
+     * Stop the cleanup and sizing timers
      */
     void stop_cleanup();
 
@@ -303,16 +502,32 @@ private:
     void do_cleanup();
 
     /**
-     * Generate unique key for backend
+     * Schedule the next pool size estimate
+     */
+    void schedule_resize();
+
+    /**
+     * Re-estimate the size of all pools
+     */
+    void do_resize();
+
+    /**
+     * The calling thread's copy of the pools, refreshed (under mutex_)
+     * only after set_backends() has changed them
      */
-    static std::string backend_key(const config::BackendConfig& backend);
+    const std::vector<std::shared_ptr<BackendPool>>& thread_pools();
 
     asio::io_context& io_context_;
     asio::steady_timer cleanup_timer_;
+    asio::steady_timer resize_timer_;
+    std::chrono::steady_clock::time_point last_resize_;
     ConnectionPoolConfig config_;
+    std::shared_ptr<util::DnsCache> dns_cache_;
 
     mutable std::mutex mutex_;
-    std::unordered_map<std::string, std::unique_ptr<BackendPool>> pools_;
+    std::unordered_map<config::BackendId, std::shared_ptr<BackendPool>> pools_;
+    const std::uint64_t id_;                       // Owner tag of the threads' pool copies
+    std::atomic<std::uint64_t> generation_{0};     // Bumped whenever pools_ changes
 
     std::atomic<bool> running_{false};
 };
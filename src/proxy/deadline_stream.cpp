@@ -0,0 +1,218 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Deadline Stream implementation
+ */
+
+#include "proxy/deadline_stream.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+
+namespace ntonix::proxy {
+
+// ============================================================================
+// RequestDeadline Implementation
+// ============================================================================
+
+RequestDeadline::RequestDeadline(const TimeoutPolicy& policy, clock::time_point start)
+    : policy_(policy)
+    , total_(start + policy.total) {
+}
+
+RequestDeadline::clock::time_point RequestDeadline::phase(std::chrono::milliseconds budget) const {
+    return std::min(clock::now() + budget, total_);
+}
+
+std::chrono::milliseconds RequestDeadline::remaining() const {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(total_ - clock::now());
+    return std::max(left, std::chrono::milliseconds{0});
+}
+
+// ============================================================================
+// Socket readiness
+// ============================================================================
+
+namespace {
+
+// Peer shut down its sending side (Linux); elsewhere detected by peeking
+#ifdef POLLRDHUP
+constexpr short kHangupEvents = POLLRDHUP;
+#else
+constexpr short kHangupEvents = 0;
+#endif
+
+// Longest X-Request-Timeout taken literally (callers cap it further)
+constexpr double kMaxRequestTimeoutMs = 24.0 * 60 * 60 * 1000;
+
+/**
+ * Did the watched peer close its side of the connection?
+ * Pending request bytes (pipelining) are not a disconnect.
+ */
+bool peer_disconnected(int fd) {
+    char byte;
+    auto n = ::recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) {
+        return true;
+    }
+    return n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+}
+
+/**
+ * Events to poll for on a watched socket (POLLHUP/POLLERR are always reported)
+ */
+short watch_events(bool half_close) {
+    if (!half_close) {
+        return 0;
+    }
+    return kHangupEvents == 0 ? POLLIN : kHangupEvents;
+}
+
+/**
+ * Do poll() events on a watched socket mean its peer is gone?
+ * A hang-up is final even if unread bytes (e.g. a TLS close_notify) are
+ * still queued; without POLLRDHUP we have to peek.
+ */
+bool hung_up(int fd, short revents, bool half_close) {
+    if ((revents & (POLLHUP | POLLERR)) != 0) {
+        return true;
+    }
+    return half_close && ((revents & kHangupEvents) != 0 || peer_disconnected(fd));
+}
+
+} // namespace
+
+WaitStatus wait_socket(int fd, bool writable,
+                       std::chrono::steady_clock::time_point deadline,
+                       int watch_fd,
+                       bool watch_half_close) {
+    pollfd fds[2];
+    fds[0].fd = fd;
+    fds[0].events = writable ? POLLOUT : POLLIN;
+    nfds_t count = 1;
+
+    if (watch_fd >= 0) {
+        fds[1].fd = watch_fd;
+        fds[1].events = watch_events(watch_half_close);
+        count = 2;
+    }
+
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return WaitStatus::timeout;
+        }
+
+        // Round up so we never wake just before the deadline and spin
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+        int timeout_ms = static_cast<int>(std::min<std::int64_t>(left, 60'000));
+
+        fds[0].revents = 0;
+        fds[1].revents = 0;
+        int rc = ::poll(fds, count, timeout_ms);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return WaitStatus::error;
+        }
+        if (rc == 0) {
+            continue;  // Re-check the deadline
+        }
+
+        if (count == 2 && fds[1].revents != 0) {
+            if (hung_up(watch_fd, fds[1].revents, watch_half_close)) {
+                return WaitStatus::cancelled;
+            }
+            // Peer sent data (e.g. a pipelined request): stop watching it
+            count = 1;
+        }
+
+        if (fds[0].revents != 0) {
+            // Errors and hang-ups surface from the following read/write
+            return WaitStatus::ready;
+        }
+    }
+}
+
+bool peer_hung_up(int fd, bool half_close) {
+    pollfd watch{};
+    watch.fd = fd;
+    watch.events = watch_events(half_close);
+    return ::poll(&watch, 1, 0) > 0 && hung_up(fd, watch.revents, half_close);
+}
+
+std::optional<std::chrono::milliseconds> parse_request_timeout(std::string_view value) {
+    while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+    while (!value.empty() && value.back() == ' ') value.remove_suffix(1);
+
+    double scale = 1000.0;  // Seconds by default
+    if (value.ends_with("ms")) {
+        scale = 1.0;
+        value.remove_suffix(2);
+    } else if (value.ends_with("s")) {
+        value.remove_suffix(1);
+    }
+
+    // from_chars also accepts "inf", "nan" and huge exponents: clamp before converting
+    double number = 0.0;
+    auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+    if (ec != std::errc{} || end != value.data() + value.size() || !std::isfinite(number)) {
+        return std::nullopt;
+    }
+
+    double ms = std::min(number * scale, kMaxRequestTimeoutMs);
+    if (!(ms >= 1.0)) {
+        return std::nullopt;   // Not positive, or rounds down to 0ms
+    }
+    return std::chrono::milliseconds{static_cast<std::int64_t>(ms)};
+}
+
+// ============================================================================
+// DeadlineStream Implementation
+// ============================================================================
+
+DeadlineStream::DeadlineStream(tcp::socket& socket)
+    : socket_(socket) {
+    beast::error_code ec;
+    socket_.non_blocking(true, ec);
+}
+
+DeadlineStream::~DeadlineStream() {
+    beast::error_code ec;
+    socket_.non_blocking(false, ec);
+}
+
+bool DeadlineStream::wait(bool writable, beast::error_code& ec) {
+    while (true) {
+        switch (wait_socket(socket_.native_handle(), writable, deadline_, watch_.fd, watch_.half_close)) {
+        case WaitStatus::ready:
+            return true;
+        case WaitStatus::timeout:
+            timed_out_ = true;
+            ec = beast::error::timeout;
+            return false;
+        case WaitStatus::cancelled:
+            if (watch_.keep_result && watch_.keep_result()) {
+                // Someone else still wants the response: finish unwatched
+                spdlog::debug("DeadlineStream: Client disconnected, finishing request for other consumers");
+                watch_.fd = -1;
+                continue;
+            }
+            cancelled_ = true;
+            ec = asio::error::operation_aborted;
+            return false;
+        case WaitStatus::error:
+            ec = beast::error_code(errno, boost::system::system_category());
+            return false;
+        }
+        return false;
+    }
+}
+
+} // namespace ntonix::proxy
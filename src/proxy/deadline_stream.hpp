@@ -0,0 +1,234 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Deadline Stream - Blocking backend I/O bounded by per-request deadlines
+ *
+ * Request handlers run synchronously on the I/O threads, and blocking asio
+ * operations on a plain socket cannot time out. DeadlineStream wraps a
+ * backend socket in non-blocking mode and waits for readiness with poll(),
+ * so every read and write gives up once the current deadline has passed,
+ * or, optionally, once the client the exchange is for has disconnected.
+ * It satisfies Beast's SyncReadStream/SyncWriteStream, so it can be passed
+ * to http::read / http::write directly.
+ */
+
+#ifndef NTONIX_PROXY_DEADLINE_STREAM_HPP
+#define NTONIX_PROXY_DEADLINE_STREAM_HPP
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+
+namespace ntonix::proxy {
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+using tcp = asio::ip::tcp;
+
+/**
+ * Per-phase timeouts of a backend exchange
+ */
+struct TimeoutPolicy {
+    std::chrono::milliseconds connect{5000};      // Establishing the backend connection
+    std::chrono::milliseconds send{10000};        // Writing the request
+    std::chrono::milliseconds first_byte{60000};  // Waiting for the response header
+    std::chrono::milliseconds total{120000};      // Whole exchange, end to end
+};
+
+/**
+ * End-to-end deadline of one request
+ *
+ * Each phase gets its own budget counted from when the phase starts, but no
+ * phase may run past the total deadline. The deadline is created once per
+ * client request, so retries on other backends share the same budget.
+ */
+class RequestDeadline {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit RequestDeadline(const TimeoutPolicy& policy = {},
+                             clock::time_point start = clock::now());
+
+    /**
+     * Deadline for a phase starting now
+     */
+    clock::time_point phase(std::chrono::milliseconds budget) const;
+
+    clock::time_point total() const { return total_; }
+    const TimeoutPolicy& policy() const { return policy_; }
+
+    bool expired() const { return clock::now() >= total_; }
+
+    /**
+     * Time left before the total deadline (zero once expired)
+     */
+    std::chrono::milliseconds remaining() const;
+
+private:
+    TimeoutPolicy policy_;
+    clock::time_point total_;
+};
+
+/**
+ * Outcome of waiting for socket readiness
+ */
+enum class WaitStatus {
+    ready,          // Socket is ready for the requested operation
+    timeout,        // Deadline passed first
+    cancelled,      // Watched peer socket disconnected
+    error           // poll() failed
+};
+
+/**
+ * Wait until a socket is readable or writable, or the deadline passes
+ *
+ * The watched socket counts as disconnected on POLLHUP/POLLERR (reset or
+ * fully closed). A peer that only shut down its sending side may still be
+ * reading, so its half-close cancels only when watch_half_close is set.
+ *
+ * @param fd Native socket handle
+ * @param writable Wait for writability instead of readability
+ * @param deadline Absolute deadline
+ * @param watch_fd Optional second socket watched for disconnect (-1 = none)
+ * @param watch_half_close Treat the watched peer's half-close as a disconnect
+ */
+WaitStatus wait_socket(int fd, bool writable,
+                       std::chrono::steady_clock::time_point deadline,
+                       int watch_fd = -1,
+                       bool watch_half_close = false);
+
+/**
+ * Check, without blocking, whether the peer of a watched socket has
+ * disconnected (same rules as wait_socket's watch_fd)
+ */
+bool peer_hung_up(int fd, bool half_close = false);
+
+/**
+ * Parse an X-Request-Timeout header value
+ * Accepts a number of seconds ("30", "2.5"), or an explicit unit ("1500ms", "30s").
+ * Values beyond a day are clamped to a day.
+ * @return The timeout, or nullopt if the value is malformed, not finite or under 1ms
+ */
+std::optional<std::chrono::milliseconds> parse_request_timeout(std::string_view value);
+
+/**
+ * Client connection whose disconnect abandons a backend exchange
+ *
+ * Without half_close, a client that closes its socket normally (FIN) is
+ * not noticed until a write to it fails, which for a non-streaming request
+ * is after the backend has answered: only a reset cancels the backend work
+ * early. Streaming relays treat a half-close as a disconnect by default.
+ */
+struct DisconnectWatch {
+    int fd{-1};                          // Client socket to watch (-1 = don't watch)
+    bool half_close{false};              // Client shutting down its sending side counts as gone
+    std::function<bool()> keep_result;   // Asked on disconnect: finish anyway (e.g. for the cache)?
+};
+
+/**
+ * Socket adapter whose reads and writes fail with beast::error::timeout
+ * once the current deadline has passed
+ *
+ * The socket is switched to non-blocking mode for the adapter's lifetime
+ * and restored to blocking mode on destruction.
+ */
+class DeadlineStream {
+public:
+    using executor_type = tcp::socket::executor_type;
+
+    explicit DeadlineStream(tcp::socket& socket);
+    ~DeadlineStream();
+
+    // Non-copyable
+    DeadlineStream(const DeadlineStream&) = delete;
+    DeadlineStream& operator=(const DeadlineStream&) = delete;
+
+    /**
+     * Set the deadline for subsequent operations
+     */
+    void expires_at(std::chrono::steady_clock::time_point deadline) { deadline_ = deadline; }
+
+    /**
+     * Abandon pending operations with asio::error::operation_aborted if the
+     * watched client disconnects (unless watch.keep_result says otherwise)
+     */
+    void cancel_on_disconnect(DisconnectWatch watch) { watch_ = std::move(watch); }
+
+    /**
+     * True once an operation failed because the deadline passed
+     */
+    bool timed_out() const { return timed_out_; }
+
+    /**
+     * True once an operation was abandoned because the client disconnected
+     */
+    bool cancelled() const { return cancelled_; }
+
+    executor_type get_executor() { return socket_.get_executor(); }
+    tcp::socket& socket() { return socket_; }
+
+    // SyncReadStream
+    template<class MutableBufferSequence>
+    std::size_t read_some(const MutableBufferSequence& buffers, beast::error_code& ec) {
+        while (wait(false, ec)) {
+            std::size_t n = socket_.read_some(buffers, ec);
+            if (ec != asio::error::would_block && ec != asio::error::try_again) {
+                return n;
+            }
+        }
+        return 0;
+    }
+
+    template<class MutableBufferSequence>
+    std::size_t read_some(const MutableBufferSequence& buffers) {
+        beast::error_code ec;
+        std::size_t n = read_some(buffers, ec);
+        if (ec) {
+            throw beast::system_error{ec};
+        }
+        return n;
+    }
+
+    // SyncWriteStream
+    template<class ConstBufferSequence>
+    std::size_t write_some(const ConstBufferSequence& buffers, beast::error_code& ec) {
+        while (wait(true, ec)) {
+            std::size_t n = socket_.write_some(buffers, ec);
+            if (ec != asio::error::would_block && ec != asio::error::try_again) {
+                return n;
+            }
+        }
+        return 0;
+    }
+
+    template<class ConstBufferSequence>
+    std::size_t write_some(const ConstBufferSequence& buffers) {
+        beast::error_code ec;
+        std::size_t n = write_some(buffers, ec);
+        if (ec) {
+            throw beast::system_error{ec};
+        }
+        return n;
+    }
+
+private:
+    /**
+     * Wait for readiness; sets ec and returns false on timeout or error
+     */
+    bool wait(bool writable, beast::error_code& ec);
+
+    tcp::socket& socket_;
+    std::chrono::steady_clock::time_point deadline_{std::chrono::steady_clock::time_point::max()};
+    DisconnectWatch watch_;
+    bool timed_out_{false};
+    bool cancelled_{false};
+};
+
+} // namespace ntonix::proxy
+
+#endif // NTONIX_PROXY_DEADLINE_STREAM_HPP
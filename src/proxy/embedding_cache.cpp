@@ -0,0 +1,278 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Embedding Cache implementation
+ */
+
+#include "proxy/embedding_cache.hpp"
+#include "util/metrics.hpp"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+
+namespace ntonix::proxy {
+
+namespace http = boost::beast::http;
+
+namespace {
+
+constexpr std::size_t kHeaderBytes = 2 * sizeof(std::uint32_t);
+
+bool is_token_array(const nlohmann::json& value) {
+    return value.is_array() && !value.empty() &&
+           std::all_of(value.begin(), value.end(), [](const auto& v) { return v.is_number_integer(); });
+}
+
+/**
+ * Split an "input" field into individual inputs (strings or token arrays)
+ */
+std::optional<std::vector<nlohmann::json>> split_inputs(const nlohmann::json& input) {
+    std::vector<nlohmann::json> inputs;
+    if (input.is_string() || is_token_array(input)) {
+        inputs.push_back(input);
+        return inputs;
+    }
+    if (!input.is_array() || input.empty()) {
+        return std::nullopt;
+    }
+    for (const auto& item : input) {
+        if (!item.is_string() && !is_token_array(item)) {
+            return std::nullopt;
+        }
+        inputs.push_back(item);
+    }
+    return inputs;
+}
+
+std::string base64_encode(const unsigned char* data, std::size_t size) {
+    static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((size + 2) / 3 * 4);
+    for (std::size_t i = 0; i < size; i += 3) {
+        std::uint32_t chunk = static_cast<std::uint32_t>(data[i]) << 16;
+        if (i + 1 < size) chunk |= static_cast<std::uint32_t>(data[i + 1]) << 8;
+        if (i + 2 < size) chunk |= data[i + 2];
+        out += kAlphabet[(chunk >> 18) & 0x3F];
+        out += kAlphabet[(chunk >> 12) & 0x3F];
+        out += i + 1 < size ? kAlphabet[(chunk >> 6) & 0x3F] : '=';
+        out += i + 2 < size ? kAlphabet[chunk & 0x3F] : '=';
+    }
+    return out;
+}
+
+/**
+ * Append a vector as a JSON array of shortest round-trip floats, or as the
+ * base64 of its float32 bytes (the OpenAI "base64" encoding_format)
+ */
+void append_vector(std::string& out, const std::vector<float>& vector, bool base64) {
+    if (base64) {
+        out += '"';
+        out += base64_encode(reinterpret_cast<const unsigned char*>(vector.data()), vector.size() * sizeof(float));
+        out += '"';
+        return;
+    }
+
+    char buffer[32];
+    out += '[';
+    for (std::size_t i = 0; i < vector.size(); ++i) {
+        if (i > 0) {
+            out += ',';
+        }
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), vector[i]);
+        out.append(buffer, ec == std::errc{} ? end : buffer);
+    }
+    out += ']';
+}
+
+server::HttpResponse bad_gateway(const char* body) {
+    return server::HttpResponse{
+        .status = http::status::bad_gateway,
+        .content_type = "application/json",
+        .body = body
+    };
+}
+
+} // namespace
+
+std::string encode_embedding(const CachedEmbedding& embedding) {
+    auto dims = static_cast<std::uint32_t>(embedding.vector.size());
+    std::string data(kHeaderBytes + dims * sizeof(float), '\0');
+    std::memcpy(data.data(), &dims, sizeof(dims));
+    std::memcpy(data.data() + sizeof(dims), &embedding.prompt_tokens, sizeof(embedding.prompt_tokens));
+    std::memcpy(data.data() + kHeaderBytes, embedding.vector.data(), dims * sizeof(float));
+    return data;
+}
+
+std::optional<CachedEmbedding> decode_embedding(std::string_view data) {
+    if (data.size() < kHeaderBytes) {
+        return std::nullopt;
+    }
+    std::uint32_t dims = 0;
+    CachedEmbedding embedding;
+    std::memcpy(&dims, data.data(), sizeof(dims));
+    std::memcpy(&embedding.prompt_tokens, data.data() + sizeof(dims), sizeof(embedding.prompt_tokens));
+    if (data.size() != kHeaderBytes + static_cast<std::size_t>(dims) * sizeof(float)) {
+        return std::nullopt;
+    }
+    embedding.vector.resize(dims);
+    std::memcpy(embedding.vector.data(), data.data() + kHeaderBytes, dims * sizeof(float));
+    return embedding;
+}
+
+EmbeddingCache::EmbeddingCache(std::shared_ptr<cache::LruCache> cache)
+    : cache_(std::move(cache))
+{
+}
+
+std::optional<server::HttpResponse> EmbeddingCache::handle(const server::HttpRequest& request,
+                                                           const Dispatch& dispatch) {
+    auto body = nlohmann::json::parse(request.body, nullptr, false);
+    if (body.is_discarded() || !body.is_object() || !body.contains("input")) {
+        return std::nullopt;
+    }
+    auto inputs = split_inputs(body["input"]);
+    if (!inputs) {
+        return std::nullopt;
+    }
+
+    bool base64 = false;
+    if (auto format = body.find("encoding_format"); format != body.end()) {
+        if (!format->is_string() || (*format != "float" && *format != "base64")) {
+            return std::nullopt;
+        }
+        base64 = *format == "base64";
+    }
+    std::string model = body.contains("model") && body["model"].is_string() ? body["model"].get<std::string>() : "";
+
+    // The cache key covers everything that shapes the vectors
+    nlohmann::json user;
+    if (auto it = body.find("user"); it != body.end()) {
+        user = std::move(*it);
+    }
+    body.erase("input");
+    body.erase("encoding_format");
+    body.erase("user");
+    std::string params = body.dump();
+
+    auto& metrics = util::Metrics::instance();
+    auto count = inputs->size();
+    std::vector<cache::CacheKey> keys;
+    std::vector<std::optional<CachedEmbedding>> results(count);
+    std::size_t hits = 0;
+    std::vector<std::size_t> misses;                          // First occurrence of each distinct missed input
+    std::unordered_map<std::uint64_t, std::size_t> miss_of;   // Key hash -> position in misses
+    keys.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        keys.push_back(cache::generate_cache_key("POST", request.target, params + '\n' + (*inputs)[i].dump()));
+        if (auto entry = cache_->get(keys[i]); entry && entry->content_type == kEmbeddingContentType) {
+            results[i] = decode_embedding(entry->body);
+        }
+        if (results[i]) {
+            ++hits;
+            metrics.cache_hit();
+        } else {
+            metrics.cache_miss();
+            if (miss_of.try_emplace(keys[i].hash, misses.size()).second) {
+                misses.push_back(i);
+            }
+        }
+    }
+
+    if (!misses.empty()) {
+        auto miss_body = body;
+        miss_body["input"] = nlohmann::json::array();
+        for (auto i : misses) {
+            miss_body["input"].push_back((*inputs)[i]);
+        }
+        if (!user.is_null()) {
+            miss_body["user"] = user;
+        }
+
+        server::HttpRequest miss_request = request;
+        miss_request.body = miss_body.dump();
+        auto response = dispatch(miss_request);
+
+        auto status = static_cast<int>(response.status);
+        if (status < 200 || status >= 300) {
+            return response;
+        }
+
+        auto doc = nlohmann::json::parse(response.body, nullptr, false);
+        if (doc.is_discarded() || !doc.is_object() || !doc.contains("data") || !doc["data"].is_array()) {
+            return bad_gateway(R"({"error": "Invalid embeddings response from backend"})");
+        }
+        if (doc.contains("model") && doc["model"].is_string()) {
+            model = doc["model"].get<std::string>();
+        }
+
+        std::vector<std::optional<CachedEmbedding>> fresh(misses.size());
+        for (const auto& item : doc["data"]) {
+            if (!item.is_object() || !item.contains("index") || !item["index"].is_number_integer() ||
+                !item.contains("embedding") || !item["embedding"].is_array()) {
+                continue;
+            }
+            auto index = item["index"].get<std::int64_t>();
+            if (index < 0 || index >= static_cast<std::int64_t>(misses.size())) {
+                continue;
+            }
+            CachedEmbedding embedding;
+            embedding.vector.reserve(item["embedding"].size());
+            for (const auto& value : item["embedding"]) {
+                embedding.vector.push_back(value.is_number() ? value.get<float>() : 0.0f);
+            }
+            fresh[index] = std::move(embedding);
+        }
+
+        // Usage is reported for the batch; apportion it evenly across its inputs
+        std::uint64_t batch_tokens = 0;
+        if (doc.contains("usage") && doc["usage"].is_object() && doc["usage"].contains("prompt_tokens") &&
+            doc["usage"]["prompt_tokens"].is_number_unsigned()) {
+            batch_tokens = doc["usage"]["prompt_tokens"].get<std::uint64_t>();
+        }
+
+        for (std::size_t j = 0; j < misses.size(); ++j) {
+            if (!fresh[j]) {
+                return bad_gateway(R"({"error": "Embeddings response from backend is missing inputs"})");
+            }
+            fresh[j]->prompt_tokens = static_cast<std::uint32_t>(
+                batch_tokens / misses.size() + (j < batch_tokens % misses.size() ? 1 : 0));
+            cache_->put(keys[misses[j]], encode_embedding(*fresh[j]), std::string(kEmbeddingContentType));
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!results[i]) {
+                results[i] = fresh[miss_of[keys[i].hash]];
+            }
+        }
+        spdlog::debug("EmbeddingCache: {} of {} inputs forwarded", misses.size(), count);
+    }
+
+    std::uint64_t prompt_tokens = 0;
+    std::string out = R"({"object":"list","data":[)";
+    for (std::size_t i = 0; i < count; ++i) {
+        out += i > 0 ? "," : "";
+        out += R"({"object":"embedding","index":)";
+        out += std::to_string(i);
+        out += R"(,"embedding":)";
+        append_vector(out, results[i]->vector, base64);
+        out += '}';
+        prompt_tokens += results[i]->prompt_tokens;
+    }
+    out += R"(],"model":)";
+    out += nlohmann::json(model).dump();
+    out += R"(,"usage":{"prompt_tokens":)" + std::to_string(prompt_tokens) +
+           R"(,"total_tokens":)" + std::to_string(prompt_tokens) + "}}";
+
+    return server::HttpResponse{
+        .status = http::status::ok,
+        .content_type = "application/json",
+        .body = std::move(out),
+        .headers = {{"X-Cache", hits == count ? "HIT" : hits == 0 ? "MISS" : "PARTIAL"}}
+    };
+}
+
+} // namespace ntonix::proxy
@@ -0,0 +1,85 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Embedding Cache - Per-input caching for /v1/embeddings
+ *
+ * Embedding requests carry arrays of inputs that overlap heavily between
+ * calls, so caching whole responses rarely hits. Each input is instead
+ * looked up on its own; only the misses are forwarded, as one smaller
+ * batch, and the cached and fresh vectors are merged back in input order.
+ * Vectors are cached as packed float32 rather than JSON text.
+ */
+
+#ifndef NTONIX_PROXY_EMBEDDING_CACHE_HPP
+#define NTONIX_PROXY_EMBEDDING_CACHE_HPP
+
+#include "cache/lru_cache.hpp"
+#include "server/connection.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ntonix::proxy {
+
+/**
+ * Content type under which packed embedding vectors are cached
+ */
+inline constexpr std::string_view kEmbeddingContentType = "application/x-ntonix-embedding";
+
+/**
+ * One input's embedding as stored in the cache
+ */
+struct CachedEmbedding {
+    std::vector<float> vector;
+    std::uint32_t prompt_tokens{0};   // This input's share of the reported usage
+};
+
+/**
+ * Pack an embedding as [dims:u32][prompt_tokens:u32][dims x float32], host byte order
+ */
+std::string encode_embedding(const CachedEmbedding& embedding);
+
+/**
+ * Unpack an embedding written by encode_embedding()
+ * @return nullopt if the data is truncated or malformed
+ */
+std::optional<CachedEmbedding> decode_embedding(std::string_view data);
+
+/**
+ * Embedding Cache - splits embeddings requests into cached and forwarded inputs
+ *
+ * Inputs are cached under a key built from the request's other parameters
+ * (model, dimensions, ...) and the input itself; "encoding_format" and
+ * "user" do not affect the vectors and are left out. The backend is always
+ * asked for float vectors, and base64 output is produced at the edge.
+ * Thread-safe (the LRU cache is).
+ */
+class EmbeddingCache {
+public:
+    /**
+     * Sends a request to a backend and returns its response
+     */
+    using Dispatch = std::function<server::HttpResponse(const server::HttpRequest&)>;
+
+    explicit EmbeddingCache(std::shared_ptr<cache::LruCache> cache);
+
+    /**
+     * Serve an embeddings request from the cache, forwarding only the misses
+     * @param request Client request
+     * @param dispatch Forwards the (reduced) request to a backend
+     * @return The merged response, or nullopt if the request is not a
+     *         well-formed embeddings request and should be forwarded unchanged
+     */
+    std::optional<server::HttpResponse> handle(const server::HttpRequest& request, const Dispatch& dispatch);
+
+private:
+    std::shared_ptr<cache::LruCache> cache_;
+};
+
+} // namespace ntonix::proxy
+
+#endif // NTONIX_PROXY_EMBEDDING_CACHE_HPP
@@ -4,35 +4,286 @@
  */
 
 #include "proxy/forwarder.hpp"
+#include "util/buffer_pool.hpp"
+#include "util/metrics.hpp"
 
+#include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <random>
 #include <set>
 #include <sstream>
+#include <thread>
 
 namespace ntonix::proxy {
 
+namespace {
+
+/**
+ * Response parse buffer backed by the buffer pool, recycled across requests
+ */
+using PooledFlatBuffer = beast::basic_flat_buffer<util::PoolAllocator<char>>;
+
+} // namespace
+
 Forwarder::Forwarder(asio::io_context& io_context,
                      std::shared_ptr<ConnectionPoolManager> connection_pool,
                      const ForwarderConfig& config)
     : io_context_(io_context)
     , connection_pool_(std::move(connection_pool))
     , config_(config)
+    , retry_budget_(config.retry_budget)
 {
-    spdlog::debug("Forwarder: Created with timeout={}s, connect_timeout={}s",
-                  config_.request_timeout.count(), config_.connect_timeout.count());
+    spdlog::debug("Forwarder: Created with timeout={}ms, connect_timeout={}ms, max_retries={}",
+                  config_.request_timeout.count(), config_.connect_timeout.count(),
+                  config_.max_retries);
+}
+
+void Forwarder::set_load_balancer(std::shared_ptr<balancer::LoadBalancer> load_balancer) {
+    load_balancer_ = std::move(load_balancer);
 }
 
 ForwardResult Forwarder::forward(const server::HttpRequest& request,
                                 const config::BackendConfig& backend,
-                                const std::string& client_ip)
+                                const std::string& client_ip,
+                                const DisconnectWatch& disconnect)
+{
+    auto deadline = make_deadline(request);
+    return run_with_retries(backend, deadline, [&](const config::BackendConfig& target, bool fresh_connection) {
+        return forward_once(request, target, client_ip, deadline, disconnect, fresh_connection);
+    });
+}
+
+void Forwarder::forward_with_streaming(const server::HttpRequest& request,
+                                       const config::BackendConfig& backend,
+                                       beast::tcp_stream& client_stream,
+                                       const std::string& client_ip,
+                                       const StreamObservers& observers,
+                                       ForwardCompletion on_complete)
+{
+    // Nothing is written to the client until a streaming response has been
+    // chosen, so retrying here is always safe
+    auto deadline = make_deadline(request);
+    std::optional<PendingStream> pending;
+    auto result = run_with_retries(backend, deadline, [&](const config::BackendConfig& target, bool fresh_connection) {
+        return forward_with_streaming_once(request, target, client_ip, deadline, fresh_connection, pending);
+    });
+    if (!pending) {
+        on_complete(std::move(result));
+        return;
+    }
+
+    // Long generations are bounded by the pipe's idle timeout; the total
+    // deadline applies only if the client or the route set one.
+    auto stream_pipe = make_stream_pipe(io_context_, stream_config_for(request));
+    if (explicit_timeout(request)) {
+        stream_pipe->set_deadline(deadline.total());
+    }
+    stream_pipe->set_request_sent(pending->request_sent);
+
+    auto connection = pending->connection;
+    auto time_to_header = std::chrono::duration_cast<std::chrono::microseconds>(
+        pending->header_received - pending->request_sent);
+    tcp::socket& socket = (*connection)->socket();
+    stream_pipe->async_forward_stream(
+        socket, client_stream, pending->header, std::move(pending->initial_body), observers,
+        [result = std::move(result), connection, keep_alive = pending->keep_alive, started = pending->started,
+         time_to_header, on_complete = std::move(on_complete)](StreamResult stream_result) mutable {
+            result.stream_result = std::move(stream_result);
+            result.stream_result.timing.time_to_header = time_to_header;
+            result.success = result.stream_result.success;
+            if (!result.success) {
+                result.error_message = result.stream_result.error_message;
+            }
+
+            // Reuse the connection only if the relay read the body exactly to its end
+            if (!result.stream_result.backend_reusable || !keep_alive) {
+                connection->mark_failed();
+            }
+            connection->release();
+
+            auto end_time = std::chrono::steady_clock::now();
+            result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - started);
+
+            spdlog::info("Forwarder: Streaming complete - {} bytes forwarded in {}ms",
+                        result.stream_result.bytes_forwarded, result.latency.count());
+            on_complete(std::move(result));
+        });
+}
+
+RequestDeadline Forwarder::make_deadline(const server::HttpRequest& request) const {
+    TimeoutPolicy policy;
+    policy.connect = config_.connect_timeout;
+    policy.send = config_.send_timeout;
+    policy.first_byte = config_.first_byte_timeout;
+    policy.total = config_.request_timeout;
+
+    if (auto requested = explicit_timeout(request)) {
+        policy.total = *requested;
+    }
+
+    return RequestDeadline(policy);
+}
+
+std::optional<std::chrono::milliseconds> Forwarder::explicit_timeout(const server::HttpRequest& request) const {
+    if (auto requested = client_timeout(request)) {
+        return requested;
+    }
+
+    std::string_view path = request.target;
+    path = path.substr(0, path.find('?'));
+    if (auto it = config_.route_timeouts.find(std::string(path)); it != config_.route_timeouts.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+StreamPipeConfig Forwarder::stream_config_for(const server::HttpRequest& request) const {
+    StreamPipeConfig stream_config = config_.stream_config;
+
+    std::string_view path = request.target;
+    path = path.substr(0, path.find('?'));
+    if (auto it = config_.route_coalesce_windows.find(std::string(path)); it != config_.route_coalesce_windows.end()) {
+        stream_config.coalesce_window = it->second;
+    }
+    stream_config.cancel_on_half_close = config_.cancel_streams_on_half_close;
+    return stream_config;
+}
+
+std::optional<std::chrono::milliseconds> Forwarder::client_timeout(const server::HttpRequest& request) const {
+    if (config_.max_client_timeout.count() == 0) {
+        return std::nullopt;
+    }
+
+    auto it = request.raw_request.find("X-Request-Timeout");
+    if (it == request.raw_request.end()) {
+        return std::nullopt;
+    }
+
+    auto requested = parse_request_timeout(std::string_view(it->value().data(), it->value().size()));
+    if (!requested) {
+        spdlog::debug("Forwarder: Ignoring malformed X-Request-Timeout: {}", std::string(it->value()));
+        return std::nullopt;
+    }
+
+    return std::min(*requested, config_.max_client_timeout);
+}
+
+void Forwarder::set_timeout_result(ForwardResult& result) {
+    result.success = false;
+    result.retryable = false;
+    result.error_message = "Backend request timed out";
+    result.response.status = http::status::gateway_timeout;
+    result.response.content_type = "application/json";
+    result.response.body = R"({"error": "Backend request timed out"})";
+}
+
+ForwardResult Forwarder::run_with_retries(const config::BackendConfig& backend,
+                                          const RequestDeadline& deadline,
+                                          const Attempt& attempt)
+{
+    auto start_time = std::chrono::steady_clock::now();
+    retry_budget_.record_request();
+
+    // A reused connection the backend had already closed says nothing about
+    // the backend: try it again right away, once, on a new connection
+    auto attempt_backend = [&](const config::BackendConfig& target) {
+        auto result = attempt(target, false);
+        if (result.stale_connection && !deadline.expired()) {
+            util::Metrics::instance().backend_stale_connection(target.id, true);
+            spdlog::info("Forwarder: Reused connection to {}:{} was closed by the backend ({}), "
+                         "retrying on a new connection", target.host, target.port, result.error_message);
+            result = attempt(target, true);
+        }
+        return result;
+    };
+
+    std::vector<config::BackendConfig> tried{backend};
+    ForwardResult result = attempt_backend(backend);
+    std::size_t attempts = 1;
+
+    while (result.retryable && attempts <= config_.max_retries && load_balancer_ && !deadline.expired()) {
+        // Always move to a backend that has not failed this request yet
+        auto next = load_balancer_->select_backend(tried);
+        if (!next) {
+            spdlog::debug("Forwarder: No alternate backend available for retry");
+            break;
+        }
+
+        // A retry that could only start at (or after) the deadline would just
+        // turn the failure into a 504 later: report the failure now instead
+        auto delay = backoff_delay(attempts);
+        if (delay >= deadline.remaining()) {
+            spdlog::debug("Forwarder: Backoff of {}ms would outlast the request deadline, not retrying",
+                          delay.count());
+            break;
+        }
+
+        if (!retry_budget_.try_acquire()) {
+            spdlog::warn("Forwarder: Retry budget exhausted, not retrying failure from {}:{}",
+                         result.backend_host, result.backend_port);
+            util::Metrics::instance().retry_budget_exhausted();
+            break;
+        }
+
+        // The caller only sees the final attempt, so account the failed one here
+        util::Metrics::instance().backend_request(result.backend_id, false, result.latency);
+
+        spdlog::info("Forwarder: Retrying request on {}:{} after failure on {}:{} ({}), backoff={}ms",
+                     next->backend.host, next->backend.port,
+                     result.backend_host, result.backend_port,
+                     result.error_message, delay.count());
+        if (delay.count() > 0) {
+            std::this_thread::sleep_until(std::min(std::chrono::steady_clock::now() + delay, deadline.total()));
+        }
+
+        util::Metrics::instance().retry_attempted();
+        tried.push_back(next->backend);
+        result = attempt_backend(next->backend);
+        ++attempts;
+    }
+
+    result.attempts = attempts;
+    if (attempts > 1) {
+        result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_time);
+    }
+    return result;
+}
+
+std::chrono::milliseconds Forwarder::backoff_delay(std::size_t retry) const {
+    // Exponential growth capped at retry_backoff_max, with "equal jitter":
+    // half the delay is fixed, the other half random, so concurrent retries
+    // spread out. Retry n waits between base * 2^(n-1) and base * 2^n, never
+    // less than the base nor more than the cap.
+    auto base = config_.retry_backoff_base.count();
+    auto cap = config_.retry_backoff_max.count();
+    auto exponent = std::min<std::size_t>(retry, 16);
+    auto limit = std::min<std::int64_t>(base << exponent, cap);
+    auto low = std::min<std::int64_t>(std::max<std::int64_t>(limit / 2, base), limit);
+    if (low >= limit) {
+        return std::chrono::milliseconds{std::max<std::int64_t>(limit, 0)};
+    }
+
+    static thread_local std::mt19937_64 gen(std::random_device{}());
+    std::uniform_int_distribution<std::int64_t> jitter(low, limit);
+    return std::chrono::milliseconds{jitter(gen)};
+}
+
+ForwardResult Forwarder::forward_once(const server::HttpRequest& request,
+                                     const config::BackendConfig& backend,
+                                     const std::string& client_ip,
+                                     const RequestDeadline& deadline,
+                                     const DisconnectWatch& disconnect,
+                                     bool fresh_connection)
 {
     ForwardResult result;
     result.backend_host = backend.host;
     result.backend_port = backend.port;
+    result.backend_id = backend.id;
 
     auto start_time = std::chrono::steady_clock::now();
 
@@ -40,10 +291,21 @@ ForwardResult Forwarder::forward(const server::HttpRequest& request,
                   std::string(http::to_string(request.method)),
                   request.target, backend.host, backend.port);
 
-    // Get a connection from the pool
-    auto conn_guard = connection_pool_->get_connection(backend);
+    // Get a connection from the pool (connecting counts against the deadline)
+    auto conn_guard = connection_pool_->get_connection(
+        backend, std::min(deadline.policy().connect, deadline.remaining()), fresh_connection);
+    bool reused = conn_guard && (*conn_guard)->reused();
+    if (!conn_guard && deadline.expired()) {
+        set_timeout_result(result);
+        result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_time);
+        util::Metrics::instance().request_timed_out();
+        spdlog::warn("Forwarder: Deadline expired connecting to {}:{}", backend.host, backend.port);
+        return result;
+    }
     if (!conn_guard) {
         result.success = false;
+        result.retryable = true;
         result.error_message = "Failed to get connection to backend";
         result.response.status = http::status::bad_gateway;
         result.response.content_type = "application/json";
@@ -59,28 +321,41 @@ ForwardResult Forwarder::forward(const server::HttpRequest& request,
     // Build the request to send to the backend
     auto backend_request = build_backend_request(request, backend, client_ip);
 
+    // Declared outside the try block so a failure can tell how far the
+    // exchange got (only failures before the request was sent are retried)
+    PooledFlatBuffer buffer;
+    http::response_parser<http::string_body> parser;
+    bool request_written = false;
+
     try {
         // Get the underlying socket from the pooled connection
         // conn_guard is std::optional<ConnectionGuard>, so we dereference with * to get ConnectionGuard
         // Then use -> to access the PooledConnection, and socket() to get the socket
         tcp::socket& socket = (*conn_guard)->socket();
 
-        // Send the request directly on the socket
-        // Note: For timeout handling with synchronous operations, we could use
-        // async operations with a deadline timer. For now, rely on TCP defaults.
-        spdlog::debug("Forwarder: Sending request to backend");
-        http::write(socket, backend_request);
+        // Every phase is bounded by the request deadline; an expired
+        // deadline fails the pending operation with beast::error::timeout
+        DeadlineStream stream(socket);
+        DisconnectWatch watch = disconnect;
+        watch.half_close = config_.cancel_on_half_close;
+        stream.cancel_on_disconnect(std::move(watch));
 
-        // Read the response
-        beast::flat_buffer buffer;
-        http::response<http::string_body> backend_response;
+        spdlog::debug("Forwarder: Sending request to backend");
+        stream.expires_at(deadline.phase(deadline.policy().send));
+        http::write(stream, backend_request);
+        request_written = true;
 
+        // Read the response header (time to first byte), then the body
         spdlog::debug("Forwarder: Reading response from backend");
-        http::read(socket, buffer, backend_response);
+        stream.expires_at(deadline.phase(deadline.policy().first_byte));
+        http::read_header(stream, buffer, parser);
+
+        stream.expires_at(deadline.total());
+        http::read(stream, buffer, parser);
 
         // Parse the response
         result.success = true;
-        result.response = parse_backend_response(backend_response);
+        result.response = parse_backend_response(parser.get());
 
         auto end_time = std::chrono::steady_clock::now();
         result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -93,6 +368,13 @@ ForwardResult Forwarder::forward(const server::HttpRequest& request,
         result.success = false;
         conn_guard->mark_failed();  // Don't return broken connection to pool
 
+        // Only a request the backend never received is retried elsewhere:
+        // once it has been sent the backend may be working on it, and a
+        // request that crashed one backend would crash the next too
+        bool nothing_received = e.code() != beast::error::timeout &&
+                                !parser.got_some() && buffer.size() == 0;
+        result.retryable = nothing_received && !request_written;
+
         auto end_time = std::chrono::steady_clock::now();
         result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
@@ -100,7 +382,18 @@ ForwardResult Forwarder::forward(const server::HttpRequest& request,
         if (e.code() == beast::error::timeout) {
             result.error_message = "Backend request timed out";
             result.response.status = http::status::gateway_timeout;
+            util::Metrics::instance().request_timed_out();
             spdlog::warn("Forwarder: Timeout communicating with {}:{}", backend.host, backend.port);
+        } else if (e.code() == asio::error::operation_aborted) {
+            // Closing the backend connection (mark_failed above) is what
+            // tells the backend to stop generating for a client that left
+            result.cancelled = true;
+            result.retryable = false;
+            result.error_message = "Client disconnected";
+            result.response.status = http::status::bad_gateway;
+            util::Metrics::instance().request_cancelled();
+            spdlog::info("Forwarder: Client disconnected, abandoned request to {}:{}",
+                         backend.host, backend.port);
         } else if (e.code() == asio::error::connection_refused ||
                    e.code() == asio::error::connection_reset ||
                    e.code() == asio::error::broken_pipe) {
@@ -117,6 +410,9 @@ ForwardResult Forwarder::forward(const server::HttpRequest& request,
 
         result.response.content_type = "application/json";
         result.response.body = R"({"error": ")" + result.error_message + R"("})";
+        // A reused connection failing before any response byte was most
+        // likely closed by the backend before the request reached it
+        result.stale_connection = nothing_received && reused && !result.cancelled;
 
     } catch (const std::exception& e) {
         result.success = false;
@@ -292,6 +588,69 @@ server::HttpResponse Forwarder::parse_backend_response(
     return result;
 }
 
+void Forwarder::forward_shared_stream(const server::HttpRequest& request,
+                                      StreamBroadcast::Ptr broadcast,
+                                      beast::tcp_stream& client_stream,
+                                      std::function<void()> on_unjoined,
+                                      ForwardCompletion on_complete)
+{
+    auto start_time = std::chrono::steady_clock::now();
+
+    // Same limits as the leader's pipe would apply to this request
+    auto stream_pipe = make_stream_pipe(io_context_, stream_config_for(request));
+    if (explicit_timeout(request)) {
+        stream_pipe->set_deadline(make_deadline(request).total());
+    }
+    stream_pipe->async_forward_broadcast(std::move(broadcast), client_stream, std::move(on_unjoined),
+        [start_time, on_complete = std::move(on_complete)](StreamResult stream_result) {
+            ForwardResult result;
+            result.stream_result = std::move(stream_result);
+            result.is_streaming = true;
+            result.success = result.stream_result.success;
+            if (!result.success) {
+                result.error_message = result.stream_result.error_message;
+            }
+
+            auto end_time = std::chrono::steady_clock::now();
+            result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+            on_complete(std::move(result));
+        });
+}
+
+void Forwarder::forward_cached_stream(const server::HttpRequest& request,
+                                      std::vector<std::string> events,
+                                      beast::tcp_stream& client_stream,
+                                      ForwardCompletion on_complete)
+{
+    auto start_time = std::chrono::steady_clock::now();
+
+    http::response_header<> header;
+    header.version(11);
+    header.result(http::status::ok);
+    header.set(http::field::content_type, "text/event-stream");
+    header.set(http::field::cache_control, "no-cache");
+    header.set("X-Cache", "HIT");
+
+    auto stream_pipe = make_stream_pipe(io_context_, stream_config_for(request));
+    if (explicit_timeout(request)) {
+        stream_pipe->set_deadline(make_deadline(request).total());
+    }
+    stream_pipe->async_forward_events(header, std::move(events), client_stream,
+        [start_time, on_complete = std::move(on_complete)](StreamResult stream_result) {
+            ForwardResult result;
+            result.stream_result = std::move(stream_result);
+            result.is_streaming = true;
+            result.success = result.stream_result.success;
+            if (!result.success) {
+                result.error_message = result.stream_result.error_message;
+            }
+
+            auto end_time = std::chrono::steady_clock::now();
+            result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+            on_complete(std::move(result));
+        });
+}
+
 bool Forwarder::is_streaming_request(const server::HttpRequest& request) {
     // Check if the request body contains "stream": true (OpenAI API format)
     // This is a simple check; a more robust implementation would parse the JSON
@@ -315,14 +674,27 @@ bool Forwarder::is_streaming_request(const server::HttpRequest& request) {
     return false;
 }
 
-ForwardResult Forwarder::forward_with_streaming(const server::HttpRequest& request,
-                                                const config::BackendConfig& backend,
-                                                beast::tcp_stream& client_stream,
-                                                const std::string& client_ip)
+std::string Forwarder::request_model(const server::HttpRequest& request) {
+    auto body = nlohmann::json::parse(request.body, nullptr, false);
+    if (body.is_object()) {
+        if (auto it = body.find("model"); it != body.end() && it->is_string()) {
+            return it->get<std::string>();
+        }
+    }
+    return {};
+}
+
+ForwardResult Forwarder::forward_with_streaming_once(const server::HttpRequest& request,
+                                                     const config::BackendConfig& backend,
+                                                     const std::string& client_ip,
+                                                     const RequestDeadline& deadline,
+                                                     bool fresh_connection,
+                                                     std::optional<PendingStream>& pending)
 {
     ForwardResult result;
     result.backend_host = backend.host;
     result.backend_port = backend.port;
+    result.backend_id = backend.id;
 
     auto start_time = std::chrono::steady_clock::now();
 
@@ -333,10 +705,21 @@ ForwardResult Forwarder::forward_with_streaming(const server::HttpRequest& reque
                   std::string(http::to_string(request.method)),
                   request.target, backend.host, backend.port, expect_streaming);
 
-    // Get a connection from the pool
-    auto conn_guard = connection_pool_->get_connection(backend);
+    // Get a connection from the pool (connecting counts against the deadline)
+    auto conn_guard = connection_pool_->get_connection(
+        backend, std::min(deadline.policy().connect, deadline.remaining()), fresh_connection);
+    bool reused = conn_guard && (*conn_guard)->reused();
+    if (!conn_guard && deadline.expired()) {
+        set_timeout_result(result);
+        result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_time);
+        util::Metrics::instance().request_timed_out();
+        spdlog::warn("Forwarder: Deadline expired connecting to {}:{}", backend.host, backend.port);
+        return result;
+    }
     if (!conn_guard) {
         result.success = false;
+        result.retryable = true;
         result.error_message = "Failed to get connection to backend";
         result.response.status = http::status::bad_gateway;
         result.response.content_type = "application/json";
@@ -352,20 +735,26 @@ ForwardResult Forwarder::forward_with_streaming(const server::HttpRequest& reque
     // Build the request to send to the backend
     auto backend_request = build_backend_request(request, backend, client_ip);
 
+    PooledFlatBuffer buffer;
+    http::response_parser<http::string_body> parser;
+    parser.body_limit(boost::none);  // No body limit for streaming
+    bool request_written = false;
+
     try {
         tcp::socket& socket = (*conn_guard)->socket();
+        DeadlineStream stream(socket);
 
         // Send the request to backend
         spdlog::debug("Forwarder: Sending request to backend");
-        http::write(socket, backend_request);
+        auto request_sent = std::chrono::steady_clock::now();
+        stream.expires_at(deadline.phase(deadline.policy().send));
+        http::write(stream, backend_request);
+        request_written = true;
 
         // Read just the response header first to determine if streaming
-        beast::flat_buffer buffer;
-        http::response_parser<http::string_body> parser;
-        parser.body_limit(boost::none);  // No body limit for streaming
-
-        // Read the header
-        http::read_header(socket, buffer, parser);
+        stream.expires_at(deadline.phase(deadline.policy().first_byte));
+        http::read_header(stream, buffer, parser);
+        auto header_received = std::chrono::steady_clock::now();
 
         auto& response_header = parser.get();
 
@@ -392,33 +781,26 @@ ForwardResult Forwarder::forward_with_streaming(const server::HttpRequest& reque
                 buffer.consume(remaining.size());
             }
 
-            // Create stream pipe and forward
-            auto stream_pipe = make_stream_pipe(io_context_, config_.stream_config);
-            result.stream_result = stream_pipe->forward_stream(
-                socket, client_stream, response_header.base(), initial_body);
+            // The caller relays the body; the connection goes with it
+            pending.emplace();
+            pending->header = response_header.base();
+            pending->initial_body = std::move(initial_body);
+            pending->keep_alive = response_header.keep_alive();
+            pending->started = start_time;
+            pending->request_sent = request_sent;
+            pending->header_received = header_received;
+            pending->connection = std::make_shared<ConnectionGuard>(std::move(*conn_guard));
 
             result.is_streaming = true;
-            result.success = result.stream_result.success;
-
-            if (!result.success) {
-                result.error_message = result.stream_result.error_message;
-            }
-
-            // After streaming, connection should not be reused
-            conn_guard->mark_failed();
-
-            auto end_time = std::chrono::steady_clock::now();
-            result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-
-            spdlog::info("Forwarder: Streaming complete - {} bytes forwarded in {}ms",
-                        result.stream_result.bytes_forwarded, result.latency.count());
+            result.success = true;
 
         } else {
             // Non-streaming response - read the full body
             spdlog::debug("Forwarder: Non-streaming response - reading full body");
 
             // Continue reading the rest of the response
-            http::read(socket, buffer, parser);
+            stream.expires_at(deadline.total());
+            http::read(stream, buffer, parser);
 
             // Parse the response
             result.success = true;
@@ -437,12 +819,20 @@ ForwardResult Forwarder::forward_with_streaming(const server::HttpRequest& reque
         result.success = false;
         conn_guard->mark_failed();
 
+        // Only a request the backend never received is retried elsewhere:
+        // once it has been sent the backend may be working on it, and a
+        // request that crashed one backend would crash the next too
+        bool nothing_received = e.code() != beast::error::timeout &&
+                                !parser.got_some() && buffer.size() == 0;
+        result.retryable = nothing_received && !request_written;
+
         auto end_time = std::chrono::steady_clock::now();
         result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
         if (e.code() == beast::error::timeout) {
             result.error_message = "Backend request timed out";
             result.response.status = http::status::gateway_timeout;
+            util::Metrics::instance().request_timed_out();
             spdlog::warn("Forwarder: Timeout communicating with {}:{}", backend.host, backend.port);
         } else if (e.code() == asio::error::connection_refused ||
                    e.code() == asio::error::connection_reset ||
@@ -460,6 +850,9 @@ ForwardResult Forwarder::forward_with_streaming(const server::HttpRequest& reque
 
         result.response.content_type = "application/json";
         result.response.body = R"({"error": ")" + result.error_message + R"("})";
+        // A reused connection failing before any response byte was most
+        // likely closed by the backend before the request reached it
+        result.stale_connection = nothing_received && reused;
 
     } catch (const std::exception& e) {
         result.success = false;
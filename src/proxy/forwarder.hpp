@@ -8,7 +8,11 @@
 
 #include "config/config.hpp"
 #include "server/connection.hpp"
+#include "balancer/load_balancer.hpp"
 #include "proxy/connection_pool.hpp"
+#include "proxy/deadline_stream.hpp"
+#include "proxy/retry_budget.hpp"
+#include "proxy/stream_broadcast.hpp"
 #include "proxy/stream_pipe.hpp"
 
 #include <boost/asio.hpp>
@@ -17,9 +21,11 @@
 
 #include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace ntonix::proxy {
 
@@ -32,12 +38,22 @@ using tcp = asio::ip::tcp;
  * Configuration for request forwarding
  */
 struct ForwarderConfig {
-    std::chrono::seconds request_timeout{30};     // Timeout for backend response
-    std::chrono::seconds connect_timeout{5};      // Timeout for establishing connection
+    std::chrono::milliseconds request_timeout{30000};    // End-to-end deadline for the backend exchange
+    std::chrono::milliseconds connect_timeout{5000};     // Timeout for establishing connection
+    std::chrono::milliseconds send_timeout{10000};       // Timeout for writing the request
+    std::chrono::milliseconds first_byte_timeout{60000}; // Timeout for the response header
+    std::chrono::milliseconds max_client_timeout{600000}; // Cap on X-Request-Timeout (0 = header ignored)
+    bool cancel_on_half_close{false};                     // A client's half-close counts as a disconnect
+    bool cancel_streams_on_half_close{true};              // Same for streaming requests
+    std::map<std::string, std::chrono::milliseconds> route_timeouts; // Per-target request_timeout overrides
     bool add_forwarded_headers{true};             // Add X-Forwarded-For, X-Real-IP
     bool generate_request_id{true};               // Generate X-Request-ID if not present
     std::size_t max_retries{0};                   // Retry count on connection failure (0 = no retry)
+    std::chrono::milliseconds retry_backoff_base{25};  // Backoff before the first retry (jittered, doubling)
+    std::chrono::milliseconds retry_backoff_max{250};  // Upper bound on a single backoff
+    RetryBudgetConfig retry_budget{};              // Limits retries to a fraction of traffic
     StreamPipeConfig stream_config{};              // Configuration for streaming responses
+    std::map<std::string, std::chrono::milliseconds> route_coalesce_windows; // Per-target stream_config.coalesce_window overrides
 };
 
 /**
@@ -52,19 +68,38 @@ struct ForwardResult {
     // Backend that handled the request
     std::string backend_host;
     std::uint16_t backend_port{0};
+    config::BackendId backend_id{config::kNoBackendId};
 
     // Streaming-specific fields
     bool is_streaming{false};               // True if response was streamed
     StreamResult stream_result{};           // Details of streaming (if is_streaming)
+
+    // Retry bookkeeping
+    std::size_t attempts{1};                // Number of backends tried (1 = no retry)
+    bool retryable{false};                  // Failed before the request reached the backend
+    bool cancelled{false};                  // Client disconnected, backend request abandoned
+    bool stale_connection{false};           // Reused keep-alive connection failed before any response byte
 };
 
+/**
+ * Completion handler of forward_with_streaming(), called once with the outcome
+ */
+using ForwardCompletion = std::function<void(ForwardResult)>;
+
 /**
  * Request Forwarder - forwards HTTP requests to backend servers
  *
  * Features:
  * - Uses connection pooling for efficient backend connections
  * - Adds proxy headers (X-Forwarded-For, X-Real-IP, X-Request-ID)
- * - Configurable timeouts for connect and request
+ * - Per-request deadlines for connect, send, first byte and full response
+ *   (from route config or the client's X-Request-Timeout header)
+ * - Retries connection-level failures on a different backend (jittered backoff,
+ *   bounded by a retry budget)
+ * - Retries a request whose reused connection the backend had closed once,
+ *   immediately, on a new connection to the same backend
+ * - Abandons non-streaming backend requests whose client has disconnected
+ * - Relays streamed responses asynchronously, without holding a thread per stream
  * - Graceful error handling with detailed error messages
  */
 class Forwarder : public std::enable_shared_from_this<Forwarder> {
@@ -87,32 +122,96 @@ public:
     Forwarder(const Forwarder&) = delete;
     Forwarder& operator=(const Forwarder&) = delete;
 
+    /**
+     * Set the load balancer used to pick alternate backends for retries
+     * Without a load balancer, failed requests are not retried.
+     */
+    void set_load_balancer(std::shared_ptr<balancer::LoadBalancer> load_balancer);
+
     /**
      * Forward a request to a backend synchronously
+     * Connection-level failures (no connection, dead pooled socket, reset before
+     * any response byte) are retried on a different backend up to max_retries.
      * @param request The HTTP request to forward
      * @param backend The backend to forward to
      * @param client_ip The client's IP address (for X-Forwarded-For)
+     * @param disconnect Client socket whose disconnect closes the backend connection,
+     *                   so the backend can stop generating (result.cancelled is set)
      * @return ForwardResult with response or error
      */
     ForwardResult forward(const server::HttpRequest& request,
                          const config::BackendConfig& backend,
-                         const std::string& client_ip = "");
+                         const std::string& client_ip = "",
+                         const DisconnectWatch& disconnect = {});
 
     /**
      * Forward a request with streaming response support
-     * If the backend returns a streaming response (SSE), this streams directly to the client.
-     * Non-streaming responses are handled normally.
+     * The request is sent and the response header read on the calling thread.
+     * A streaming response (SSE) is then relayed to the client asynchronously
+     * on the io_context and on_complete runs when the stream ends; any other
+     * response, or a failure, is passed to on_complete before this returns.
+     * Retries only happen before any response byte has been written to the client.
      *
      * @param request The HTTP request to forward
      * @param backend The backend to forward to
      * @param client_stream The client's TCP stream for direct streaming
+     *                      (must stay open until on_complete runs)
      * @param client_ip The client's IP address (for X-Forwarded-For)
-     * @return ForwardResult with response or streaming details
+     * @param observers Observers attached to the stream if the response is streamed
+     * @param on_complete Called once with the response or streaming details
+     */
+    void forward_with_streaming(const server::HttpRequest& request,
+                                const config::BackendConfig& backend,
+                                beast::tcp_stream& client_stream,
+                                const std::string& client_ip,
+                                const StreamObservers& observers,
+                                ForwardCompletion on_complete);
+
+    /**
+     * Serve a streaming client from another request's in-flight backend stream
+     * Returns at once: the client waits for the leader's header and follows
+     * the stream asynchronously on the io_context, holding no thread.
+     * @param request The joining client's request (for its deadline and route limits)
+     * @param broadcast The shared stream
+     * @param client_stream The joining client's TCP stream
+     *                      (must stay open until a handler runs)
+     * @param on_unjoined Called instead of on_complete if the stream cannot be
+     *                    joined; nothing has been written to the client
+     * @param on_complete Called once with streaming details (no backend is contacted)
+     */
+    void forward_shared_stream(const server::HttpRequest& request,
+                               StreamBroadcast::Ptr broadcast,
+                               beast::tcp_stream& client_stream,
+                               std::function<void()> on_unjoined,
+                               ForwardCompletion on_complete);
+
+    /**
+     * Serve a streaming client from a cached completion
+     * Returns at once; the replay runs on the io_context.
+     * @param request The client's request (for its deadline)
+     * @param events SSE events of the cached completion
+     * @param client_stream The client's TCP stream
+     *                      (must stay open until on_complete runs)
+     * @param on_complete Called once with streaming details (no backend is contacted)
+     */
+    void forward_cached_stream(const server::HttpRequest& request,
+                               std::vector<std::string> events,
+                               beast::tcp_stream& client_stream,
+                               ForwardCompletion on_complete);
+
+    /**
+     * Compute the deadline for a request, starting now
+     * The total comes from X-Request-Timeout (capped by max_client_timeout)
+     * if present, else from route_timeouts, else from request_timeout.
+     */
+    RequestDeadline make_deadline(const server::HttpRequest& request) const;
+
+    /**
+     * Stream pipe configuration for a request
+     * The coalescing window comes from route_coalesce_windows if the target
+     * has an entry, else from stream_config.
      */
-    ForwardResult forward_with_streaming(const server::HttpRequest& request,
-                                         const config::BackendConfig& backend,
-                                         beast::tcp_stream& client_stream,
-                                         const std::string& client_ip = "");
+    StreamPipeConfig stream_config_for(const server::HttpRequest& request) const;
 
     /**
      * Check if a request should be handled with streaming
@@ -120,12 +219,87 @@ public:
      */
     static bool is_streaming_request(const server::HttpRequest& request);
 
+    /**
+     * The "model" field of a JSON request body (empty if absent)
+     */
+    static std::string request_model(const server::HttpRequest& request);
+
     /**
      * Get the configuration
      */
     const ForwarderConfig& config() const { return config_; }
 
 private:
+    using Attempt = std::function<ForwardResult(const config::BackendConfig&, bool fresh_connection)>;
+
+    /**
+     * A streaming response whose header has been read, ready to be relayed
+     */
+    struct PendingStream {
+        std::shared_ptr<ConnectionGuard> connection;
+        http::response_header<> header;
+        std::string initial_body;                          // Body bytes read with the header, still framed
+        bool keep_alive{false};
+        std::chrono::steady_clock::time_point started;     // Start of the attempt
+        std::chrono::steady_clock::time_point request_sent;
+        std::chrono::steady_clock::time_point header_received;
+    };
+
+    /**
+     * Run an attempt, retrying retryable failures on alternate backends
+     * until the request's deadline expires (and a stale connection once
+     * on the same backend)
+     */
+    ForwardResult run_with_retries(const config::BackendConfig& backend,
+                                   const RequestDeadline& deadline,
+                                   const Attempt& attempt);
+
+    /**
+     * Single forwarding attempt against one backend (no retries)
+     * @param fresh_connection Use a new backend connection, not an idle pooled one
+     */
+    ForwardResult forward_once(const server::HttpRequest& request,
+                               const config::BackendConfig& backend,
+                               const std::string& client_ip,
+                               const RequestDeadline& deadline,
+                               const DisconnectWatch& disconnect,
+                               bool fresh_connection);
+
+    /**
+     * Single streaming forwarding attempt against one backend (no retries)
+     * A streaming response is left in `pending` for the caller to relay;
+     * anything else is read in full into the result.
+     * @param fresh_connection Use a new backend connection, not an idle pooled one
+     */
+    ForwardResult forward_with_streaming_once(const server::HttpRequest& request,
+                                              const config::BackendConfig& backend,
+                                              const std::string& client_ip,
+                                              const RequestDeadline& deadline,
+                                              bool fresh_connection,
+                                              std::optional<PendingStream>& pending);
+
+    /**
+     * Fill in a 504 result for a request whose deadline expired
+     */
+    static void set_timeout_result(ForwardResult& result);
+
+    /**
+     * Timeout requested by the client via X-Request-Timeout (capped)
+     */
+    std::optional<std::chrono::milliseconds> client_timeout(const server::HttpRequest& request) const;
+
+    /**
+     * Timeout set for this request rather than by default: X-Request-Timeout
+     * if present, else the route's entry in route_timeouts
+     */
+    std::optional<std::chrono::milliseconds> explicit_timeout(const server::HttpRequest& request) const;
+
+    /**
+     * Jittered exponential backoff before retry number `retry` (1-based),
+     * between retry_backoff_base and retry_backoff_max
+     */
+    std::chrono::milliseconds backoff_delay(std::size_t retry) const;
+
     /**
      * Build the backend request with proxy headers
      */
@@ -147,7 +321,9 @@ private:
 
     asio::io_context& io_context_;
     std::shared_ptr<ConnectionPoolManager> connection_pool_;
+    std::shared_ptr<balancer::LoadBalancer> load_balancer_;
     ForwarderConfig config_;
+    RetryBudget retry_budget_;
 };
 
 /**
@@ -0,0 +1,234 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Micro Batcher implementation
+ */
+
+#include "proxy/micro_batcher.hpp"
+#include "util/metrics.hpp"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <exception>
+
+namespace ntonix::proxy {
+
+namespace http = boost::beast::http;
+
+namespace {
+
+/**
+ * True if an optional integer field is absent or exactly 1
+ */
+bool absent_or_one(const nlohmann::json& body, const char* field) {
+    auto it = body.find(field);
+    return it == body.end() || it->is_null() || (it->is_number_integer() && it->get<std::int64_t>() == 1);
+}
+
+/**
+ * The i-th of `count` near-equal shares of `total` (shares sum to total)
+ */
+std::int64_t share(std::int64_t total, std::size_t i, std::size_t count) {
+    auto n = static_cast<std::int64_t>(count);
+    return total / n + (static_cast<std::int64_t>(i) < total % n ? 1 : 0);
+}
+
+std::string_view header_value(const server::HttpRequest& request, const char* name) {
+    auto it = request.raw_request.find(name);
+    return it == request.raw_request.end() ? std::string_view{}
+                                           : std::string_view(it->value().data(), it->value().size());
+}
+
+server::HttpResponse error_response(http::status status, const char* body) {
+    return server::HttpResponse{
+        .status = status,
+        .content_type = "application/json",
+        .body = body
+    };
+}
+
+} // namespace
+
+MicroBatcher::MicroBatcher(const MicroBatcherConfig& config, Dispatch dispatch)
+    : config_(config)
+    , dispatch_(std::move(dispatch))
+{
+    spdlog::debug("MicroBatcher: Created with max_batch_size={}, max_wait={}us",
+                  config_.max_batch_size, config_.max_wait.count());
+}
+
+std::optional<server::HttpResponse> MicroBatcher::submit(const server::HttpRequest& request) {
+    auto body = nlohmann::json::parse(request.body, nullptr, false);
+    if (body.is_discarded() || !body.is_object()) {
+        return std::nullopt;
+    }
+
+    // Only single string prompts with one choice each can be split back out
+    auto prompt = body.find("prompt");
+    if (prompt == body.end() || !prompt->is_string()) {
+        return std::nullopt;
+    }
+    if (auto stream = body.find("stream"); stream != body.end() && stream->is_boolean() && stream->get<bool>()) {
+        return std::nullopt;
+    }
+    if (!absent_or_one(body, "n") || !absent_or_one(body, "best_of")) {
+        return std::nullopt;
+    }
+
+    std::string prompt_text = prompt->get<std::string>();
+    body.erase(prompt);
+    std::string params = body.dump();   // Object keys are sorted, so equal parameters serialize equally
+    // The batch goes out with the leader's headers: members must share its deadline and priority
+    std::string key = request.target + '\n' + request.authorization + '\n' +
+                      std::string(header_value(request, "X-Request-Timeout")) + '\n' +
+                      std::string(header_value(request, "X-Priority")) + '\n' + params;
+
+    auto now = clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    std::shared_ptr<Batch> batch;
+    bool leader = false;
+    if (auto it = open_.find(key); it != open_.end()) {
+        batch = it->second;
+    } else {
+        batch = std::make_shared<Batch>();
+        batch->params = std::move(params);
+        batch->opened = now;
+        open_.emplace(key, batch);
+        leader = true;
+    }
+
+    std::size_t index = batch->prompts.size();
+    batch->prompts.push_back(std::move(prompt_text));
+    batch->arrivals.push_back(now);
+    if (batch->prompts.size() >= config_.max_batch_size) {
+        seal_locked(key, batch);
+        batch->cv.notify_all();
+    }
+
+    if (leader) {
+        batch->cv.wait_until(lock, batch->opened + config_.max_wait, [&] { return batch->sealed; });
+        if (!batch->sealed) {
+            seal_locked(key, batch);
+        }
+        lock.unlock();
+        dispatch_batch(batch, request);
+        lock.lock();
+    } else if (!batch->cv.wait_for(lock, config_.result_timeout, [&] { return batch->done; })) {
+        spdlog::warn("MicroBatcher: Timed out waiting for batched response");
+        return error_response(http::status::gateway_timeout,
+                              R"({"error": "Timed out waiting for batched backend response"})");
+    }
+
+    return std::move(batch->responses[index]);
+}
+
+void MicroBatcher::seal_locked(const std::string& key, const std::shared_ptr<Batch>& batch) {
+    batch->sealed = true;
+    batch->sealed_at = clock::now();
+    if (auto it = open_.find(key); it != open_.end() && it->second == batch) {
+        open_.erase(it);
+    }
+}
+
+void MicroBatcher::dispatch_batch(const std::shared_ptr<Batch>& batch, const server::HttpRequest& leader_request) {
+    auto& metrics = util::Metrics::instance();
+    auto size = batch->prompts.size();
+    for (auto arrival : batch->arrivals) {
+        metrics.batch_wait(std::chrono::duration_cast<std::chrono::microseconds>(batch->sealed_at - arrival));
+    }
+    metrics.batch_sent(size);
+
+    std::vector<server::HttpResponse> responses;
+    try {
+        if (size == 1) {
+            // Nobody joined: forward the original request untouched
+            responses.push_back(dispatch_(leader_request));
+        } else {
+            auto body = nlohmann::json::parse(batch->params);
+            body["prompt"] = batch->prompts;
+
+            server::HttpRequest batch_request = leader_request;
+            batch_request.body = body.dump();
+            responses = split_response(dispatch_(batch_request), size);
+            spdlog::debug("MicroBatcher: Sent {} prompts as one backend request", size);
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("MicroBatcher: Batch dispatch failed: {}", e.what());
+        responses.assign(size, error_response(http::status::bad_gateway,
+                                              R"({"error": "Batched backend request failed"})"));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch->responses = std::move(responses);
+    batch->done = true;
+    batch->cv.notify_all();
+}
+
+std::vector<server::HttpResponse> MicroBatcher::split_response(const server::HttpResponse& response,
+                                                               std::size_t count) {
+    auto status = static_cast<int>(response.status);
+    auto doc = nlohmann::json::parse(response.body, nullptr, false);
+
+    // Errors (and anything unrecognizable) go to every member unchanged
+    if (status < 200 || status >= 300 || !doc.is_object() ||
+        !doc.contains("choices") || !doc["choices"].is_array()) {
+        return std::vector<server::HttpResponse>(count, response);
+    }
+
+    // With n = 1, choice i belongs to prompt i
+    std::vector<nlohmann::json> choices(count, nlohmann::json::array());
+    for (auto& choice : doc["choices"]) {
+        auto index = choice.is_object() ? choice.find("index") : choice.end();
+        if (index == choice.end() || !index->is_number_integer()) {
+            continue;
+        }
+        auto i = index->get<std::int64_t>();
+        if (i < 0 || i >= static_cast<std::int64_t>(count)) {
+            continue;
+        }
+        choice["index"] = 0;
+        choices[i].push_back(std::move(choice));
+    }
+
+    nlohmann::json usage;
+    if (doc.contains("usage") && doc["usage"].is_object()) {
+        usage = std::move(doc["usage"]);
+    }
+    doc.erase("choices");
+    doc.erase("usage");
+
+    std::vector<server::HttpResponse> responses;
+    responses.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (choices[i].empty()) {
+            responses.push_back(error_response(http::status::bad_gateway,
+                R"({"error": "Batched backend response has no choice for this prompt"})"));
+            continue;
+        }
+
+        auto item = doc;
+        item["choices"] = std::move(choices[i]);
+
+        // Per-prompt usage is not reported for a batch; apportion it evenly
+        if (!usage.is_null()) {
+            auto item_usage = usage;
+            for (const char* field : {"prompt_tokens", "completion_tokens", "total_tokens"}) {
+                if (item_usage.contains(field) && item_usage[field].is_number_integer()) {
+                    item_usage[field] = share(item_usage[field].get<std::int64_t>(), i, count);
+                }
+            }
+            item["usage"] = std::move(item_usage);
+        }
+
+        responses.push_back(server::HttpResponse{
+            .status = response.status,
+            .content_type = response.content_type,
+            .body = item.dump(),
+            .headers = response.headers
+        });
+    }
+    return responses;
+}
+
+} // namespace ntonix::proxy
@@ -0,0 +1,115 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Micro Batcher - Combines small completion requests into batched backend calls
+ *
+ * Inference servers process one /v1/completions call with an array "prompt"
+ * far more efficiently than the same prompts sent as separate requests.
+ * Concurrent non-streaming completion requests with identical parameters
+ * are collected for a few milliseconds, sent as one batched request, and
+ * the response's choices are split back out to each waiting client.
+ */
+
+#ifndef NTONIX_PROXY_MICRO_BATCHER_HPP
+#define NTONIX_PROXY_MICRO_BATCHER_HPP
+
+#include "server/connection.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ntonix::proxy {
+
+/**
+ * Configuration for micro-batching
+ */
+struct MicroBatcherConfig {
+    std::size_t max_batch_size{16};                  // Prompts per backend request
+    std::chrono::microseconds max_wait{5000};        // Longest the first request waits for others
+    std::chrono::milliseconds result_timeout{60000}; // Longest a request waits for its batch's response
+};
+
+/**
+ * Micro Batcher - coalesces compatible completion requests into one backend call
+ *
+ * Requests are compatible when they go to the same route with the same
+ * credentials, X-Request-Timeout and X-Priority headers, and every body
+ * field except "prompt" is identical. The first
+ * request of a batch waits up to max_wait (or until max_batch_size requests
+ * have joined), then sends the batch through the dispatch function on its
+ * own thread; the others block until the split response is ready.
+ *
+ * Requests that cannot be batched (streaming, prompts that are already
+ * arrays or token lists, n/best_of other than 1) are left to the caller.
+ * Thread-safe.
+ */
+class MicroBatcher {
+public:
+    /**
+     * Sends a (batched) request to a backend and returns its response
+     */
+    using Dispatch = std::function<server::HttpResponse(const server::HttpRequest&)>;
+
+    MicroBatcher(const MicroBatcherConfig& config, Dispatch dispatch);
+
+    // Non-copyable
+    MicroBatcher(const MicroBatcher&) = delete;
+    MicroBatcher& operator=(const MicroBatcher&) = delete;
+
+    /**
+     * Submit a completion request for batching
+     * @return The request's own response, or nullopt if the request cannot
+     *         be batched and should be forwarded on its own
+     */
+    std::optional<server::HttpResponse> submit(const server::HttpRequest& request);
+
+    const MicroBatcherConfig& config() const { return config_; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct Batch {
+        std::string params;                  // Shared body fields, serialized without "prompt"
+        std::vector<std::string> prompts;
+        std::vector<clock::time_point> arrivals;
+        clock::time_point opened;
+        clock::time_point sealed_at;
+        bool sealed{false};                  // No longer accepting requests
+        bool done{false};                    // Responses are ready
+        std::vector<server::HttpResponse> responses;
+        std::condition_variable cv;
+    };
+
+    /**
+     * Send a sealed batch and hand each member its response
+     */
+    void dispatch_batch(const std::shared_ptr<Batch>& batch, const server::HttpRequest& leader_request);
+
+    /**
+     * Split a batched response into one response per prompt
+     */
+    static std::vector<server::HttpResponse> split_response(const server::HttpResponse& response,
+                                                            std::size_t count);
+
+    /**
+     * Remove the batch from the open table (mutex_ held)
+     */
+    void seal_locked(const std::string& key, const std::shared_ptr<Batch>& batch);
+
+    MicroBatcherConfig config_;
+    Dispatch dispatch_;
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Batch>> open_;   // Batches still accepting requests
+};
+
+} // namespace ntonix::proxy
+
+#endif // NTONIX_PROXY_MICRO_BATCHER_HPP
@@ -0,0 +1,346 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Rate Limiter implementation
+ */
+
+#include "proxy/rate_limiter.hpp"
+#include "proxy/tenant.hpp"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace ntonix::proxy {
+
+namespace {
+
+constexpr std::size_t kProbeSlots = 8;
+constexpr std::size_t kMaxLineBytes = 1024 * 1024;
+
+std::size_t round_up_pow2(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+/**
+ * Bytes of text in a chat message "content" (string or array of parts)
+ */
+std::size_t content_bytes(const nlohmann::json& content) {
+    if (content.is_string()) {
+        return content.get_ref<const std::string&>().size();
+    }
+    std::size_t bytes = 0;
+    if (content.is_array()) {
+        for (const auto& part : content) {
+            if (part.is_string()) {
+                bytes += part.get_ref<const std::string&>().size();
+            } else if (part.is_object() && part.contains("text") && part["text"].is_string()) {
+                bytes += part["text"].get_ref<const std::string&>().size();
+            }
+        }
+    }
+    return bytes;
+}
+
+} // namespace
+
+// ============================================================================
+// TokenBucketTable Implementation
+// ============================================================================
+
+TokenBucketTable::TokenBucketTable(const TokenBucketConfig& config, std::size_t slots)
+    : interval_ns_(static_cast<std::int64_t>(1e9 / std::max(config.tokens_per_second, 1e-3)))
+    , tolerance_ns_(static_cast<std::int64_t>(std::max(config.burst_tokens, 1.0) * interval_ns_))
+    , capacity_tokens_(static_cast<std::int64_t>(std::max(config.burst_tokens, 1.0)))
+    , mask_(round_up_pow2(std::max<std::size_t>(slots, kProbeSlots)) - 1)
+    , slots_(std::make_unique<Slot[]>(mask_ + 1))
+{
+}
+
+std::int64_t TokenBucketTable::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TokenBucketTable::Slot& TokenBucketTable::slot_for(std::uint64_t key, std::int64_t now) {
+    key = std::max<std::uint64_t>(key, 1);  // 0 marks an unused slot
+    std::size_t home = key & mask_;
+
+    // Existing bucket first, so a key never escapes its debt by claiming an earlier slot
+    for (std::size_t i = 0; i < kProbeSlots; ++i) {
+        auto& slot = slots_[(home + i) & mask_];
+        if (slot.key.load(std::memory_order_acquire) == key) {
+            return slot;
+        }
+    }
+
+    // Claim a slot that is unused or whose bucket has fully refilled (holds no state)
+    for (std::size_t i = 0; i < kProbeSlots; ++i) {
+        auto& slot = slots_[(home + i) & mask_];
+        auto current = slot.key.load(std::memory_order_acquire);
+        if (current != 0 && slot.tat.load(std::memory_order_relaxed) > now) {
+            continue;
+        }
+        if (slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel) || current == key) {
+            return slot;
+        }
+    }
+
+    // Table crowded around this key: share the home bucket
+    return slots_[home];
+}
+
+std::optional<std::chrono::nanoseconds> TokenBucketTable::try_charge(std::uint64_t key, std::int64_t tokens) {
+    auto now = now_ns();
+    auto& slot = slot_for(key, now);
+    auto cost = tokens * interval_ns_;
+
+    auto tat = slot.tat.load(std::memory_order_relaxed);
+    while (true) {
+        auto next = std::max(tat, now) + cost;
+        if (next - now > tolerance_ns_) {
+            return std::chrono::nanoseconds(next - now - tolerance_ns_);
+        }
+        if (slot.tat.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+    }
+}
+
+void TokenBucketTable::adjust(std::uint64_t key, std::int64_t tokens) {
+    auto now = now_ns();
+    auto& slot = slot_for(key, now);
+    auto delta = tokens * interval_ns_;
+
+    // A refund can at most refill the bucket, never bank credit beyond it
+    auto tat = slot.tat.load(std::memory_order_relaxed);
+    while (!slot.tat.compare_exchange_weak(tat, std::max(now, std::max(tat, now) + delta),
+                                           std::memory_order_relaxed)) {
+    }
+}
+
+// ============================================================================
+// Token accounting helpers
+// ============================================================================
+
+TokenEstimate estimate_request_tokens(std::string_view body, std::uint32_t default_max_tokens,
+                                      std::int64_t max_tokens_limit) {
+    TokenEstimate estimate;
+    estimate.max_tokens = default_max_tokens;
+
+    auto request = nlohmann::json::parse(body, nullptr, false);
+    if (request.is_discarded() || !request.is_object()) {
+        estimate.prompt_tokens = static_cast<std::int64_t>(body.size() / 4) + 1;
+        return estimate;
+    }
+
+    std::size_t bytes = 0;
+    if (auto it = request.find("messages"); it != request.end() && it->is_array()) {
+        for (const auto& message : *it) {
+            if (message.is_object() && message.contains("content")) {
+                bytes += content_bytes(message["content"]);
+            }
+        }
+    }
+    for (const char* field : {"prompt", "input"}) {
+        if (auto it = request.find(field); it != request.end()) {
+            bytes += content_bytes(*it);
+        }
+    }
+    estimate.prompt_tokens = static_cast<std::int64_t>(bytes / 4) + 1;
+
+    for (const char* field : {"max_tokens", "max_completion_tokens"}) {
+        if (auto it = request.find(field); it != request.end() && it->is_number_integer()) {
+            // Client supplied: a huge value must not overflow the estimate
+            estimate.max_tokens = std::clamp<std::int64_t>(it->get<std::int64_t>(), 0, max_tokens_limit);
+            break;
+        }
+    }
+    return estimate;
+}
+
+std::optional<std::int64_t> parse_usage_tokens(std::string_view json) {
+    auto doc = nlohmann::json::parse(json, nullptr, false);
+    if (doc.is_discarded() || !doc.is_object()) {
+        return std::nullopt;
+    }
+
+    auto it = doc.find("usage");
+    if (it == doc.end() || !it->is_object()) {
+        return std::nullopt;
+    }
+    const auto& usage = *it;
+
+    if (usage.contains("total_tokens") && usage["total_tokens"].is_number_integer()) {
+        return usage["total_tokens"].get<std::int64_t>();
+    }
+    std::int64_t total = 0;
+    bool found = false;
+    for (const char* field : {"prompt_tokens", "completion_tokens"}) {
+        if (usage.contains(field) && usage[field].is_number_integer()) {
+            total += usage[field].get<std::int64_t>();
+            found = true;
+        }
+    }
+    return found ? std::optional<std::int64_t>(total) : std::nullopt;
+}
+
+// ============================================================================
+// RateCharge Implementation
+// ============================================================================
+
+RateCharge::RateCharge(RateCharge&& other) noexcept
+    : limiter_(other.limiter_)
+    , key_hash_(other.key_hash_)
+    , ip_hash_(other.ip_hash_)
+    , charged_(other.charged_) {
+    other.limiter_ = nullptr;
+}
+
+RateCharge& RateCharge::operator=(RateCharge&& other) noexcept {
+    if (this != &other) {
+        limiter_ = other.limiter_;
+        key_hash_ = other.key_hash_;
+        ip_hash_ = other.ip_hash_;
+        charged_ = other.charged_;
+        other.limiter_ = nullptr;
+    }
+    return *this;
+}
+
+void RateCharge::settle(std::int64_t actual_tokens) {
+    if (!limiter_) {
+        return;
+    }
+    actual_tokens = std::max<std::int64_t>(actual_tokens, 0);
+    if (actual_tokens != charged_) {
+        limiter_->adjust(key_hash_, ip_hash_, actual_tokens - charged_);
+        spdlog::trace("RateCharge: Settled {} estimated tokens as {}", charged_, actual_tokens);
+    }
+    charged_ = actual_tokens;
+    limiter_ = nullptr;
+}
+
+void RateCharge::settle_response(std::string_view body, bool success, std::int64_t prompt_tokens) {
+    if (auto usage = parse_usage_tokens(body)) {
+        settle(*usage);
+    } else if (!success) {
+        settle(prompt_tokens);
+    }
+}
+
+// ============================================================================
+// RateLimiter Implementation
+// ============================================================================
+
+RateLimiter::RateLimiter(const RateLimiterConfig& config)
+    : config_(config)
+    , key_buckets_(config.per_key, config.table_slots)
+    , ip_buckets_(config.per_ip, config.table_slots)
+{
+    spdlog::debug("RateLimiter: Created with per_key={}/s (burst {}), per_ip={}/s (burst {})",
+                  config_.per_key.tokens_per_second, config_.per_key.burst_tokens,
+                  config_.per_ip.tokens_per_second, config_.per_ip.burst_tokens);
+}
+
+RateDecision RateLimiter::try_acquire(std::string_view authorization, std::string_view client_ip,
+                                      std::int64_t tokens) {
+    RateDecision decision;
+
+    // Keys are identified exactly as for fair queueing; anonymous requests only have an IP bucket
+    std::uint64_t key_hash = authorization.empty() ? 0 : tenant_id(authorization, client_ip);
+    std::uint64_t ip_hash = std::max<std::uint64_t>(std::hash<std::string_view>{}(client_ip), 1);
+
+    // A request larger than a whole bucket is charged one full bucket, or it could never pass
+    tokens = std::clamp<std::int64_t>(tokens, 1, capacity());
+
+    auto refuse = [&](std::chrono::nanoseconds wait) {
+        decision.retry_after = std::max(std::chrono::ceil<std::chrono::seconds>(wait), std::chrono::seconds{1});
+        return std::move(decision);
+    };
+
+    if (key_hash != 0) {
+        if (auto wait = key_buckets_.try_charge(key_hash, tokens)) {
+            return refuse(*wait);
+        }
+    }
+    if (auto wait = ip_buckets_.try_charge(ip_hash, tokens)) {
+        if (key_hash != 0) {
+            key_buckets_.adjust(key_hash, -tokens);
+        }
+        return refuse(*wait);
+    }
+
+    decision.allowed = true;
+    decision.charge.limiter_ = this;
+    decision.charge.key_hash_ = key_hash;
+    decision.charge.ip_hash_ = ip_hash;
+    decision.charge.charged_ = tokens;
+    return decision;
+}
+
+void RateLimiter::adjust(std::uint64_t key_hash, std::uint64_t ip_hash, std::int64_t tokens) {
+    if (key_hash != 0) {
+        key_buckets_.adjust(key_hash, tokens);
+    }
+    ip_buckets_.adjust(ip_hash, tokens);
+}
+
+// ============================================================================
+// StreamUsageMeter Implementation
+// ============================================================================
+
+StreamUsageMeter::StreamUsageMeter(RateCharge charge, std::int64_t prompt_tokens)
+    : charge_(std::move(charge))
+    , prompt_tokens_(prompt_tokens) {
+}
+
+void StreamUsageMeter::on_stream_data(const char* data, std::size_t size) {
+    partial_line_.append(data, size);
+
+    std::size_t start = 0;
+    for (auto end = partial_line_.find('\n'); end != std::string::npos; end = partial_line_.find('\n', start)) {
+        scan_line(std::string_view(partial_line_).substr(start, end - start));
+        start = end + 1;
+    }
+    partial_line_.erase(0, start);
+
+    if (partial_line_.size() > kMaxLineBytes) {
+        partial_line_.clear();
+    }
+}
+
+void StreamUsageMeter::scan_line(std::string_view line) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    if (!line.starts_with("data:")) {
+        return;
+    }
+    line.remove_prefix(5);
+    if (!line.empty() && line.front() == ' ') {
+        line.remove_prefix(1);
+    }
+
+    if (line.find("\"usage\"") != std::string_view::npos) {
+        if (auto usage = parse_usage_tokens(line)) {
+            usage_tokens_ = usage;
+        }
+    }
+    if (line.find("\"content\"") != std::string_view::npos) {
+        ++content_chunks_;
+    }
+}
+
+void StreamUsageMeter::on_stream_end(const StreamResult& /*result*/) {
+    // Without reported usage, each content chunk is roughly one token
+    charge_.settle(usage_tokens_.value_or(prompt_tokens_ + content_chunks_));
+}
+
+} // namespace ntonix::proxy
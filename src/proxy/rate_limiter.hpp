@@ -0,0 +1,252 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Rate Limiter - Token-aware per-key and per-client limits
+ *
+ * Requests are charged by their estimated backend cost in LLM tokens
+ * (prompt estimate plus max_tokens) rather than by count, and the charge
+ * is corrected from the backend's reported usage once the response is in.
+ */
+
+#ifndef NTONIX_PROXY_RATE_LIMITER_HPP
+#define NTONIX_PROXY_RATE_LIMITER_HPP
+
+#include "proxy/stream_pipe.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ntonix::proxy {
+
+/**
+ * Rate and capacity of one bucket family
+ */
+struct TokenBucketConfig {
+    double tokens_per_second{1000.0};   // Refill rate
+    double burst_tokens{60000.0};       // Bucket capacity
+};
+
+/**
+ * Lock-free table of token buckets keyed by hash
+ *
+ * Each bucket is one atomic using the GCRA formulation of a token bucket:
+ * it stores the theoretical arrival time (TAT) at which the bucket would
+ * be full again. Charging n tokens advances the TAT by n emission
+ * intervals; the charge is refused if that would put the TAT more than
+ * one bucket capacity ahead of now. Every operation is a single CAS loop.
+ *
+ * Buckets live in a fixed open-addressed table. A slot whose bucket has
+ * fully refilled holds no state and may be taken over by another key, so
+ * the table never needs locking or cleanup. If no slot is free within the
+ * probe window the key shares a bucket, which only errs towards limiting.
+ */
+class TokenBucketTable {
+public:
+    TokenBucketTable(const TokenBucketConfig& config, std::size_t slots);
+
+    // Non-copyable
+    TokenBucketTable(const TokenBucketTable&) = delete;
+    TokenBucketTable& operator=(const TokenBucketTable&) = delete;
+
+    /**
+     * Charge tokens if the bucket can afford them
+     * @return nullopt if charged, else how long until the charge would fit
+     */
+    std::optional<std::chrono::nanoseconds> try_charge(std::uint64_t key, std::int64_t tokens);
+
+    /**
+     * Unconditionally add (positive) or refund (negative) tokens
+     * Used to correct a charge once actual usage is known.
+     */
+    void adjust(std::uint64_t key, std::int64_t tokens);
+
+    /**
+     * Largest single charge the bucket can ever accept
+     */
+    std::int64_t capacity() const { return capacity_tokens_; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> key{0};   // 0 = never used
+        std::atomic<std::int64_t> tat{0};    // Theoretical arrival time (ns, steady clock)
+    };
+
+    static std::int64_t now_ns();
+
+    /**
+     * Find the key's slot, claiming a free or idle one if needed
+     */
+    Slot& slot_for(std::uint64_t key, std::int64_t now);
+
+    std::int64_t interval_ns_;      // Nanoseconds to refill one token
+    std::int64_t tolerance_ns_;     // Bucket capacity expressed as time
+    std::int64_t capacity_tokens_;
+    std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+};
+
+/**
+ * Configuration for the rate limiter
+ */
+struct RateLimiterConfig {
+    TokenBucketConfig per_key{};             // Buckets per API key
+    TokenBucketConfig per_ip{};              // Buckets per client IP
+    std::uint32_t default_max_tokens{256};   // Completion estimate when max_tokens is absent
+    std::size_t table_slots{4096};           // Buckets per table (rounded up to a power of two)
+};
+
+/**
+ * Estimated cost of a completion request
+ */
+struct TokenEstimate {
+    std::int64_t prompt_tokens{0};
+    std::int64_t max_tokens{0};
+
+    // Saturates rather than overflow (both parts are non-negative)
+    std::int64_t total() const {
+        return max_tokens > std::numeric_limits<std::int64_t>::max() - prompt_tokens
+            ? std::numeric_limits<std::int64_t>::max()
+            : prompt_tokens + max_tokens;
+    }
+};
+
+/**
+ * Estimate a request's token cost from its JSON body
+ * The prompt (chat messages, completion prompt or embedding input) is
+ * approximated at four bytes per token of text.
+ * @param max_tokens_limit Cap on the client's max_tokens (e.g. the bucket capacity)
+ */
+TokenEstimate estimate_request_tokens(std::string_view body, std::uint32_t default_max_tokens,
+                                      std::int64_t max_tokens_limit = std::numeric_limits<std::int64_t>::max());
+
+/**
+ * Total tokens from the "usage" object of a completion or final stream chunk
+ */
+std::optional<std::int64_t> parse_usage_tokens(std::string_view json);
+
+class RateLimiter;
+
+/**
+ * Tokens charged for one request, correctable once actual usage is known
+ *
+ * Move-only. If never settled, the estimate stands.
+ */
+class RateCharge {
+public:
+    RateCharge() = default;
+
+    RateCharge(RateCharge&& other) noexcept;
+    RateCharge& operator=(RateCharge&& other) noexcept;
+    RateCharge(const RateCharge&) = delete;
+    RateCharge& operator=(const RateCharge&) = delete;
+
+    /**
+     * Replace the estimate with the actual token count (0 = full refund)
+     */
+    void settle(std::int64_t actual_tokens);
+
+    /**
+     * Settle from a JSON completion: its usage if reported; the prompt
+     * alone if the request failed; otherwise the estimate stands
+     */
+    void settle_response(std::string_view body, bool success, std::int64_t prompt_tokens);
+
+    std::int64_t charged() const { return charged_; }
+
+private:
+    friend class RateLimiter;
+
+    RateLimiter* limiter_{nullptr};
+    std::uint64_t key_hash_{0};   // 0 = no per-key bucket
+    std::uint64_t ip_hash_{0};
+    std::int64_t charged_{0};
+};
+
+/**
+ * Result of a rate limit check
+ */
+struct RateDecision {
+    bool allowed{false};
+    std::chrono::seconds retry_after{0};   // When refused: suggested Retry-After
+    RateCharge charge;                     // When allowed: the charge to settle
+};
+
+/**
+ * Token-aware rate limiter with per-API-key and per-client-IP buckets
+ *
+ * A request must fit both its key's bucket (if it has a key) and its
+ * client IP's bucket. Thread-safe and lock-free.
+ */
+class RateLimiter {
+public:
+    explicit RateLimiter(const RateLimiterConfig& config = {});
+
+    // Non-copyable
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    /**
+     * Charge a request's estimated tokens
+     * @param authorization Authorization header (empty = anonymous)
+     * @param client_ip Client address
+     * @param tokens Estimated tokens (clamped to bucket capacity)
+     */
+    RateDecision try_acquire(std::string_view authorization, std::string_view client_ip,
+                             std::int64_t tokens);
+
+    const RateLimiterConfig& config() const { return config_; }
+
+    /**
+     * Largest charge a request can be made to pay (the smaller bucket)
+     */
+    std::int64_t capacity() const { return std::min(key_buckets_.capacity(), ip_buckets_.capacity()); }
+
+private:
+    friend class RateCharge;
+
+    void adjust(std::uint64_t key_hash, std::uint64_t ip_hash, std::int64_t tokens);
+
+    RateLimiterConfig config_;
+    TokenBucketTable key_buckets_;
+    TokenBucketTable ip_buckets_;
+};
+
+/**
+ * Stream observer that settles a rate charge from the streamed response
+ *
+ * Uses the usage object of the final chunk when the backend sends one,
+ * otherwise counts content chunks as completion tokens.
+ */
+class StreamUsageMeter : public StreamObserver {
+public:
+    StreamUsageMeter(RateCharge charge, std::int64_t prompt_tokens);
+
+    // StreamObserver
+    void on_stream_data(const char* data, std::size_t size) override;
+    void on_stream_end(const StreamResult& result) override;
+
+    /**
+     * The charge, for settling when the backend answered without streaming
+     */
+    RateCharge& charge() { return charge_; }
+
+private:
+    void scan_line(std::string_view line);
+
+    RateCharge charge_;
+    std::int64_t prompt_tokens_;
+    std::string partial_line_;
+    std::int64_t content_chunks_{0};
+    std::optional<std::int64_t> usage_tokens_;
+};
+
+} // namespace ntonix::proxy
+
+#endif // NTONIX_PROXY_RATE_LIMITER_HPP
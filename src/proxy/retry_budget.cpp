@@ -0,0 +1,67 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Retry Budget implementation
+ */
+
+#include "proxy/retry_budget.hpp"
+
+#include <algorithm>
+
+namespace ntonix::proxy {
+
+RetryBudget::RetryBudget(const RetryBudgetConfig& config)
+    : config_(config)
+    , deposit_milli_(static_cast<std::int64_t>(std::max(0.0, config.retry_ratio) * kMilli))
+    , max_balance_milli_(static_cast<std::int64_t>(config.max_balance) * kMilli)
+{
+}
+
+void RetryBudget::record_request() {
+    if (deposit_milli_ == 0) {
+        return;
+    }
+
+    // Add the deposit, but never bank more than max_balance
+    auto current = balance_milli_.load(std::memory_order_relaxed);
+    while (current < max_balance_milli_) {
+        auto desired = std::min(current + deposit_milli_, max_balance_milli_);
+        if (balance_milli_.compare_exchange_weak(current, desired, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+bool RetryBudget::try_acquire() {
+    auto current = balance_milli_.load(std::memory_order_relaxed);
+    while (current >= kMilli) {
+        if (balance_milli_.compare_exchange_weak(current, current - kMilli, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+
+    return try_acquire_reserve();
+}
+
+double RetryBudget::balance() const {
+    return static_cast<double>(balance_milli_.load(std::memory_order_relaxed)) / kMilli;
+}
+
+bool RetryBudget::try_acquire_reserve() {
+    if (config_.min_retries_per_second == 0) {
+        return false;
+    }
+
+    auto now_second = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    // Start a new reserve window if the second has rolled over
+    auto window = reserve_second_.load(std::memory_order_relaxed);
+    if (window != now_second &&
+        reserve_second_.compare_exchange_strong(window, now_second, std::memory_order_relaxed)) {
+        reserve_used_.store(0, std::memory_order_relaxed);
+    }
+
+    return reserve_used_.fetch_add(1, std::memory_order_relaxed) < config_.min_retries_per_second;
+}
+
+} // namespace ntonix::proxy
@@ -0,0 +1,82 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Retry Budget - Caps retries to a fraction of regular traffic
+ */
+
+#ifndef NTONIX_PROXY_RETRY_BUDGET_HPP
+#define NTONIX_PROXY_RETRY_BUDGET_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ntonix::proxy {
+
+/**
+ * Configuration for the retry budget
+ */
+struct RetryBudgetConfig {
+    double retry_ratio{0.2};                      // Retries allowed per request (0.2 = 20% extra load)
+    std::uint32_t min_retries_per_second{10};     // Floor so low-traffic gateways can still retry
+    std::uint32_t max_balance{1000};              // Cap on banked retries (absorbs bursts, not outages)
+};
+
+/**
+ * Retry budget - prevents retry storms when backends are failing
+ *
+ * Every forwarded request deposits `retry_ratio` tokens; every retry
+ * withdraws one. When the balance is exhausted, retries are only allowed
+ * from a small per-second reserve. This keeps the extra load generated by
+ * retries proportional to real traffic, so a cluster-wide outage cannot
+ * be amplified into N times the request rate.
+ *
+ * Lock-free: tokens are tracked as fixed-point milli-tokens in atomics.
+ */
+class RetryBudget {
+public:
+    explicit RetryBudget(const RetryBudgetConfig& config = {});
+
+    // Non-copyable
+    RetryBudget(const RetryBudget&) = delete;
+    RetryBudget& operator=(const RetryBudget&) = delete;
+
+    /**
+     * Record an original (non-retry) request, earning retry tokens
+     */
+    void record_request();
+
+    /**
+     * Try to spend one retry token
+     * @return true if the retry is within budget
+     */
+    bool try_acquire();
+
+    /**
+     * Current balance in whole retries (for diagnostics)
+     */
+    double balance() const;
+
+    const RetryBudgetConfig& config() const { return config_; }
+
+private:
+    static constexpr std::int64_t kMilli = 1000;
+
+    /**
+     * Try to take a retry from the per-second reserve
+     */
+    bool try_acquire_reserve();
+
+    RetryBudgetConfig config_;
+    std::int64_t deposit_milli_;
+    std::int64_t max_balance_milli_;
+
+    std::atomic<std::int64_t> balance_milli_{0};
+
+    // Per-second reserve tracking
+    std::atomic<std::int64_t> reserve_second_{0};
+    std::atomic<std::uint32_t> reserve_used_{0};
+};
+
+} // namespace ntonix::proxy
+
+#endif // NTONIX_PROXY_RETRY_BUDGET_HPP
@@ -0,0 +1,165 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * SSE Scanner implementation
+ */
+
+#include "proxy/sse_scanner.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NTONIX_SSE_SCANNER_X86 1
+#endif
+
+namespace ntonix::proxy {
+
+namespace {
+
+using NewlineFinder = const char* (*)(const char* begin, const char* end);
+
+const char* find_newline_scalar(const char* p, const char* end) {
+    while (p != end && *p != '\n') {
+        ++p;
+    }
+    return p;
+}
+
+#ifdef NTONIX_SSE_SCANNER_X86
+
+__attribute__((target("sse2")))
+const char* find_newline_sse2(const char* p, const char* end) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return find_newline_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* find_newline_avx2(const char* p, const char* end) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (; end - p >= 32; p += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return find_newline_sse2(p, end);
+}
+
+#endif
+
+/**
+ * Widest newline search the CPU supports, chosen on first use
+ */
+NewlineFinder newline_finder() {
+    static const NewlineFinder finder = [] {
+#ifdef NTONIX_SSE_SCANNER_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return &find_newline_avx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return &find_newline_sse2;
+        }
+#endif
+        return &find_newline_scalar;
+    }();
+    return finder;
+}
+
+} // namespace
+
+const char* SseScanner::implementation() {
+#ifdef NTONIX_SSE_SCANNER_X86
+    if (newline_finder() == &find_newline_avx2) {
+        return "avx2";
+    }
+    if (newline_finder() == &find_newline_sse2) {
+        return "sse2";
+    }
+#endif
+    return "scalar";
+}
+
+SseScanResult SseScanner::scan(const char* data, std::size_t size) {
+    SseScanResult result;
+    auto find_newline = newline_finder();
+    const char* end = data + size;
+    const char* line_start = data;
+
+    for (const char* newline = find_newline(data, end); newline != end; newline = find_newline(line_start, end)) {
+        auto tail = static_cast<std::size_t>(newline - line_start);
+        auto offset = static_cast<std::size_t>(newline - data) + 1;
+
+        if (line_length_ == 0) {
+            end_line(std::string_view(line_start, tail), false, offset, result);
+        } else {
+            // Line continued from an earlier scan: complete its head from this data
+            char head[kMaxLine];
+            auto carried = std::min(line_length_, kMaxLine);
+            auto taken = std::min(kMaxLine - carried, tail);
+            std::memcpy(head, line_, carried);
+            std::memcpy(head + carried, line_start, taken);
+            line_length_ += tail;
+            end_line(std::string_view(head, carried + taken), line_length_ > kMaxLine, offset, result);
+            line_length_ = 0;
+        }
+        line_start = newline + 1;
+    }
+
+    // Carry the head of an unfinished line into the next scan
+    if (line_start != end) {
+        auto rest = static_cast<std::size_t>(end - line_start);
+        if (line_length_ < kMaxLine) {
+            std::memcpy(line_ + line_length_, line_start, std::min(kMaxLine - line_length_, rest));
+        }
+        line_length_ += rest;
+    }
+
+    return result;
+}
+
+void SseScanner::end_line(std::string_view line, bool truncated, std::size_t end_offset, SseScanResult& result) {
+    // A truncated line is longer than kMaxLine, so it is never blank or [DONE]
+    if (!truncated && !line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    if (!truncated && line.empty()) {
+        if (event_lines_ > 0) {
+            ++events_;
+            ++result.events;
+            result.last_boundary = end_offset;
+            if (data_lines_ == 1 && done_line_ && !done_) {
+                done_ = true;
+                result.done = true;
+            }
+        }
+        event_lines_ = 0;
+        data_lines_ = 0;
+        done_line_ = false;
+        return;
+    }
+
+    ++event_lines_;
+    if (line.starts_with("data:")) {
+        ++data_lines_;
+        auto value = line.substr(5);
+        if (!value.empty() && value.front() == ' ') {
+            value.remove_prefix(1);
+        }
+        if (!truncated && value == "[DONE]") {
+            done_line_ = true;
+        }
+    }
+}
+
+} // namespace ntonix::proxy
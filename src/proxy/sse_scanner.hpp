@@ -0,0 +1,91 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * SSE Scanner - Incremental event boundary and [DONE] detection
+ *
+ * Backend streams arrive in reads that split events (and lines) at
+ * arbitrary points. The scanner carries line state from one read to the
+ * next, so event boundaries and the terminal "data: [DONE]" event are
+ * recognised exactly wherever the reads fall, while "[DONE]" inside token
+ * text is not. Newlines are located with AVX2 or SSE2 where the CPU has
+ * them (chosen once at runtime) and a scalar loop otherwise.
+ */
+
+#ifndef NTONIX_PROXY_SSE_SCANNER_HPP
+#define NTONIX_PROXY_SSE_SCANNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace ntonix::proxy {
+
+/**
+ * What one call to SseScanner::scan() found
+ */
+struct SseScanResult {
+    std::size_t events{0};          // Events completed within the scanned data
+    std::size_t last_boundary{0};   // Offset just past the last completed event (0 = none completed)
+    bool done{false};               // The terminal [DONE] event completed within the scanned data
+};
+
+/**
+ * SSE Scanner - splits a byte stream into Server-Sent Events
+ *
+ * An event ends at a blank line; lines end with LF or CRLF. The terminal
+ * event is one whose only data line is "[DONE]" ("data: [DONE]" or
+ * "data:[DONE]"); comments and other fields in it are allowed. Not
+ * thread-safe: one scanner per stream.
+ */
+class SseScanner {
+public:
+    /**
+     * Scan the next bytes of the stream
+     */
+    SseScanResult scan(const char* data, std::size_t size);
+
+    SseScanResult scan(std::string_view data) { return scan(data.data(), data.size()); }
+
+    /**
+     * Events completed so far
+     */
+    std::uint64_t events() const { return events_; }
+
+    /**
+     * True once the terminal [DONE] event has completed
+     */
+    bool done() const { return done_; }
+
+    /**
+     * Forget all state (start of a new stream)
+     */
+    void reset() { *this = SseScanner{}; }
+
+    /**
+     * Newline search in use: "avx2", "sse2" or "scalar"
+     */
+    static const char* implementation();
+
+private:
+    /**
+     * Longest line the scanner needs to look at ("data: [DONE]\r")
+     */
+    static constexpr std::size_t kMaxLine = 13;
+
+    /**
+     * Classify a completed line (without its LF)
+     * @param truncated Only the line's first kMaxLine bytes are available
+     */
+    void end_line(std::string_view line, bool truncated, std::size_t end_offset, SseScanResult& result);
+
+    char line_[kMaxLine]{};         // Start of a line continued from an earlier scan
+    std::size_t line_length_{0};    // Full length of that line so far
+    std::size_t event_lines_{0};    // Lines in the current event
+    std::size_t data_lines_{0};     // Data lines in the current event
+    bool done_line_{false};         // The current event has a "[DONE]" data line
+    bool done_{false};
+    std::uint64_t events_{0};
+};
+
+} // namespace ntonix::proxy
+
+#endif // NTONIX_PROXY_SSE_SCANNER_HPP
@@ -0,0 +1,183 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Stream Broadcast implementation
+ */
+
+#include "proxy/stream_broadcast.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace ntonix::proxy {
+
+// ============================================================================
+// StreamBroadcast Implementation
+// ============================================================================
+
+StreamBroadcast::StreamBroadcast(const StreamBroadcastConfig& config)
+    : config_(config) {
+}
+
+void StreamBroadcast::wake(std::unique_lock<std::mutex>& lock) {
+    auto waiters = std::move(waiters_);
+    waiters_.clear();
+    lock.unlock();
+    for (auto& wakeup : waiters) {
+        wakeup();
+    }
+}
+
+void StreamBroadcast::on_stream_start(const http::response_header<>& header) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    header_ = header;
+    started_ = true;
+    wake(lock);
+}
+
+void StreamBroadcast::on_stream_data(const char* data, std::size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    auto chunk = std::make_shared<const std::string>(data, size);
+    std::unique_lock<std::mutex> lock(mutex_);
+    chunks_.push_back(std::move(chunk));
+    buffered_bytes_ += size;
+
+    // Keep the replay buffer bounded; joiners behind the window get dropped
+    while (buffered_bytes_ > config_.max_buffer_bytes && chunks_.size() > 1) {
+        buffered_bytes_ -= chunks_.front()->size();
+        chunks_.pop_front();
+        ++base_index_;
+        if (!truncated_) {
+            truncated_ = true;
+            spdlog::debug("StreamBroadcast: Replay buffer exceeded {} bytes, closed to new joiners",
+                          config_.max_buffer_bytes);
+        }
+    }
+    wake(lock);
+}
+
+void StreamBroadcast::on_stream_end(const StreamResult& result) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_ = true;
+    succeeded_ = result.success && (result.done_marker_received || result.backend_closed);
+    wake(lock);
+}
+
+void StreamBroadcast::abandon() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_ = true;
+    wake(lock);
+}
+
+void StreamBroadcast::async_wait_started(Wakeup wakeup) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!started_ && !finished_) {
+            waiters_.push_back(std::move(wakeup));
+            return;
+        }
+    }
+    wakeup();
+}
+
+void StreamBroadcast::async_wait_data(std::size_t cursor, Wakeup wakeup) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cursor >= base_index_ + chunks_.size() && !finished_) {
+            waiters_.push_back(std::move(wakeup));
+            return;
+        }
+    }
+    wakeup();
+}
+
+std::optional<std::size_t> StreamBroadcast::join() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // A joiner must be able to replay the stream from its first byte
+    if (!started_ || truncated_ || (finished_ && !succeeded_)) {
+        return std::nullopt;
+    }
+
+    ++joiners_;
+    return std::size_t{0};
+}
+
+StreamBroadcast::ReadStatus StreamBroadcast::read(std::size_t& cursor, std::vector<Chunk>& out) {
+    out.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cursor < base_index_) {
+        return ReadStatus::dropped;
+    }
+
+    std::size_t available_end = base_index_ + chunks_.size();
+    if (cursor < available_end) {
+        for (std::size_t i = cursor; i < available_end; ++i) {
+            out.push_back(chunks_[i - base_index_]);
+        }
+        cursor = available_end;
+        return ReadStatus::data;
+    }
+
+    if (finished_) {
+        return ReadStatus::finished;
+    }
+
+    return ReadStatus::pending;
+}
+
+http::response_header<> StreamBroadcast::header() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return header_;
+}
+
+bool StreamBroadcast::succeeded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return finished_ && succeeded_;
+}
+
+std::size_t StreamBroadcast::joiner_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return joiners_;
+}
+
+// ============================================================================
+// StreamBroadcastRegistry Implementation
+// ============================================================================
+
+StreamBroadcastRegistry::StreamBroadcastRegistry(const StreamBroadcastConfig& config)
+    : config_(config) {
+}
+
+StreamBroadcast::Ptr StreamBroadcastRegistry::acquire(const cache::CacheKey& key, bool& leader) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = streams_.find(key);
+    if (it != streams_.end()) {
+        leader = false;
+        return it->second;
+    }
+
+    leader = true;
+    auto broadcast = std::make_shared<StreamBroadcast>(config_);
+    streams_.emplace(key, broadcast);
+    return broadcast;
+}
+
+void StreamBroadcastRegistry::release(const cache::CacheKey& key, const StreamBroadcast::Ptr& broadcast) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = streams_.find(key);
+    if (it != streams_.end() && it->second == broadcast) {
+        streams_.erase(it);
+    }
+}
+
+std::size_t StreamBroadcastRegistry::active_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streams_.size();
+}
+
+} // namespace ntonix::proxy
@@ -0,0 +1,191 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Stream Broadcast - Fan-out of one backend SSE stream to identical streaming clients
+ */
+
+#ifndef NTONIX_PROXY_STREAM_BROADCAST_HPP
+#define NTONIX_PROXY_STREAM_BROADCAST_HPP
+
+#include "cache/cache_key.hpp"
+#include "proxy/stream_pipe.hpp"
+
+#include <boost/beast/http.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ntonix::proxy {
+
+namespace http = boost::beast::http;
+
+/**
+ * Configuration for stream fan-out
+ */
+struct StreamBroadcastConfig {
+    std::size_t max_buffer_bytes{1024 * 1024};    // Replay buffer cap per shared stream
+    std::chrono::seconds start_timeout{30};       // How long a joiner waits for the leader's header
+};
+
+/**
+ * A single backend stream shared by a leader and any number of joiners
+ *
+ * The leader's StreamPipe feeds it through the StreamObserver interface.
+ * Every forwarded chunk is kept in a replay buffer so that late joiners can
+ * first catch up on what was already emitted and then follow live chunks,
+ * each at its own pace. Joiners never block on the broadcast: they read what
+ * is there and register a wakeup for when there is more.
+ *
+ * Memory is bounded by max_buffer_bytes: once the buffer overflows, the
+ * oldest chunks are dropped. From then on no new joiner can attach (its
+ * replay would be incomplete), and a joiner that falls behind the retained
+ * window is dropped rather than pinning memory.
+ */
+class StreamBroadcast : public StreamObserver {
+public:
+    using Ptr = std::shared_ptr<StreamBroadcast>;
+    using Chunk = std::shared_ptr<const std::string>;
+
+    /**
+     * Called once when a joiner's wait is over
+     * Runs on whichever thread changed the broadcast (the leader's strand), or
+     * on the caller's if the wait was already over, so it should only post work.
+     */
+    using Wakeup = std::function<void()>;
+
+    /**
+     * Outcome of a joiner's read
+     */
+    enum class ReadStatus {
+        data,       // New chunks were returned
+        finished,   // Stream finished and all chunks were consumed
+        dropped,    // Joiner fell behind the retained window
+        pending     // No new chunks yet
+    };
+
+    explicit StreamBroadcast(const StreamBroadcastConfig& config = {});
+
+    // StreamObserver - called by the leader's pipe
+    void on_stream_start(const http::response_header<>& header) override;
+    void on_stream_data(const char* data, std::size_t size) override;
+    void on_stream_end(const StreamResult& result) override;
+    bool wants_completion() const override { return joiner_count() > 0; }
+
+    /**
+     * Mark the broadcast finished without streaming (leader failed before
+     * streaming started, or the backend sent a non-streaming response).
+     * Safe to call after on_stream_end.
+     */
+    void abandon();
+
+    /**
+     * Call `wakeup` once the leader has started streaming or the broadcast
+     * has finished (join() then tells which)
+     */
+    void async_wait_started(Wakeup wakeup);
+
+    /**
+     * Call `wakeup` once chunks beyond `cursor` are available or the
+     * broadcast has finished
+     */
+    void async_wait_data(std::size_t cursor, Wakeup wakeup);
+
+    /**
+     * Try to attach as a joiner
+     * @return Starting cursor (0) if the full replay is available, nullopt otherwise
+     */
+    std::optional<std::size_t> join();
+
+    /**
+     * Read the chunks available from `cursor` onwards, without waiting
+     * @param cursor Index of the next chunk to read (advanced on return)
+     * @param out Receives the chunks (shared, not copied)
+     */
+    ReadStatus read(std::size_t& cursor, std::vector<Chunk>& out);
+
+    /**
+     * Backend response header seen by the leader (valid once started)
+     */
+    http::response_header<> header() const;
+
+    /**
+     * True once the leader's stream ended cleanly ([DONE] or backend EOF)
+     */
+    bool succeeded() const;
+
+    /**
+     * Number of clients that joined this stream (excluding the leader)
+     */
+    std::size_t joiner_count() const;
+
+    const StreamBroadcastConfig& config() const { return config_; }
+
+private:
+    /**
+     * Run the registered wakeups (called with mutex_ held; releases it)
+     */
+    void wake(std::unique_lock<std::mutex>& lock);
+
+    StreamBroadcastConfig config_;
+
+    mutable std::mutex mutex_;
+    std::vector<Wakeup> waiters_;      // Joiners waiting for the start, a chunk or the end
+
+    http::response_header<> header_;
+    std::deque<Chunk> chunks_;
+    std::size_t base_index_{0};        // Index of chunks_.front() in the whole stream
+    std::size_t buffered_bytes_{0};
+    bool started_{false};
+    bool finished_{false};
+    bool succeeded_{false};
+    bool truncated_{false};            // Oldest chunks evicted; replay incomplete
+    std::size_t joiners_{0};
+};
+
+/**
+ * Registry of shared streams keyed by request CacheKey
+ */
+class StreamBroadcastRegistry {
+public:
+    explicit StreamBroadcastRegistry(const StreamBroadcastConfig& config = {});
+
+    // Non-copyable
+    StreamBroadcastRegistry(const StreamBroadcastRegistry&) = delete;
+    StreamBroadcastRegistry& operator=(const StreamBroadcastRegistry&) = delete;
+
+    /**
+     * Find the in-flight stream for a key or register a new one
+     * @param key Cache key of the streaming request
+     * @param leader Set to true if the caller created the stream and must forward it
+     */
+    StreamBroadcast::Ptr acquire(const cache::CacheKey& key, bool& leader);
+
+    /**
+     * Remove the leader's stream from the registry (new requests won't join it)
+     */
+    void release(const cache::CacheKey& key, const StreamBroadcast::Ptr& broadcast);
+
+    /**
+     * Number of streams currently shared
+     */
+    std::size_t active_count() const;
+
+    const StreamBroadcastConfig& config() const { return config_; }
+
+private:
+    StreamBroadcastConfig config_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<cache::CacheKey, StreamBroadcast::Ptr, cache::CacheKeyHash> streams_;
+};
+
+} // namespace ntonix::proxy
+
+#endif // NTONIX_PROXY_STREAM_BROADCAST_HPP
@@ -0,0 +1,57 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Stream Cache implementation
+ */
+
+#include "proxy/stream_cache.hpp"
+#include "cache/completion_codec.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace ntonix::proxy {
+
+StreamCacheWriter::StreamCacheWriter(std::shared_ptr<cache::LruCache> cache,
+                                     const cache::CacheKey& key,
+                                     std::size_t max_bytes,
+                                     bool finish_on_disconnect)
+    : cache_(std::move(cache))
+    , key_(key)
+    , max_bytes_(max_bytes)
+    , finish_on_disconnect_(finish_on_disconnect) {
+}
+
+void StreamCacheWriter::on_stream_data(const char* data, std::size_t size) {
+    if (overflowed_) {
+        return;
+    }
+    if (body_.size() + size > max_bytes_) {
+        overflowed_ = true;
+        body_.clear();
+        body_.shrink_to_fit();
+        spdlog::debug("StreamCacheWriter: Stream exceeded {} bytes, not caching key={}",
+                      max_bytes_, key_.to_string());
+        return;
+    }
+    body_.append(data, size);
+}
+
+void StreamCacheWriter::on_stream_end(const StreamResult& result) {
+    if (overflowed_ || !result.done_marker_received) {
+        return;
+    }
+
+    // Store clean SSE events so replays and JSON assembly need no further parsing
+    std::string events;
+    events.reserve(body_.size());
+    for (const auto& event : cache::split_sse_events(body_)) {
+        events += event;
+    }
+    if (events.empty()) {
+        return;
+    }
+
+    spdlog::debug("StreamCacheWriter: Cached stream key={}, size={}", key_.to_string(), events.size());
+    cache_->put(key_, std::move(events), std::string(cache::kSseContentType));
+}
+
+} // namespace ntonix::proxy
@@ -0,0 +1,54 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Stream Cache - Tee of a forwarded SSE stream into the response cache
+ */
+
+#ifndef NTONIX_PROXY_STREAM_CACHE_HPP
+#define NTONIX_PROXY_STREAM_CACHE_HPP
+
+#include "cache/cache_key.hpp"
+#include "cache/lru_cache.hpp"
+#include "proxy/stream_pipe.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace ntonix::proxy {
+
+/**
+ * Stream observer that records a stream and stores it in the cache
+ *
+ * The stream is committed only once it has completed with the [DONE]
+ * marker, so truncated or failed generations are never served as hits.
+ * Streams larger than max_bytes are not cached.
+ *
+ * If finish_on_disconnect is set, the writer asks the pipe to keep reading
+ * the backend after the client has gone away, so that the generation the
+ * backend is already paying for still ends up in the cache.
+ */
+class StreamCacheWriter : public StreamObserver {
+public:
+    StreamCacheWriter(std::shared_ptr<cache::LruCache> cache,
+                      const cache::CacheKey& key,
+                      std::size_t max_bytes,
+                      bool finish_on_disconnect);
+
+    // StreamObserver
+    void on_stream_data(const char* data, std::size_t size) override;
+    void on_stream_end(const StreamResult& result) override;
+    bool wants_completion() const override { return finish_on_disconnect_ && !overflowed_; }
+
+private:
+    std::shared_ptr<cache::LruCache> cache_;
+    cache::CacheKey key_;
+    std::size_t max_bytes_;
+    bool finish_on_disconnect_;
+
+    std::string body_;
+    bool overflowed_{false};
+};
+
+} // namespace ntonix::proxy
+
+#endif // NTONIX_PROXY_STREAM_CACHE_HPP
@@ -4,18 +4,63 @@
  */
 
 #include "proxy/stream_pipe.hpp"
+#include "proxy/chunked_decoder.hpp"
+#include "proxy/deadline_stream.hpp"
+#include "proxy/sse_scanner.hpp"
+#include "proxy/stream_broadcast.hpp"
+#include "util/buffer_pool.hpp"
+#include "util/metrics.hpp"
 
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
-#include <cstring>
+#include <array>
+#include <cstdio>
+#include <optional>
 
 namespace ntonix::proxy {
 
+namespace {
+
+/**
+ * Consecutive reads using at most a quarter of the buffer before it shrinks
+ */
+constexpr std::size_t kShrinkAfterSmallReads = 8;
+
+/**
+ * How long to wait for the end of a backend body after its [DONE] event
+ */
+constexpr std::chrono::seconds kDrainGrace{1};
+
+} // namespace
+
+// ============================================================================
+// SpillBudget Implementation
+// ============================================================================
+
+bool SpillBudget::try_reserve(std::size_t bytes) {
+    auto used = used_.load(std::memory_order_relaxed);
+    do {
+        if (bytes > limit_ - std::min(used, limit_)) {
+            return false;
+        }
+    } while (!used_.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+    util::Metrics::instance().set_stream_spilled_bytes(used + bytes);
+    return true;
+}
+
+void SpillBudget::release(std::size_t bytes) {
+    auto used = used_.fetch_sub(bytes, std::memory_order_relaxed) - bytes;
+    util::Metrics::instance().set_stream_spilled_bytes(used);
+}
+
+// ============================================================================
+// StreamPipe Implementation
+// ============================================================================
+
 StreamPipe::StreamPipe(asio::io_context& io_context, const StreamPipeConfig& config)
     : io_context_(io_context)
     , config_(config)
-    , read_buffer_(config.buffer_size)
 {
     spdlog::debug("StreamPipe: Created with buffer_size={}, read_timeout={}s",
                   config_.buffer_size, config_.read_timeout.count());
@@ -61,303 +106,1589 @@ bool StreamPipe::is_streaming_response(const http::response_header<>& header) {
     return false;
 }
 
-bool StreamPipe::contains_done_marker(const char* data, std::size_t size) const {
-    if (!config_.detect_done_marker || size < 6) {
-        return false;
+std::chrono::steady_clock::time_point StreamPipe::write_deadline() const {
+    std::chrono::steady_clock::duration limit = config_.read_timeout;
+    if (config_.slow_client_policy == SlowClientPolicy::drop) {
+        limit = std::min<std::chrono::steady_clock::duration>(limit, config_.slow_client_timeout);
     }
+    return std::min(deadline_, std::chrono::steady_clock::now() + limit);
+}
 
-    // Look for "data: [DONE]" which is the SSE marker for end of stream
-    // Also check for just "[DONE]" in case it's not prefixed
-    static const char* done_markers[] = {
-        "data: [DONE]",
-        "[DONE]"
-    };
+http::response<http::empty_body> StreamPipe::client_response_header(
+    const http::response_header<>& response_header) const
+{
+    // Build response header for client
+    http::response<http::empty_body> client_response{response_header};
 
-    for (const char* marker : done_markers) {
-        std::size_t marker_len = std::strlen(marker);
-        if (size >= marker_len) {
-            // Search for marker in data
-            auto it = std::search(data, data + size, marker, marker + marker_len);
-            if (it != data + size) {
-                return true;
-            }
-        }
+    // Set Transfer-Encoding: chunked for the client response. The relay
+    // strips the backend's own framing, so it never passes through.
+    if (config_.forward_chunked) {
+        client_response.erase(http::field::content_length);
+        client_response.set(http::field::transfer_encoding, "chunked");
+    } else {
+        client_response.erase(http::field::transfer_encoding);
     }
 
-    return false;
+    // Set Connection header based on keep-alive
+    client_response.set(http::field::connection, "keep-alive");
+
+    // Add server header
+    client_response.set(http::field::server, "NTONIX/0.1.0");
+    return client_response;
 }
 
-std::size_t StreamPipe::write_chunk_to_client(
+// ============================================================================
+// Relay - backend-to-client forwarding for async_forward_stream()
+// ============================================================================
+
+/**
+ * Relay of one backend stream to one client
+ *
+ * The relay is a chain of asynchronous operations on the io_context, so
+ * no thread is held for the life of a stream and one thread can drive any
+ * number of them. Its handlers run on a strand. A backend async_read_some
+ * and a client async_write can both be outstanding, and a wait for the
+ * client socket to turn readable reports a hang-up (reset, close, or a
+ * half-close with cancel_on_half_close) instead of it being probed for
+ * before every chunk. Chunks read while a write is in progress go out
+ * together, as one HTTP chunk, in the next write. One timer covers
+ * read_timeout, deadline_ and the relay's shorter waits. An SseScanner
+ * follows event boundaries across reads and recognises the terminal
+ * [DONE] event.
+ *
+ * When the stream ends the relay cancels whatever is still outstanding and
+ * completes once the last handler has run, so neither socket is in use by
+ * the time the completion handler sees the result.
+ *
+ * The read buffer comes from the buffer pool, starting at buffer_size. A
+ * read that fills it moves to the next size class (up to the pool's
+ * largest); a run of reads using a quarter of it or less moves down one, so
+ * thousands of trickling streams do not each hold a large buffer.
+ *
+ * Reads run ahead of a slow client by at most client_buffer_bytes. Beyond
+ * that, slow_client_policy decides: block pauses backend reads (the
+ * client's pace then reaches the backend through TCP), drop also pauses
+ * them but disconnects a client that stays stalled for slow_client_timeout,
+ * and spill keeps reading while the shared SpillBudget covers the excess,
+ * then blocks. Time spent at the limit is the client's stall.
+ *
+ * The backend's framing is decoded as it arrives (a ChunkedDecoder for
+ * chunked bodies, a byte count for Content-Length), so only payload reaches
+ * the scanner, observers and client, and the relay knows where the body
+ * ends. It stops reading exactly there. After [DONE] the client gets its
+ * terminating chunk at once while the relay reads on for up to kDrainGrace,
+ * discarding anything left, to reach the end of the body. A body read to
+ * its end with nothing after it leaves the backend connection reusable.
+ *
+ * Each completed SSE event is timed as it arrives: the first against the
+ * backend request, later ones against their predecessor (events completed
+ * by one read arrived together, a gap of zero).
+ *
+ * With a coalesce_window, an idle client write is also held back until the
+ * window since the first held chunk has passed or coalesce_bytes are
+ * waiting, trading that much inter-token latency for fewer writes. Such
+ * writes end at an event boundary; a partial event waits for the next one.
+ */
+class StreamPipe::Relay : public std::enable_shared_from_this<StreamPipe::Relay> {
+public:
+    Relay(std::shared_ptr<StreamPipe> pipe,
+          tcp::socket& backend_socket,
+          beast::tcp_stream& client_stream,
+          const http::response_header<>& response_header,
+          StreamObservers observers,
+          StreamProgressCallback progress_callback,
+          StreamCompletion on_complete);
+
+    ~Relay();
+
+    Relay(const Relay&) = delete;
+    Relay& operator=(const Relay&) = delete;
+
+    /**
+     * Write the response header, forward initial_body, then relay the
+     * backend until the stream ends
+     */
+    void start(std::string initial_body);
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * How the backend delimits the response body
+     */
+    enum class BodyFraming {
+        chunked,    // Transfer-Encoding: chunked, ends with the terminal chunk
+        length,     // Content-Length
+        close       // Ends when the backend closes the connection
+    };
+
+    void on_header_written(const beast::error_code& ec);
+    void on_read(const beast::error_code& ec, std::size_t bytes_read);
+    void on_write(const beast::error_code& ec);
+    void on_client_readable(const beast::error_code& ec);
+    void on_timer(const beast::error_code& ec, std::uint64_t generation);
+
+    /**
+     * Start whatever the relay's state now calls for: the next client write,
+     * a backend read, the client watch and the timer; or complete the stream
+     * once it has finished and nothing is outstanding
+     */
+    void pump();
+
+    /**
+     * Strip the backend's framing from `size` bytes in place and note the end of the body
+     * @return Number of payload bytes now at the start of data
+     */
+    std::size_t decode_body(char* data, std::size_t size);
+
+    void handle_data(const char* data, std::size_t size);
+    void start_read();
+    void resize_read_buffer(std::size_t bytes_read);
+
+    /**
+     * Apply slow_client_policy and stall accounting to the bytes now held for the client
+     */
+    void check_backlog();
+    void end_stall();
+    void drop_client();
+
+    /**
+     * Time `events` SSE events completed by the latest read
+     */
+    void record_events(std::size_t events);
+
+    /**
+     * Start the next client write if one is due
+     */
+    void start_write();
+
+    /**
+     * Wait for the client socket to turn readable, which is how a hang-up shows
+     */
+    void watch_client();
+
+    /**
+     * Make sure the timer fires no later than next_wakeup()
+     */
+    void arm_timer();
+
+    /**
+     * Act on every timer that has expired by `now`
+     */
+    void check_timers(clock::time_point now);
+    clock::time_point timer_expiry() const;
+    clock::time_point next_wakeup() const;
+
+    /**
+     * Nothing is being read, written or held, and the client has its terminating chunk
+     */
+    bool complete() const;
+
+    bool can_read() const;
+    void client_gone();
+    void stop_reading();
+    void finish();
+    void abort();
+
+    /**
+     * Settle the result, notify observers and run the completion handler
+     */
+    void complete_stream();
+
+    void settle_result();
+
+    /**
+     * Tell observers the stream has ended, once no more of the backend's
+     * stream will reach them (it ended, or sent [DONE] and is being drained)
+     *
+     * Runs before the client's last write goes out, so a client that reissues
+     * the request on seeing [DONE] finds the stream already cached.
+     */
+    void end_observers();
+
+    bool wants_completion() const;
+
+    /**
+     * Nothing more will be relayed to the client from the backend
+     */
+    bool input_done() const { return read_done_ || draining_; }
+
+    /**
+     * Run a handler on the relay's strand
+     */
+    template <typename Handler>
+    auto bind(Handler handler) {
+        return asio::bind_executor(strand_, std::move(handler));
+    }
+
+    std::shared_ptr<StreamPipe> pipe_;
+    StreamObservers observers_;
+    StreamProgressCallback progress_callback_;
+    StreamCompletion on_complete_;
+    StreamResult result_;
+
+    tcp::socket& backend_;
+    tcp::socket& client_;
+    asio::strand<asio::io_context::executor_type> strand_;
+    asio::steady_timer timer_;
+
+    http::response_header<> response_header_;                   // As received from the backend
+    http::response<http::empty_body> client_header_;
+    std::optional<http::response_serializer<http::empty_body>> header_serializer_;
+    std::string initial_body_;
+
+    util::PooledBuffer read_buffer_;
+    std::size_t small_reads_{0};           // Consecutive reads using <= 1/4 of read_buffer_
+
+    BodyFraming framing_;
+    ChunkedDecoder decoder_;
+    std::uint64_t body_remaining_{0};      // Bytes left under BodyFraming::length
+    bool body_complete_{false};            // The backend's response ended where its framing said
+    bool body_excess_{false};              // Bytes followed the end of the body
+    bool draining_{false};                 // After [DONE]: reading to the end of the body, discarding it
+    clock::time_point drain_deadline_;
+
+    SseScanner scanner_;
+    std::string pending_;                  // Stream bytes waiting for the client
+    std::size_t pending_boundary_{0};      // Offset in pending_ just past its last complete event (0 = none)
+    std::string writing_;                  // Stream bytes being written
+    char chunk_header_[24];                // Chunk size line of the current write
+    std::array<asio::const_buffer, 3> write_buffers_;
+
+    // Outstanding socket reads and writes; the relay completes once all have
+    // returned. finish() cancels the client watch and the timer, whose
+    // handlers touch neither socket once the relay has finished.
+    std::size_t outstanding_{0};
+    bool header_written_{false};
+    bool reading_{false};
+    bool writing_active_{false};
+    bool watching_client_{false};
+    bool client_watch_done_{false};        // Client sent data: a hang-up now shows as a failed write
+    bool timer_armed_{false};
+    clock::time_point timer_at_;
+    std::uint64_t timer_generation_{0};    // Bumped on every re-arm, so a stale expiry is ignored
+
+    bool read_done_{false};                // No further backend reads
+    bool final_chunk_sent_{false};
+    bool finished_{false};
+    bool completed_{false};
+    bool observers_ended_{false};
+    bool flush_armed_{false};              // Holding pending_ for the coalescing window
+    bool flush_due_{false};                // Coalescing window has passed
+    clock::time_point start_time_;
+    clock::time_point last_activity_;
+    clock::time_point held_since_;         // When pending_ received its first chunk
+
+    std::size_t spilled_{0};               // Bytes reserved from the spill budget
+    bool stalled_{false};                  // client_buffer_bytes or more are waiting for the client
+    clock::time_point stalled_since_;
+    clock::duration stalled_for_{};
+
+    clock::time_point request_sent_;       // Origin of time_to_first_event
+    clock::time_point first_event_at_;
+    clock::time_point last_event_at_;
+
+    std::uint64_t chunks_{0};              // Backend reads relayed
+    std::uint64_t writes_{0};              // Client writes issued
+};
+
+StreamPipe::Relay::Relay(
+    std::shared_ptr<StreamPipe> pipe,
+    tcp::socket& backend_socket,
     beast::tcp_stream& client_stream,
-    const char* data,
-    std::size_t size,
-    beast::error_code& ec)
+    const http::response_header<>& response_header,
+    StreamObservers observers,
+    StreamProgressCallback progress_callback,
+    StreamCompletion on_complete)
+    : pipe_(std::move(pipe))
+    , observers_(std::move(observers))
+    , progress_callback_(std::move(progress_callback))
+    , on_complete_(std::move(on_complete))
+    , backend_(backend_socket)
+    , client_(client_stream.socket())
+    , strand_(asio::make_strand(pipe_->io_context_))
+    , timer_(strand_)
+    , response_header_(response_header)
+    , client_header_(pipe_->client_response_header(response_header))
+    , read_buffer_(pipe_->config_.buffer_size)
+    , framing_(BodyFraming::close)
+    , start_time_(clock::now())
+    , request_sent_(pipe_->request_sent_ != clock::time_point{} ? pipe_->request_sent_ : clock::now())
 {
-    if (size == 0) {
-        return 0;
-    }
+    result_.timing.event_gaps_ms = util::StreamLatencyMetrics::empty_event_gaps();
 
-    if (config_.forward_chunked) {
-        // Build chunked transfer encoding format:
-        // size-in-hex\r\n
-        // data\r\n
+    // Chunked if it is the last transfer coding, as for beast's message::chunked()
+    http::token_list codings{response_header[http::field::transfer_encoding]};
+    auto last_coding = codings.end();
+    for (auto it = codings.begin(); it != codings.end(); ++it) {
+        last_coding = it;
+    }
+    if (last_coding != codings.end() && beast::iequals(*last_coding, "chunked")) {
+        framing_ = BodyFraming::chunked;
+    } else if (auto length = response_header.find(http::field::content_length);
+               length != response_header.end()) {
+        try {
+            body_remaining_ = std::stoull(std::string(length->value()));
+            framing_ = BodyFraming::length;
+        } catch (const std::exception&) {
+            // Unusable length: read until the backend closes
+        }
+    }
+}
 
-        // Convert size to hex
-        char size_hex[32];
-        int hex_len = std::snprintf(size_hex, sizeof(size_hex), "%zx\r\n", size);
+StreamPipe::Relay::~Relay() {
+    if (spilled_ > 0) {
+        pipe_->config_.spill_budget->release(spilled_);
+    }
+}
 
-        // Use const_buffer for zero-copy - create array of buffers to send
-        std::array<asio::const_buffer, 3> buffers = {{
-            asio::buffer(size_hex, hex_len),
-            asio::buffer(data, size),
-            asio::buffer("\r\n", 2)
-        }};
+void StreamPipe::Relay::start(std::string initial_body) {
+    initial_body_ = std::move(initial_body);
+    asio::post(strand_, [self = shared_from_this()]() {
+        self->last_activity_ = clock::now();
+        self->header_serializer_.emplace(self->client_header_);
+        ++self->outstanding_;
+        http::async_write_header(self->client_, *self->header_serializer_,
+            self->bind([self](const beast::error_code& ec, std::size_t) {
+                self->on_header_written(ec);
+            }));
+        self->arm_timer();
+    });
+}
 
-        // Write all buffers in one call (zero-copy from data pointer)
-        std::size_t bytes_written = asio::write(client_stream, buffers, ec);
-        if (ec) {
-            spdlog::debug("StreamPipe: Error writing chunk to client: {}", ec.message());
-            return 0;
+void StreamPipe::Relay::on_header_written(const beast::error_code& ec) {
+    --outstanding_;
+    header_serializer_.reset();
+    if (ec || finished_) {
+        if (!finished_) {
+            result_.error_message = "Failed to write response header: " + ec.message();
+            spdlog::warn("StreamPipe: {}", result_.error_message);
         }
+        finish();
+        pump();
+        return;
+    }
 
-        return size;  // Return the actual data bytes, not chunk overhead
-    } else {
-        // Direct write without chunked encoding (zero-copy)
-        asio::const_buffer buf(data, size);
-        std::size_t bytes_written = asio::write(client_stream, buf, ec);
-        if (ec) {
-            spdlog::debug("StreamPipe: Error writing to client: {}", ec.message());
-            return 0;
+    header_written_ = true;
+    last_activity_ = clock::now();
+    spdlog::debug("StreamPipe: Response header sent to client");
+
+    for (const auto& observer : observers_) {
+        observer->on_stream_start(response_header_);
+    }
+
+    if (framing_ == BodyFraming::length && body_remaining_ == 0) {
+        body_complete_ = true;
+        stop_reading();
+    }
+    if (!initial_body_.empty()) {
+        std::string body = std::move(initial_body_);
+        auto size = decode_body(body.data(), body.size());
+        if (size > 0) {
+            handle_data(body.data(), size);
+        }
+        if (result_.done_marker_received) {
+            spdlog::debug("StreamPipe: [DONE] event found in initial body");
         }
-        return bytes_written;
     }
+    pump();
 }
 
-bool StreamPipe::write_final_chunk(beast::tcp_stream& client_stream, beast::error_code& ec) {
-    if (config_.forward_chunked) {
-        // Final chunk for chunked transfer encoding: 0\r\n\r\n
-        static const char final_chunk[] = "0\r\n\r\n";
-        asio::write(client_stream, asio::buffer(final_chunk, 5), ec);
-        if (ec) {
-            spdlog::debug("StreamPipe: Error writing final chunk: {}", ec.message());
-            return false;
+void StreamPipe::Relay::pump() {
+    if (draining_ || (read_done_ && !reading_)) {
+        end_observers();
+    }
+    if (!finished_) {
+        start_write();
+        if (complete()) {
+            finish();
         }
     }
-    return true;
+    if (finished_) {
+        if (outstanding_ == 0) {
+            complete_stream();
+        }
+        return;
+    }
+
+    if (can_read() && !reading_) {
+        start_read();
+    }
+    watch_client();
+    arm_timer();
 }
 
-bool StreamPipe::is_client_connected(beast::tcp_stream& client_stream) {
-    // Check if socket is open
-    if (!client_stream.socket().is_open()) {
+bool StreamPipe::Relay::complete() const {
+    if (!header_written_ || writing_active_ || !pending_.empty() || !read_done_) {
         return false;
     }
+    return result_.client_disconnected || !pipe_->config_.forward_chunked || final_chunk_sent_;
+}
 
-    // Try a non-blocking read to detect disconnection
-    beast::error_code ec;
-    client_stream.socket().non_blocking(true, ec);
-    if (ec) {
-        return true;  // Assume connected if we can't set non-blocking
+bool StreamPipe::Relay::can_read() const {
+    auto held = writing_.size() + pending_.size();
+    return header_written_ && !read_done_ && !finished_ &&
+           !(writing_active_ && held >= pipe_->config_.client_buffer_bytes + spilled_);
+}
+
+bool StreamPipe::Relay::wants_completion() const {
+    return std::any_of(observers_.begin(), observers_.end(),
+                       [](const auto& observer) { return observer->wants_completion(); });
+}
+
+std::size_t StreamPipe::Relay::decode_body(char* data, std::size_t size) {
+    std::size_t payload = size;
+
+    if (framing_ == BodyFraming::chunked) {
+        payload = decoder_.decode(data, size);
+        if (decoder_.failed()) {
+            result_.error_message = "Malformed chunked response from backend";
+            spdlog::warn("StreamPipe: {}", result_.error_message);
+            stop_reading();
+            return payload;
+        }
+        if (decoder_.done()) {
+            body_complete_ = true;
+            body_excess_ = decoder_.excess() > 0;
+        }
+    } else if (framing_ == BodyFraming::length) {
+        payload = static_cast<std::size_t>(std::min<std::uint64_t>(size, body_remaining_));
+        body_remaining_ -= payload;
+        if (body_remaining_ == 0) {
+            body_complete_ = true;
+            body_excess_ = payload < size;
+        }
     }
 
-    char peek_buf[1];
-    std::size_t bytes = client_stream.socket().receive(
-        asio::buffer(peek_buf), tcp::socket::message_peek, ec);
+    if (body_complete_) {
+        spdlog::debug("StreamPipe: Backend response body complete");
+        stop_reading();
+    }
+    return payload;
+}
 
-    // Restore blocking mode
-    beast::error_code ec2;
-    client_stream.socket().non_blocking(false, ec2);
+void StreamPipe::Relay::handle_data(const char* data, std::size_t size) {
+    auto scan = scanner_.scan(data, size);
+    if (scan.events > 0) {
+        record_events(scan.events);
+    }
+    if (scan.done && pipe_->config_.detect_done_marker) {
+        result_.done_marker_received = true;
+        spdlog::debug("StreamPipe: [DONE] event received");
+    }
 
-    // would_block means no data available but still connected
-    if (ec == asio::error::would_block) {
-        return true;
+    // Observers (fan-out joiners) get the chunk before this client's write,
+    // so a slow leader client does not delay them
+    for (const auto& observer : observers_) {
+        observer->on_stream_data(data, size);
     }
+    ++chunks_;
 
-    // EOF or other error means disconnected
-    if (ec) {
-        return false;
+    if (!result_.client_disconnected) {
+        if (pending_.empty() && pipe_->config_.coalesce_window.count() > 0) {
+            held_since_ = clock::now();
+        }
+        if (scan.events > 0) {
+            pending_boundary_ = pending_.size() + scan.last_boundary;
+        }
+        pending_.append(data, size);
     }
 
-    // bytes == 0 with no error also indicates EOF
-    return bytes > 0 || !ec;
+    if (progress_callback_ && !progress_callback_(result_.bytes_forwarded + writing_.size() + pending_.size())) {
+        spdlog::debug("StreamPipe: Progress callback requested stop");
+        stop_reading();
+    }
+    if (result_.done_marker_received && !read_done_ && !draining_) {
+        if (framing_ == BodyFraming::close) {
+            stop_reading();
+        } else {
+            // The client is done; read on briefly for the end of the body so
+            // the backend connection can go back to the pool
+            draining_ = true;
+            drain_deadline_ = clock::now() + kDrainGrace;
+        }
+    }
+    check_backlog();
 }
 
-StreamResult StreamPipe::forward_stream(
-    tcp::socket& backend_socket,
-    beast::tcp_stream& client_stream,
-    const http::response_header<>& response_header,
-    const std::string& initial_body,
-    StreamProgressCallback progress_callback)
-{
-    StreamResult result;
-    auto start_time = std::chrono::steady_clock::now();
+void StreamPipe::Relay::record_events(std::size_t events) {
+    auto now = clock::now();
+    auto& timing = result_.timing;
 
-    spdlog::debug("StreamPipe: Starting stream forwarding");
+    if (timing.events == 0) {
+        timing.time_to_first_event = std::chrono::duration_cast<std::chrono::microseconds>(now - request_sent_);
+        first_event_at_ = now;
+    } else {
+        timing.event_gaps_ms.add(std::chrono::duration<double, std::milli>(now - last_event_at_).count());
+    }
+    for (std::size_t i = 1; i < events; ++i) {
+        timing.event_gaps_ms.add(0.0);
+    }
 
-    // First, send the HTTP response header to the client
-    beast::error_code ec;
+    timing.events += events;
+    timing.event_span = std::chrono::duration_cast<std::chrono::microseconds>(now - first_event_at_);
+    last_event_at_ = now;
+}
 
-    // Build response header for client
-    http::response<http::empty_body> client_response{response_header};
+void StreamPipe::Relay::start_read() {
+    reading_ = true;
+    ++outstanding_;
+    backend_.async_read_some(asio::buffer(read_buffer_.data(), read_buffer_.size()),
+        bind([self = shared_from_this()](const beast::error_code& ec, std::size_t bytes_read) {
+            self->on_read(ec, bytes_read);
+        }));
+}
 
-    // Set Transfer-Encoding: chunked for the client response
-    if (config_.forward_chunked) {
-        client_response.erase(http::field::content_length);
-        client_response.set(http::field::transfer_encoding, "chunked");
+void StreamPipe::Relay::on_read(const beast::error_code& ec, std::size_t bytes_read) {
+    --outstanding_;
+    reading_ = false;
+    if (finished_ || read_done_) {
+        // Cancelled, or reading stopped while this read was outstanding
+        pump();
+        return;
     }
+    last_activity_ = clock::now();
 
-    // Set Connection header based on keep-alive
-    client_response.set(http::field::connection, "keep-alive");
+    if (ec == asio::error::eof) {
+        result_.backend_closed = true;
+        spdlog::debug("StreamPipe: Backend closed connection (EOF)");
+        stop_reading();
+    } else if (ec) {
+        result_.error_message = "Backend read error: " + ec.message();
+        spdlog::warn("StreamPipe: {}", result_.error_message);
+        stop_reading();
+    } else {
+        auto payload = decode_body(read_buffer_.data(), bytes_read);
+        if (payload > 0 && !draining_) {
+            handle_data(read_buffer_.data(), payload);
+        }
+        resize_read_buffer(bytes_read);
+    }
+    pump();
+}
 
-    // Add server header
-    client_response.set(http::field::server, "NTONIX/0.1.0");
+void StreamPipe::Relay::resize_read_buffer(std::size_t bytes_read) {
+    auto size = read_buffer_.size();
+    std::size_t next = size;
 
-    // Serialize and send header
-    http::response_serializer<http::empty_body> serializer{client_response};
-    http::write_header(client_stream, serializer, ec);
-    if (ec) {
-        result.error_message = "Failed to write response header: " + ec.message();
-        spdlog::warn("StreamPipe: {}", result.error_message);
-        return result;
+    if (bytes_read == size) {
+        small_reads_ = 0;
+        if (size < util::BufferPool::kMaxBufferSize) {
+            next = size * 2;
+        }
+    } else if (bytes_read <= size / 4 && size > util::BufferPool::kMinBufferSize) {
+        if (++small_reads_ >= kShrinkAfterSmallReads) {
+            small_reads_ = 0;
+            next = size / 2;
+        }
+    } else {
+        small_reads_ = 0;
     }
 
-    spdlog::debug("StreamPipe: Response header sent to client");
+    if (next != size) {
+        // handle_data() has copied the bytes out
+        read_buffer_ = util::PooledBuffer(next);
+        spdlog::trace("StreamPipe: Read buffer resized {} -> {} bytes", size, read_buffer_.size());
+    }
+}
+
+void StreamPipe::Relay::start_write() {
+    const auto& config = pipe_->config_;
+    bool terminate = input_done() && config.forward_chunked && !final_chunk_sent_;
+    if (!header_written_ || writing_active_ || finished_ || result_.client_disconnected ||
+        (pending_.empty() && !terminate)) {
+        return;
+    }
 
-    // Forward any initial body data that was read with the header
-    if (!initial_body.empty()) {
-        std::size_t written = write_chunk_to_client(
-            client_stream, initial_body.data(), initial_body.size(), ec);
-        if (ec) {
-            result.error_message = "Failed to write initial body: " + ec.message();
-            spdlog::warn("StreamPipe: {}", result.error_message);
-            return result;
+    // Hold small writes for the coalescing window, then send whole events
+    std::size_t cut = pending_.size();
+    if (config.coalesce_window.count() > 0 && !pending_.empty()) {
+        if (!flush_due_ && !input_done() && pending_.size() < config.coalesce_bytes) {
+            flush_armed_ = true;
+            return;
         }
-        result.bytes_forwarded += written;
+        flush_due_ = false;
+        flush_armed_ = false;
+        util::Metrics::instance().stream_write_held(
+            std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - held_since_));
+        if (!input_done() && pending_boundary_ > 0) {
+            cut = pending_boundary_;
+        }
+    }
 
-        // Check for [DONE] marker in initial body
-        if (contains_done_marker(initial_body.data(), initial_body.size())) {
-            result.done_marker_received = true;
-            spdlog::debug("StreamPipe: [DONE] marker found in initial body");
+    if (cut == pending_.size()) {
+        writing_.swap(pending_);
+        pending_.clear();
+    } else {
+        writing_.assign(pending_, 0, cut);
+        pending_.erase(0, cut);
+        held_since_ = clock::now();
+    }
+    pending_boundary_ = 0;
+
+    // One HTTP chunk per write; the stream's last write also carries the terminating chunk
+    bool last = terminate && pending_.empty();
+    final_chunk_sent_ = final_chunk_sent_ || last;
+    std::size_t header_size = 0;
+    std::string_view trailer;
+    if (config.forward_chunked) {
+        trailer = last ? std::string_view("\r\n0\r\n\r\n") : std::string_view("\r\n");
+        if (writing_.empty()) {
+            trailer.remove_prefix(2);
+        } else {
+            header_size = static_cast<std::size_t>(
+                std::snprintf(chunk_header_, sizeof(chunk_header_), "%zx\r\n", writing_.size()));
         }
+    }
+    write_buffers_ = {{
+        asio::buffer(chunk_header_, header_size),
+        asio::buffer(writing_),
+        asio::buffer(trailer.data(), trailer.size())
+    }};
+
+    writing_active_ = true;
+    ++writes_;
+    ++outstanding_;
+    asio::async_write(client_, write_buffers_,
+        bind([self = shared_from_this()](const beast::error_code& ec, std::size_t) {
+            self->on_write(ec);
+        }));
+}
+
+void StreamPipe::Relay::on_write(const beast::error_code& ec) {
+    --outstanding_;
+    writing_active_ = false;
+
+    if (!ec) {
+        result_.bytes_forwarded += writing_.size();
+        last_activity_ = clock::now();
+    } else if (finished_ || result_.client_disconnected) {
+        // Cancelled, or the client was dropped while this write was outstanding
+    } else if (ec == asio::error::broken_pipe || ec == asio::error::connection_reset) {
+        spdlog::debug("StreamPipe: Client disconnected during write");
+        client_gone();
+    } else {
+        result_.error_message = "Client write error: " + ec.message();
+        spdlog::warn("StreamPipe: {}", result_.error_message);
+        abort();
+    }
+    writing_.clear();
+    check_backlog();
+    pump();
+}
+
+void StreamPipe::Relay::watch_client() {
+    if (watching_client_ || client_watch_done_ || result_.client_disconnected) {
+        return;
+    }
+    watching_client_ = true;
+    client_.async_wait(tcp::socket::wait_read,
+        bind([self = shared_from_this()](const beast::error_code& ec) {
+            self->on_client_readable(ec);
+        }));
+}
+
+void StreamPipe::Relay::on_client_readable(const beast::error_code& ec) {
+    watching_client_ = false;
+    if (finished_ || result_.client_disconnected) {
+        pump();
+        return;
+    }
+
+    if (!ec && peer_hung_up(client_.native_handle(), pipe_->config_.cancel_on_half_close)) {
+        spdlog::debug("StreamPipe: Client disconnected early");
+        client_gone();
+    } else {
+        // The client sent data (e.g. a pipelined request): stop watching it
+        client_watch_done_ = true;
+    }
+    pump();
+}
+
+void StreamPipe::Relay::check_backlog() {
+    const auto& config = pipe_->config_;
+    auto held = result_.client_disconnected ? 0 : writing_.size() + pending_.size();
+
+    if (held < config.client_buffer_bytes) {
+        end_stall();
+    } else if (!stalled_) {
+        stalled_ = true;
+        stalled_since_ = clock::now();
+        spdlog::debug("StreamPipe: Client stalled, {} bytes behind the backend", held);
+    }
 
-        // Call progress callback
-        if (progress_callback && !progress_callback(result.bytes_forwarded)) {
-            spdlog::debug("StreamPipe: Progress callback requested stop");
-            write_final_chunk(client_stream, ec);
-            result.success = true;
-            auto end_time = std::chrono::steady_clock::now();
-            result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-            return result;
+    // Spilling holds the excess, plus room for the next read, against the shared budget
+    if (config.slow_client_policy != SlowClientPolicy::spill || !config.spill_budget) {
+        return;
+    }
+    std::size_t wanted = held < config.client_buffer_bytes ? 0 : held - config.client_buffer_bytes + read_buffer_.size();
+    if (wanted > spilled_) {
+        if (config.spill_budget->try_reserve(wanted - spilled_)) {
+            spilled_ = wanted;
         }
+    } else if (wanted < spilled_) {
+        config.spill_budget->release(spilled_ - wanted);
+        spilled_ = wanted;
     }
+}
+
+void StreamPipe::Relay::drop_client() {
+    result_.slow_client_dropped = true;
+    spdlog::warn("StreamPipe: Dropping slow client stalled for {}ms",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - stalled_since_).count());
+    util::Metrics::instance().slow_client_dropped();
+
+    beast::error_code ec;
+    client_.shutdown(tcp::socket::shutdown_both, ec);
+    client_gone();
+}
+
+void StreamPipe::Relay::end_stall() {
+    if (!stalled_) {
+        return;
+    }
+    stalled_ = false;
+    auto stalled = clock::now() - stalled_since_;
+    stalled_for_ += stalled;
+    util::Metrics::instance().stream_client_stalled(std::chrono::duration_cast<std::chrono::microseconds>(stalled));
+}
 
-    // If [DONE] was in initial body, we're done
-    if (result.done_marker_received) {
-        write_final_chunk(client_stream, ec);
-        result.success = true;
-        auto end_time = std::chrono::steady_clock::now();
-        result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-        spdlog::debug("StreamPipe: Stream complete (DONE in initial body), {} bytes in {}ms",
-                      result.bytes_forwarded, result.duration.count());
-        return result;
+void StreamPipe::Relay::arm_timer() {
+    auto wakeup = next_wakeup();
+    if (timer_armed_ && timer_at_ <= wakeup) {
+        return;  // Fires first; on_timer re-arms for anything later
     }
 
-    // Read from backend and forward to client in a loop
-    // We're using synchronous I/O here for simplicity; the connection is dedicated to this stream
-    while (true) {
-        // Check if client is still connected
-        if (!is_client_connected(client_stream)) {
-            result.client_disconnected = true;
-            spdlog::debug("StreamPipe: Client disconnected early");
-            break;
+    timer_armed_ = true;
+    timer_at_ = wakeup;
+    auto generation = ++timer_generation_;
+    timer_.expires_at(wakeup);
+    timer_.async_wait(bind([self = shared_from_this(), generation](const beast::error_code& ec) {
+        self->on_timer(ec, generation);
+    }));
+}
+
+void StreamPipe::Relay::on_timer(const beast::error_code& ec, std::uint64_t generation) {
+    if (generation == timer_generation_) {
+        timer_armed_ = false;
+        if (!ec && !finished_) {
+            check_timers(clock::now());
         }
+    }
+    pump();
+}
 
-        // Set read timeout on backend socket
-        backend_socket.non_blocking(false, ec);
+void StreamPipe::Relay::check_timers(clock::time_point now) {
+    const auto& config = pipe_->config_;
 
-        // Read from backend
-        std::size_t bytes_read = backend_socket.read_some(
-            asio::buffer(read_buffer_), ec);
+    if (draining_ && !read_done_ && now >= drain_deadline_) {
+        spdlog::debug("StreamPipe: Backend body did not end after [DONE]");
+        stop_reading();
+    }
+    if (flush_armed_ && now >= held_since_ + config.coalesce_window) {
+        flush_armed_ = false;
+        flush_due_ = true;
+    }
+    if (stalled_ && config.slow_client_policy == SlowClientPolicy::drop && !result_.client_disconnected &&
+        now >= stalled_since_ + config.slow_client_timeout) {
+        drop_client();
+    }
 
-        if (ec == asio::error::eof) {
-            // Backend closed connection normally
-            result.backend_closed = true;
-            spdlog::debug("StreamPipe: Backend closed connection (EOF)");
-            break;
+    if (!finished_ && !complete() && now >= timer_expiry()) {
+        if (!header_written_) {
+            result_.error_message = "Failed to write response header: " +
+                                    beast::error_code(beast::error::timeout).message();
+        } else if (!read_done_) {
+            result_.timed_out = true;
+            result_.error_message = "Backend stream timed out";
+        } else {
+            result_.error_message = "Client write timed out";
         }
+        spdlog::warn("StreamPipe: {}", result_.error_message);
+        abort();
+    }
+}
+
+StreamPipe::Relay::clock::time_point StreamPipe::Relay::timer_expiry() const {
+    auto expiry = std::min(pipe_->deadline_, last_activity_ + pipe_->config_.read_timeout);
+    if (draining_ && !read_done_) {
+        expiry = std::min(expiry, drain_deadline_);
+    }
+    return expiry;
+}
 
-        if (ec) {
-            if (ec == asio::error::operation_aborted) {
-                spdlog::debug("StreamPipe: Operation aborted");
+StreamPipe::Relay::clock::time_point StreamPipe::Relay::next_wakeup() const {
+    const auto& config = pipe_->config_;
+    auto wakeup = timer_expiry();
+    if (flush_armed_) {
+        wakeup = std::min(wakeup, held_since_ + std::chrono::duration_cast<clock::duration>(config.coalesce_window));
+    }
+    if (stalled_ && config.slow_client_policy == SlowClientPolicy::drop && !result_.client_disconnected) {
+        wakeup = std::min(wakeup, stalled_since_ + config.slow_client_timeout);
+    }
+    return wakeup;
+}
+
+void StreamPipe::Relay::client_gone() {
+    result_.client_disconnected = true;
+    pending_.clear();
+    pending_boundary_ = 0;
+    flush_armed_ = false;
+    end_stall();
+
+    // An outstanding write fails with operation_aborted and is dropped
+    beast::error_code ec;
+    client_.cancel(ec);
+
+    if (!wants_completion() && !draining_) {
+        stop_reading();
+    } else if (draining_) {
+        spdlog::debug("StreamPipe: Client left after [DONE], draining backend body");
+    } else if (!read_done_) {
+        spdlog::debug("StreamPipe: Finishing backend stream for observers");
+    }
+}
+
+void StreamPipe::Relay::stop_reading() {
+    read_done_ = true;
+    if (reading_) {
+        beast::error_code ec;
+        backend_.cancel(ec);
+    }
+}
+
+void StreamPipe::Relay::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    beast::error_code ec;
+    if (reading_) {
+        backend_.cancel(ec);
+    }
+    if (writing_active_ || watching_client_ || !header_written_) {
+        client_.cancel(ec);
+    }
+    timer_.cancel();
+}
+
+void StreamPipe::Relay::abort() {
+    read_done_ = true;
+    finish();
+}
+
+void StreamPipe::Relay::complete_stream() {
+    if (completed_) {
+        return;
+    }
+    completed_ = true;
+    result_.duration = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start_time_);
+
+    if (header_written_) {
+        end_stall();
+        result_.client_stall = std::chrono::duration_cast<std::chrono::milliseconds>(stalled_for_);
+        util::Metrics::instance().stream_relayed(chunks_, scanner_.events(), writes_);
+
+        settle_result();
+        end_observers();
+
+        spdlog::info("StreamPipe: Stream complete - {} bytes in {}ms (client_disconnect={}, backend_closed={}, done={})",
+                     result_.bytes_forwarded, result_.duration.count(),
+                     result_.client_disconnected, result_.backend_closed, result_.done_marker_received);
+    }
+
+    // Release what the handler captured (sockets' owners among them) once it has run
+    auto on_complete = std::move(on_complete_);
+    on_complete_ = nullptr;
+    on_complete(std::move(result_));
+}
+
+void StreamPipe::Relay::settle_result() {
+    result_.backend_reusable = body_complete_ && !body_excess_ && framing_ != BodyFraming::close &&
+                               result_.error_message.empty() && !result_.timed_out;
+
+    // Success if we transferred data without critical errors
+    result_.success = result_.error_message.empty() ||
+                      result_.client_disconnected ||
+                      result_.backend_closed ||
+                      result_.done_marker_received;
+}
+
+void StreamPipe::Relay::end_observers() {
+    if (observers_ended_ || !header_written_) {
+        return;
+    }
+    observers_ended_ = true;
+    settle_result();
+
+    // Observers always see the end once the stream has started
+    for (const auto& observer : observers_) {
+        observer->on_stream_end(result_);
+    }
+}
+
+// ============================================================================
+// Feed - client side of streams the proxy already holds
+// ============================================================================
+
+/**
+ * Writer of a stream the proxy holds itself to one client
+ *
+ * Like the Relay, it is a chain of asynchronous operations on a strand, so a
+ * client waiting for its next event holds no thread. The subclass supplies
+ * the stream: begin() leads up to write_header(), fetch() hands over
+ * whatever events are ready, and a pump() posted to the strand, or
+ * wake_at(), brings the feed back when there may be more. Each write sends
+ * everything fetched as one HTTP chunk and is bounded by write_deadline();
+ * a write that cannot complete in time drops the client. While nothing is being written the feed is bounded
+ * by the subclass's expires_at() and by deadline_. The client socket is
+ * watched for a hang-up as in the Relay.
+ *
+ * Only a stream that ended cleanly gets the terminating chunk, so the client
+ * can tell a truncated response from a complete one. A feed that gives the
+ * client back (hand_back()) has written nothing, and completes through
+ * on_handed_back() instead of the completion handler.
+ */
+class StreamPipe::Feed : public std::enable_shared_from_this<StreamPipe::Feed> {
+public:
+    Feed(std::shared_ptr<StreamPipe> pipe, beast::tcp_stream& client_stream, StreamCompletion on_complete);
+    virtual ~Feed() = default;
+
+    Feed(const Feed&) = delete;
+    Feed& operator=(const Feed&) = delete;
+
+    void start();
+
+protected:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * What fetch() found
+     */
+    enum class Fetch {
+        data,   // Events were added to the write
+        wait,   // Nothing yet: a posted pump() or wake_at() brings the feed back
+        end     // The stream is over; an error_message in result() marks it failed
+    };
+
+    /**
+     * Lead up to write_header() (runs on the strand)
+     */
+    virtual void begin() = 0;
+
+    /**
+     * Add buffers for the events ready to be written to `out`; they must
+     * stay valid until the next fetch()
+     */
+    virtual Fetch fetch(std::vector<asio::const_buffer>& out) = 0;
+
+    /**
+     * When to fetch again without being resumed (max = only when resumed)
+     */
+    virtual clock::time_point wake_at() const { return clock::time_point::max(); }
+
+    /**
+     * When the stream times out while nothing is being written (deadline_ applies too)
+     */
+    virtual clock::time_point expires_at() const { return clock::time_point::max(); }
+
+    /**
+     * Record why the stream timed out
+     */
+    virtual void on_expired();
+
+    /**
+     * Completion of a feed that handed the client back
+     */
+    virtual void on_handed_back() {}
+
+    void write_header(const http::response_header<>& header);
+
+    /**
+     * Start whatever the feed's state now calls for: the next write, the
+     * client watch and the timer; or complete once finished and idle
+     */
+    void pump();
+
+    /**
+     * Run a handler on the feed's strand
+     */
+    template <typename Handler>
+    void post(Handler handler) {
+        asio::post(strand_, std::move(handler));
+    }
+
+    /**
+     * End without writing anything to the client, which the caller takes over
+     */
+    void hand_back();
+
+    bool finished() const { return finished_; }
+    StreamResult& result() { return result_; }
+    const StreamPipeConfig& config() const { return pipe_->config_; }
+
+private:
+    void start_write(bool last);
+    void on_header_written(const beast::error_code& ec);
+    void on_write(const beast::error_code& ec);
+    void watch_client();
+    void on_client_readable(const beast::error_code& ec);
+    void arm_timer();
+    void on_timer(const beast::error_code& ec, std::uint64_t generation);
+    void check_timers(clock::time_point now);
+    clock::time_point next_wakeup() const;
+    void drop_client();
+    void finish();
+    void complete_stream();
+
+    template <typename Handler>
+    auto bind(Handler handler) {
+        return asio::bind_executor(strand_, std::move(handler));
+    }
+
+    std::shared_ptr<StreamPipe> pipe_;
+    StreamCompletion on_complete_;
+    StreamResult result_;
+
+    tcp::socket& client_;
+    asio::strand<asio::io_context::executor_type> strand_;
+    asio::steady_timer timer_;
+
+    http::response<http::empty_body> client_header_;
+    std::optional<http::response_serializer<http::empty_body>> header_serializer_;
+
+    std::vector<asio::const_buffer> payload_;   // Events being written
+    std::vector<asio::const_buffer> write_buffers_;
+    char chunk_header_[24];                     // Chunk size line of the current write
+    SseScanner scanner_;
+
+    std::size_t outstanding_{0};                // Client writes in progress
+    bool writing_{false};
+    bool header_written_{false};
+    bool ended_{false};                         // fetch() reported the end of the stream
+    bool final_chunk_sent_{false};
+    bool watching_client_{false};
+    bool client_watch_done_{false};             // Client sent data: a hang-up now shows as a failed write
+    bool handed_back_{false};
+    bool finished_{false};
+    bool completed_{false};
+    bool timer_armed_{false};
+    clock::time_point timer_at_;
+    std::uint64_t timer_generation_{0};
+    clock::time_point write_expiry_;
+    clock::time_point start_time_;
+};
+
+StreamPipe::Feed::Feed(std::shared_ptr<StreamPipe> pipe,
+                       beast::tcp_stream& client_stream,
+                       StreamCompletion on_complete)
+    : pipe_(std::move(pipe))
+    , on_complete_(std::move(on_complete))
+    , client_(client_stream.socket())
+    , strand_(asio::make_strand(pipe_->io_context_))
+    , timer_(strand_)
+    , start_time_(clock::now())
+{
+}
+
+void StreamPipe::Feed::start() {
+    post([self = shared_from_this()]() {
+        self->begin();
+        self->pump();
+    });
+}
+
+void StreamPipe::Feed::write_header(const http::response_header<>& header) {
+    client_header_ = pipe_->client_response_header(header);
+    header_serializer_.emplace(client_header_);
+    writing_ = true;
+    write_expiry_ = pipe_->write_deadline();
+    ++outstanding_;
+    http::async_write_header(client_, *header_serializer_,
+        bind([self = shared_from_this()](const beast::error_code& ec, std::size_t) {
+            self->on_header_written(ec);
+        }));
+}
+
+void StreamPipe::Feed::on_header_written(const beast::error_code& ec) {
+    --outstanding_;
+    writing_ = false;
+    header_serializer_.reset();
+    if (ec && !finished_) {
+        result_.error_message = "Failed to write response header: " + ec.message();
+        spdlog::warn("StreamPipe: {}", result_.error_message);
+        finish();
+    } else if (!ec) {
+        header_written_ = true;
+    }
+    pump();
+}
+
+void StreamPipe::Feed::pump() {
+    if (!finished_ && header_written_ && !writing_) {
+        if (!ended_) {
+            payload_.clear();
+            ended_ = fetch(payload_) == Fetch::end;
+            if (!payload_.empty()) {
+                start_write(false);
+            }
+        }
+        if (ended_ && !writing_) {
+            if (result_.error_message.empty() && config().forward_chunked && !final_chunk_sent_) {
+                payload_.clear();
+                start_write(true);
             } else {
-                result.error_message = "Backend read error: " + ec.message();
-                spdlog::warn("StreamPipe: {}", result.error_message);
+                finish();
             }
-            break;
         }
+    }
 
-        if (bytes_read == 0) {
-            // No data but no error - continue
-            continue;
+    if (finished_) {
+        if (outstanding_ == 0) {
+            complete_stream();
         }
+        return;
+    }
+    watch_client();
+    arm_timer();
+}
 
-        // Check for [DONE] marker before forwarding
-        if (contains_done_marker(read_buffer_.data(), bytes_read)) {
-            result.done_marker_received = true;
-            spdlog::debug("StreamPipe: [DONE] marker detected");
-        }
+void StreamPipe::Feed::start_write(bool last) {
+    std::size_t size = asio::buffer_size(payload_);
+    write_buffers_.clear();
+    if (config().forward_chunked && size > 0) {
+        auto header_size = std::snprintf(chunk_header_, sizeof(chunk_header_), "%zx\r\n", size);
+        write_buffers_.push_back(asio::buffer(chunk_header_, static_cast<std::size_t>(header_size)));
+    }
+    write_buffers_.insert(write_buffers_.end(), payload_.begin(), payload_.end());
+    if (config().forward_chunked && size > 0) {
+        write_buffers_.push_back(asio::buffer("\r\n", 2));
+    }
+    if (last) {
+        write_buffers_.push_back(asio::buffer("0\r\n\r\n", 5));
+        final_chunk_sent_ = true;
+    }
 
-        // Forward to client using zero-copy (const_buffer points directly to read_buffer_)
-        std::size_t written = write_chunk_to_client(
-            client_stream, read_buffer_.data(), bytes_read, ec);
-        if (ec) {
-            if (ec == asio::error::broken_pipe ||
-                ec == asio::error::connection_reset) {
-                result.client_disconnected = true;
-                spdlog::debug("StreamPipe: Client disconnected during write");
-            } else {
-                result.error_message = "Client write error: " + ec.message();
-                spdlog::warn("StreamPipe: {}", result.error_message);
+    writing_ = true;
+    write_expiry_ = pipe_->write_deadline();
+    ++outstanding_;
+    asio::async_write(client_, write_buffers_,
+        bind([self = shared_from_this()](const beast::error_code& ec, std::size_t) {
+            self->on_write(ec);
+        }));
+}
+
+void StreamPipe::Feed::on_write(const beast::error_code& ec) {
+    --outstanding_;
+    writing_ = false;
+
+    if (finished_) {
+        // Cancelled, or the client was dropped while this write was outstanding
+    } else if (ec) {
+        result_.client_disconnected = true;
+        spdlog::debug("StreamPipe: Client disconnected during write");
+        finish();
+    } else {
+        for (const auto& buffer : payload_) {
+            result_.bytes_forwarded += buffer.size();
+            if (scanner_.scan(static_cast<const char*>(buffer.data()), buffer.size()).done) {
+                result_.done_marker_received = true;
             }
-            break;
         }
+        if (final_chunk_sent_) {
+            finish();
+        }
+    }
+    pump();
+}
+
+void StreamPipe::Feed::watch_client() {
+    if (watching_client_ || client_watch_done_) {
+        return;
+    }
+    watching_client_ = true;
+    client_.async_wait(tcp::socket::wait_read,
+        bind([self = shared_from_this()](const beast::error_code& ec) {
+            self->on_client_readable(ec);
+        }));
+}
+
+void StreamPipe::Feed::on_client_readable(const beast::error_code& ec) {
+    watching_client_ = false;
+    if (finished_) {
+        pump();
+        return;
+    }
+
+    if (!ec && peer_hung_up(client_.native_handle(), config().cancel_on_half_close)) {
+        result_.client_disconnected = true;
+        spdlog::debug("StreamPipe: Client disconnected early");
+        finish();
+    } else {
+        // The client sent data (e.g. a pipelined request): stop watching it
+        client_watch_done_ = true;
+    }
+    pump();
+}
+
+StreamPipe::Feed::clock::time_point StreamPipe::Feed::next_wakeup() const {
+    if (writing_) {
+        return write_expiry_;
+    }
+    auto wakeup = std::min(pipe_->deadline_, expires_at());
+    if (header_written_ && !ended_) {
+        wakeup = std::min(wakeup, wake_at());
+    }
+    return wakeup;
+}
+
+void StreamPipe::Feed::arm_timer() {
+    auto wakeup = next_wakeup();
+    if (timer_armed_ && timer_at_ == wakeup) {
+        return;
+    }
+    if (wakeup == clock::time_point::max()) {
+        if (timer_armed_) {
+            ++timer_generation_;
+            timer_armed_ = false;
+            timer_.cancel();
+        }
+        return;
+    }
 
-        result.bytes_forwarded += written;
+    timer_armed_ = true;
+    timer_at_ = wakeup;
+    auto generation = ++timer_generation_;
+    timer_.expires_at(wakeup);
+    timer_.async_wait(bind([self = shared_from_this(), generation](const beast::error_code& ec) {
+        self->on_timer(ec, generation);
+    }));
+}
 
-        // Log periodic progress
-        if (result.bytes_forwarded % 65536 == 0) {
-            spdlog::debug("StreamPipe: Forwarded {} bytes so far", result.bytes_forwarded);
+void StreamPipe::Feed::on_timer(const beast::error_code& ec, std::uint64_t generation) {
+    if (generation != timer_generation_) {
+        return;  // Re-armed or cancelled since
+    }
+    timer_armed_ = false;
+    if (!ec && !finished_) {
+        check_timers(clock::now());
+    }
+    pump();
+}
+
+void StreamPipe::Feed::check_timers(clock::time_point now) {
+    if (writing_) {
+        if (now >= write_expiry_) {
+            drop_client();
         }
+    } else if (now >= std::min(pipe_->deadline_, expires_at())) {
+        on_expired();
+        finish();
+    }
+}
+
+void StreamPipe::Feed::on_expired() {
+    result_.timed_out = true;
+    result_.error_message = "Stream deadline passed";
+    spdlog::warn("StreamPipe: {}", result_.error_message);
+}
+
+void StreamPipe::Feed::drop_client() {
+    result_.error_message = header_written_ ? "Client write timed out"
+                                            : "Failed to write response header: " +
+                                              beast::error_code(beast::error::timeout).message();
+    result_.slow_client_dropped = config().slow_client_policy == SlowClientPolicy::drop;
+    if (result_.slow_client_dropped) {
+        util::Metrics::instance().slow_client_dropped();
+    }
+    spdlog::warn("StreamPipe: Dropping client stalled on a write");
+
+    beast::error_code ec;
+    client_.shutdown(tcp::socket::shutdown_both, ec);
+    finish();
+}
+
+void StreamPipe::Feed::hand_back() {
+    handed_back_ = true;
+    finish();
+}
+
+void StreamPipe::Feed::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    beast::error_code ec;
+    if (writing_ || watching_client_) {
+        client_.cancel(ec);
+    }
+    ++timer_generation_;
+    timer_.cancel();
+}
+
+void StreamPipe::Feed::complete_stream() {
+    if (completed_) {
+        return;
+    }
+    completed_ = true;
+
+    if (handed_back_) {
+        on_handed_back();
+        return;
+    }
+
+    result_.duration = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start_time_);
+    result_.success = result_.error_message.empty() && !result_.client_disconnected;
+    spdlog::info("StreamPipe: Held stream complete - {} bytes in {}ms (client_disconnect={}, done={})",
+                 result_.bytes_forwarded, result_.duration.count(),
+                 result_.client_disconnected, result_.done_marker_received);
+
+    auto on_complete = std::move(on_complete_);
+    on_complete_ = nullptr;
+    on_complete(std::move(result_));
+}
+
+// ============================================================================
+// Joiner - a client joined to another request's backend stream
+// ============================================================================
+
+/**
+ * Feed of a shared stream to a joined client
+ *
+ * Waits for the leader's header on the broadcast, joins, and from then on
+ * writes whatever chunks it has not sent yet, registering a wakeup with the
+ * broadcast whenever it has caught up. read_timeout bounds the time between
+ * chunks; start_timeout the wait for the header, after which (or if the
+ * stream cannot be joined) the client is handed back to be served on its own.
+ */
+class StreamPipe::Joiner : public StreamPipe::Feed {
+public:
+    Joiner(std::shared_ptr<StreamPipe> pipe,
+           std::shared_ptr<StreamBroadcast> broadcast,
+           beast::tcp_stream& client_stream,
+           std::function<void()> on_unjoined,
+           StreamCompletion on_complete)
+        : Feed(std::move(pipe), client_stream, std::move(on_complete))
+        , broadcast_(std::move(broadcast))
+        , on_unjoined_(std::move(on_unjoined))
+    {
+    }
+
+private:
+    void begin() override;
+    Fetch fetch(std::vector<asio::const_buffer>& out) override;
+    clock::time_point expires_at() const override;
+    void on_expired() override;
+    void on_handed_back() override;
+
+    void on_started();
+
+    std::shared_ptr<Joiner> self() {
+        return std::static_pointer_cast<Joiner>(shared_from_this());
+    }
 
-        // Call progress callback
-        if (progress_callback && !progress_callback(result.bytes_forwarded)) {
-            spdlog::debug("StreamPipe: Progress callback requested stop");
-            break;
+    std::shared_ptr<StreamBroadcast> broadcast_;
+    std::function<void()> on_unjoined_;
+    std::vector<StreamBroadcast::Chunk> chunks_;   // Chunks being written
+    std::size_t cursor_{0};
+    bool joined_{false};
+    bool waiting_{false};                          // A wakeup is registered with the broadcast
+    clock::time_point start_deadline_;
+    clock::time_point last_data_;
+};
+
+void StreamPipe::Joiner::begin() {
+    start_deadline_ = clock::now() + broadcast_->config().start_timeout;
+    broadcast_->async_wait_started([self = self()]() {
+        self->post([self]() {
+            self->on_started();
+            self->pump();
+        });
+    });
+}
+
+void StreamPipe::Joiner::on_started() {
+    if (finished()) {
+        return;
+    }
+
+    // join() fails if the leader ended without streaming, or the replay window was exceeded
+    auto cursor = broadcast_->join();
+    if (!cursor) {
+        spdlog::debug("StreamPipe: Cannot join shared stream");
+        hand_back();
+        return;
+    }
+
+    joined_ = true;
+    cursor_ = *cursor;
+    last_data_ = clock::now();
+    util::Metrics::instance().stream_shared();
+    spdlog::debug("StreamPipe: Joined shared stream, replaying from chunk {}", cursor_);
+    write_header(broadcast_->header());
+}
+
+StreamPipe::Feed::Fetch StreamPipe::Joiner::fetch(std::vector<asio::const_buffer>& out) {
+    switch (broadcast_->read(cursor_, chunks_)) {
+    case StreamBroadcast::ReadStatus::data:
+        last_data_ = clock::now();
+        for (const auto& chunk : chunks_) {
+            out.push_back(asio::buffer(*chunk));
         }
+        return Fetch::data;
 
-        // If [DONE] marker was found, we can stop
-        if (result.done_marker_received) {
-            spdlog::debug("StreamPipe: Stopping after [DONE] marker");
-            break;
+    case StreamBroadcast::ReadStatus::finished:
+        if (!broadcast_->succeeded()) {
+            result().error_message = "Shared stream ended abnormally";
+            spdlog::warn("StreamPipe: {}", result().error_message);
         }
+        return Fetch::end;
+
+    case StreamBroadcast::ReadStatus::dropped:
+        result().error_message = "Fell behind shared stream replay window";
+        spdlog::warn("StreamPipe: Joined client too slow, dropping from shared stream");
+        return Fetch::end;
+
+    case StreamBroadcast::ReadStatus::pending:
+        break;
     }
 
-    // Send final chunk to properly terminate chunked encoding
-    write_final_chunk(client_stream, ec);
+    if (!waiting_) {
+        waiting_ = true;
+        broadcast_->async_wait_data(cursor_, [self = self()]() {
+            self->post([self]() {
+                self->waiting_ = false;
+                self->pump();
+            });
+        });
+    }
+    return Fetch::wait;
+}
 
-    auto end_time = std::chrono::steady_clock::now();
-    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+StreamPipe::Joiner::clock::time_point StreamPipe::Joiner::expires_at() const {
+    return joined_ ? last_data_ + config().read_timeout : start_deadline_;
+}
 
-    // Success if we transferred data without critical errors
-    result.success = result.error_message.empty() ||
-                     result.client_disconnected ||
-                     result.backend_closed ||
-                     result.done_marker_received;
+void StreamPipe::Joiner::on_expired() {
+    if (!joined_) {
+        spdlog::debug("StreamPipe: Shared stream did not start in time");
+        hand_back();
+        return;
+    }
+    result().timed_out = true;
+    result().error_message = "Timed out waiting for shared stream data";
+    spdlog::warn("StreamPipe: {}", result().error_message);
+}
+
+void StreamPipe::Joiner::on_handed_back() {
+    auto on_unjoined = std::move(on_unjoined_);
+    on_unjoined_ = nullptr;
+    on_unjoined();
+}
+
+// ============================================================================
+// Replay - a stored stream written to a client
+// ============================================================================
+
+/**
+ * Feed of a cached stream to a client
+ *
+ * Writes one event per chunk. With a replay_event_interval, each event
+ * after the first waits on the feed's timer until the interval since the
+ * previous one has passed, while the client watch still catches a hang-up.
+ */
+class StreamPipe::Replay : public StreamPipe::Feed {
+public:
+    Replay(std::shared_ptr<StreamPipe> pipe,
+           const http::response_header<>& response_header,
+           std::vector<std::string> events,
+           beast::tcp_stream& client_stream,
+           StreamCompletion on_complete)
+        : Feed(std::move(pipe), client_stream, std::move(on_complete))
+        , header_(response_header)
+        , events_(std::move(events))
+    {
+    }
+
+private:
+    void begin() override { write_header(header_); }
+    Fetch fetch(std::vector<asio::const_buffer>& out) override;
+    clock::time_point wake_at() const override { return next_ > 0 ? next_at_ : clock::time_point::max(); }
+    void on_expired() override;
 
-    spdlog::info("StreamPipe: Stream complete - {} bytes in {}ms (client_disconnect={}, backend_closed={}, done={})",
-                 result.bytes_forwarded, result.duration.count(),
-                 result.client_disconnected, result.backend_closed, result.done_marker_received);
+    http::response_header<> header_;
+    std::vector<std::string> events_;
+    std::size_t next_{0};                          // Next event to write
+    clock::time_point next_at_;                    // When it is due, if paced
+};
 
-    return result;
+StreamPipe::Feed::Fetch StreamPipe::Replay::fetch(std::vector<asio::const_buffer>& out) {
+    if (next_ == events_.size()) {
+        spdlog::debug("StreamPipe: Replayed {} cached events", events_.size());
+        return Fetch::end;
+    }
+
+    auto now = clock::now();
+    auto interval = config().replay_event_interval;
+    if (interval.count() > 0 && next_ > 0 && now < next_at_) {
+        return Fetch::wait;
+    }
+
+    out.push_back(asio::buffer(events_[next_]));
+    ++next_;
+    next_at_ = now + interval;
+    return Fetch::data;
+}
+
+void StreamPipe::Replay::on_expired() {
+    result().timed_out = true;
+    result().error_message = "Stream deadline passed during replay";
+    spdlog::warn("StreamPipe: {}", result().error_message);
+}
+
+// ============================================================================
+// StreamPipe stream forwarding
+// ============================================================================
+
+void StreamPipe::async_forward_stream(
+    tcp::socket& backend_socket,
+    beast::tcp_stream& client_stream,
+    const http::response_header<>& response_header,
+    std::string initial_body,
+    StreamObservers observers,
+    StreamCompletion on_complete,
+    StreamProgressCallback progress_callback)
+{
+    spdlog::debug("StreamPipe: Starting stream forwarding");
+
+    auto relay = std::make_shared<Relay>(shared_from_this(), backend_socket, client_stream, response_header,
+                                         std::move(observers), std::move(progress_callback),
+                                         std::move(on_complete));
+    relay->start(std::move(initial_body));
+}
+
+void StreamPipe::async_forward_broadcast(
+    std::shared_ptr<StreamBroadcast> broadcast,
+    beast::tcp_stream& client_stream,
+    std::function<void()> on_unjoined,
+    StreamCompletion on_complete)
+{
+    auto joiner = std::make_shared<Joiner>(shared_from_this(), std::move(broadcast), client_stream,
+                                           std::move(on_unjoined), std::move(on_complete));
+    joiner->start();
+}
+
+void StreamPipe::async_forward_events(
+    const http::response_header<>& response_header,
+    std::vector<std::string> events,
+    beast::tcp_stream& client_stream,
+    StreamCompletion on_complete)
+{
+    auto replay = std::make_shared<Replay>(shared_from_this(), response_header, std::move(events),
+                                           client_stream, std::move(on_complete));
+    replay->start();
 }
 
 } // namespace ntonix::proxy
@@ -8,6 +8,7 @@
 
 #include "config/config.hpp"
 #include "proxy/connection_pool.hpp"
+#include "util/metrics.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/beast/core.hpp>
@@ -18,6 +19,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace ntonix::proxy {
 
@@ -26,14 +28,54 @@ namespace beast = boost::beast;
 namespace http = beast::http;
 using tcp = asio::ip::tcp;
 
+/**
+ * What a stream does once client_buffer_bytes are waiting for its client
+ */
+enum class SlowClientPolicy {
+    block,   // Pause backend reads until the client catches up (backpressure reaches the backend)
+    drop,    // Block, then disconnect a client stalled for slow_client_timeout (observers still get the stream)
+    spill    // Keep reading into memory drawn from a shared SpillBudget, blocking once it is spent
+};
+
+/**
+ * Spill Budget - process-wide allowance for stream bytes held beyond
+ * client_buffer_bytes under SlowClientPolicy::spill
+ */
+class SpillBudget {
+public:
+    explicit SpillBudget(std::size_t limit) : limit_(limit) {}
+
+    /**
+     * Take `bytes` from the budget, or nothing if that would exceed it
+     */
+    bool try_reserve(std::size_t bytes);
+
+    void release(std::size_t bytes);
+
+    std::size_t used() const { return used_.load(std::memory_order_relaxed); }
+    std::size_t limit() const { return limit_; }
+
+private:
+    const std::size_t limit_;
+    std::atomic<std::size_t> used_{0};
+};
+
 /**
  * Configuration for stream pipe
  */
 struct StreamPipeConfig {
-    std::size_t buffer_size{8192};                    // Read buffer size for chunks
+    std::size_t buffer_size{8192};                    // Initial read buffer size (adapts to the backend's pace)
     std::chrono::seconds read_timeout{120};           // Timeout for streaming reads
-    bool detect_done_marker{true};                    // Stop on [DONE] marker (SSE convention)
+    bool detect_done_marker{true};                    // Stop after the terminal [DONE] event (SSE convention)
     bool forward_chunked{true};                       // Use chunked transfer encoding to client
+    std::chrono::milliseconds replay_event_interval{0}; // Pause between events replayed from cache (0 = none)
+    std::chrono::microseconds coalesce_window{0};     // Hold chunks this long for more to join the write (0 = none)
+    std::size_t coalesce_bytes{4096};                 // Write held chunks once this many bytes are waiting
+    std::size_t client_buffer_bytes{65536};           // Bytes held for a slow client before slow_client_policy applies
+    SlowClientPolicy slow_client_policy{SlowClientPolicy::block};
+    std::chrono::milliseconds slow_client_timeout{2000}; // Stall after which SlowClientPolicy::drop disconnects
+    std::shared_ptr<SpillBudget> spill_budget;        // Shared allowance for SlowClientPolicy::spill
+    bool cancel_on_half_close{true};                  // A client's half-close counts as a disconnect
 };
 
 /**
@@ -47,6 +89,11 @@ struct StreamResult {
     bool client_disconnected{false};      // True if client disconnected early
     bool backend_closed{false};           // True if backend closed connection
     bool done_marker_received{false};     // True if [DONE] marker was detected
+    bool timed_out{false};                // True if the backend went idle or the deadline passed
+    bool slow_client_dropped{false};      // True if the client fell too far behind (SlowClientPolicy::drop)
+    std::chrono::milliseconds client_stall{0};  // Time client_buffer_bytes or more were waiting for the client
+    bool backend_reusable{false};         // True if the backend body was read exactly to its end
+    util::StreamTiming timing;            // Latency profile (time_to_header is filled in by the forwarder)
 };
 
 /**
@@ -55,21 +102,66 @@ struct StreamResult {
  */
 using StreamProgressCallback = std::function<bool(std::size_t bytes_forwarded)>;
 
+/**
+ * Completion handler of an asynchronous stream, called once with its outcome
+ */
+using StreamCompletion = std::function<void(StreamResult)>;
+
+/**
+ * Observer of a forwarded stream
+ *
+ * Lets other components (fan-out to joined clients, caching) see the stream
+ * without the pipe depending on them. Callbacks run on the stream's strand,
+ * one at a time:
+ * - on_stream_start: the response header has been sent to the client
+ * - on_stream_data: a chunk was read from the backend (before the client write)
+ * - on_stream_end: the backend stream ended or sent [DONE], always called after
+ *   on_stream_start.
+ *   The client may still be receiving the last write, so only the backend's
+ *   side of the result (done marker, errors, success) is final.
+ *
+ * An observer that returns true from wants_completion() keeps the pipe reading
+ * the backend to the end after the client has disconnected.
+ */
+class StreamObserver {
+public:
+    virtual ~StreamObserver() = default;
+
+    virtual void on_stream_start(const http::response_header<>& /*header*/) {}
+    virtual void on_stream_data(const char* /*data*/, std::size_t /*size*/) {}
+    virtual void on_stream_end(const StreamResult& /*result*/) {}
+    virtual bool wants_completion() const { return false; }
+};
+
+using StreamObservers = std::vector<std::shared_ptr<StreamObserver>>;
+
+class StreamBroadcast;
+
 /**
  * Stream Pipe - forwards SSE streams from backends to clients with zero-copy semantics
  *
  * Features:
- * - Zero-copy forwarding using asio::const_buffer
+ * - Asynchronous relay on the io_context: no thread is held per stream, and
+ *   backend reads overlap client writes (no per-chunk disconnect probing)
+ * - Optional write coalescing: chunks held up to coalesce_window are sent in one write
+ * - Bounded buffering for slow clients: block, drop or spill once client_buffer_bytes wait
  * - Chunk-by-chunk forwarding without buffering entire response
- * - Client disconnect detection to abort backend reads early
- * - SSE [DONE] marker detection
+ * - Backend framing decoded to the exact end of the body, so the connection can be pooled again
+ * - Pooled read buffer that grows for fast backends and shrinks for trickling ones
+ * - Client disconnect detection (reset/close, or a failed write) to abort backend reads early
+ * - Exact SSE event boundary and [DONE] detection across reads
  * - Chunked transfer encoding support
+ * - Observer hooks and fan-out of one backend stream to joined clients
+ * - Replay of cached streams
  *
  * Usage:
- * 1. Create StreamPipe with client stream and config
- * 2. Call start_streaming() with backend connection
- * 3. Streaming happens asynchronously
- * 4. Get result via callback or poll
+ * 1. Create the pipe with make_stream_pipe() (each stream it runs holds it alive)
+ * 2. Call async_forward_stream() with the backend socket and client stream
+ * 3. Streaming happens asynchronously on the io_context
+ * 4. The completion handler receives the StreamResult
+ *
+ * async_forward_broadcast() and async_forward_events() serve joined clients
+ * and cache hits the same way, without a backend socket of their own.
  */
 class StreamPipe : public std::enable_shared_from_this<StreamPipe> {
 public:
@@ -89,23 +181,83 @@ public:
     StreamPipe& operator=(const StreamPipe&) = delete;
 
     /**
-     * Forward a streaming response from backend to client (synchronous)
-     * This reads chunks from the backend socket and writes them to the client socket.
+     * Forward a streaming response from backend to client
+     * Returns at once; the relay runs as asynchronous reads and writes on
+     * the io_context and calls on_complete when the stream ends. Both
+     * sockets must stay open until then, and are no longer in use by it
+     * when it runs.
      *
      * @param backend_socket Socket connected to the backend
      * @param client_stream Beast TCP stream to the client
      * @param response_header The HTTP response header (already read from backend)
-     * @param initial_body Any initial body data already read with the header
+     * @param initial_body Any body bytes already read with the header, still framed
+     * @param observers Observers notified of the stream's header, chunks and end
+     * @param on_complete Called once with the outcome
      * @param progress_callback Optional callback for progress updates
-     * @return StreamResult with outcome
      */
-    StreamResult forward_stream(
+    void async_forward_stream(
         tcp::socket& backend_socket,
         beast::tcp_stream& client_stream,
         const http::response_header<>& response_header,
-        const std::string& initial_body,
+        std::string initial_body,
+        StreamObservers observers,
+        StreamCompletion on_complete,
         StreamProgressCallback progress_callback = nullptr);
 
+    /**
+     * Forward a shared stream to a joining client (fan-out)
+     * Returns at once. Waits for the leader's header (up to the broadcast's
+     * start_timeout) and joins the stream, then replays the chunks the
+     * broadcast already holds and follows new chunks as the leader's pipe
+     * publishes them, writing at this client's own pace. Nothing holds a
+     * thread while the client waits for the leader.
+     * Bounded by read_timeout between chunks and by the deadline; a client
+     * write that cannot complete within read_timeout (slow_client_timeout
+     * under SlowClientPolicy::drop) drops the client.
+     * Succeeds only if the leader's stream ended cleanly.
+     *
+     * @param broadcast The shared stream to join
+     * @param client_stream Beast TCP stream to the joining client
+     * @param on_unjoined Called instead of on_complete if the stream cannot be
+     *                    joined (the leader failed or never started, or the replay
+     *                    window was exceeded); nothing has been written to the client
+     * @param on_complete Called once with the outcome of a joined stream
+     */
+    void async_forward_broadcast(
+        std::shared_ptr<StreamBroadcast> broadcast,
+        beast::tcp_stream& client_stream,
+        std::function<void()> on_unjoined,
+        StreamCompletion on_complete);
+
+    /**
+     * Replay a stored stream to a client as SSE (cache hit)
+     * Returns at once. Events are written one chunk each, paced by
+     * replay_event_interval on a timer; a client that hangs up during a
+     * pause ends the replay at once. The deadline ends the replay as timed
+     * out, and client writes are bounded as for async_forward_broadcast().
+     *
+     * @param response_header Header to send to the client
+     * @param events Complete SSE events, in order
+     * @param client_stream Beast TCP stream to the client
+     * @param on_complete Called once with the outcome
+     */
+    void async_forward_events(
+        const http::response_header<>& response_header,
+        std::vector<std::string> events,
+        beast::tcp_stream& client_stream,
+        StreamCompletion on_complete);
+
+    /**
+     * Bound the whole stream by an absolute deadline (in addition to read_timeout)
+     */
+    void set_deadline(std::chrono::steady_clock::time_point deadline) { deadline_ = deadline; }
+
+    /**
+     * When the request was sent to the backend, the origin of time_to_first_event
+     * (defaults to the start of async_forward_stream())
+     */
+    void set_request_sent(std::chrono::steady_clock::time_point sent) { request_sent_ = sent; }
+
     /**
      * Check if this is a streaming response (based on Content-Type and status)
      * OpenAI streaming uses Content-Type: text/event-stream
@@ -119,33 +271,35 @@ public:
 
 private:
     /**
-     * Check if data contains the SSE [DONE] marker
+     * The response header sent to the client, derived from the backend header
      */
-    bool contains_done_marker(const char* data, std::size_t size) const;
+    http::response<http::empty_body> client_response_header(
+        const http::response_header<>& response_header) const;
 
     /**
-     * Write a chunk to client using chunked transfer encoding
-     * Returns number of bytes written, or 0 on error
+     * Deadline for a client write starting now: read_timeout away
+     * (slow_client_timeout under SlowClientPolicy::drop), capped by the deadline
      */
-    std::size_t write_chunk_to_client(
-        beast::tcp_stream& client_stream,
-        const char* data,
-        std::size_t size,
-        beast::error_code& ec);
+    std::chrono::steady_clock::time_point write_deadline() const;
 
     /**
-     * Write the final empty chunk (terminates chunked transfer)
+     * I/O state of one async_forward_stream() call
      */
-    bool write_final_chunk(beast::tcp_stream& client_stream, beast::error_code& ec);
+    class Relay;
 
     /**
-     * Check if client is still connected
+     * Client side of a stream the proxy already holds: a joined client of a
+     * shared stream (async_forward_broadcast()) or a cached replay
+     * (async_forward_events())
      */
-    bool is_client_connected(beast::tcp_stream& client_stream);
+    class Feed;
+    class Joiner;
+    class Replay;
 
     asio::io_context& io_context_;
     StreamPipeConfig config_;
-    std::vector<char> read_buffer_;
+    std::chrono::steady_clock::time_point deadline_{std::chrono::steady_clock::time_point::max()};
+    std::chrono::steady_clock::time_point request_sent_{};
 };
 
 /**
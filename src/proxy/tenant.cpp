@@ -0,0 +1,38 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Tenant implementation
+ */
+
+#include "proxy/tenant.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <string>
+
+namespace ntonix::proxy {
+
+namespace {
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+               return std::tolower(x) == std::tolower(y);
+           });
+}
+
+} // namespace
+
+std::uint64_t tenant_id(std::string_view authorization, std::string_view client_ip) {
+    while (!authorization.empty() && authorization.front() == ' ') authorization.remove_prefix(1);
+    if (authorization.size() >= 7 && iequals(authorization.substr(0, 7), "Bearer ")) {
+        authorization.remove_prefix(7);
+    }
+
+    if (authorization.empty()) {
+        return std::hash<std::string>{}("ip:" + std::string(client_ip));
+    }
+    return std::hash<std::string>{}("key:" + std::string(authorization));
+}
+
+} // namespace ntonix::proxy
@@ -0,0 +1,25 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Tenant - Identity of the client a request is accounted to
+ *
+ * Fair queueing and rate limiting both need to tell tenants apart: by API
+ * key where a request carries one, by client address otherwise.
+ */
+
+#ifndef NTONIX_PROXY_TENANT_HPP
+#define NTONIX_PROXY_TENANT_HPP
+
+#include <cstdint>
+#include <string_view>
+
+namespace ntonix::proxy {
+
+/**
+ * Tenant identity from an Authorization header, falling back to the
+ * client address for anonymous requests. Keys are hashed, never stored.
+ */
+std::uint64_t tenant_id(std::string_view authorization, std::string_view client_ip);
+
+} // namespace ntonix::proxy
+
+#endif // NTONIX_PROXY_TENANT_HPP
@@ -125,7 +125,8 @@ void Connection::on_read(beast::error_code ec, std::size_t bytes_transferred) {
         // Try streaming handler first if available
         streaming_handled_ = false;
         if (streaming_handler_) {
-            streaming_handled_ = streaming_handler_(parsed_req, stream_);
+            streaming_handled_ = streaming_handler_(parsed_req, stream_,
+                                                    [self = shared_from_this()]() { self->close(); });
         }
 
         // If streaming handler didn't handle it, use normal handler
@@ -143,10 +144,9 @@ void Connection::on_read(beast::error_code ec, std::size_t bytes_transferred) {
         }
     }
 
-    // If streaming was handled, response was already sent
+    // If streaming was handled, the handler closes the connection once the
+    // response is complete (we don't keep it alive after a stream)
     if (streaming_handled_) {
-        // For streaming, we don't keep the connection alive after
-        close();
         return;
     }
 
@@ -213,6 +213,7 @@ HttpRequest Connection::parse_request(const http::request<http::string_body>& re
     // Client connection info
     parsed.client_ip = client_ip_;
     parsed.client_port = client_port_;
+    parsed.client_socket = stream_.socket().native_handle();
 
     // Extract common headers (case-insensitive with Beast)
     if (auto it = req.find(http::field::host); it != req.end()) {
@@ -41,6 +41,7 @@ struct HttpRequest {
     // Client connection info
     std::string client_ip;
     std::uint16_t client_port{0};
+    int client_socket{-1};  // Native handle, lets handlers notice a disconnect while blocked
 
     // Full headers access
     http::request<http::string_body> raw_request;
@@ -66,11 +67,15 @@ using RequestHandler = std::function<HttpResponse(const HttpRequest&)>;
 
 /**
  * Streaming request handler callback type
- * Takes the request and the client's TCP stream for direct streaming.
- * Returns true if streaming was handled (no normal response needed),
- * false if a normal HttpResponse should be sent.
+ * Takes the request, the client's TCP stream for direct streaming, and a
+ * callback that closes the connection.
+ * Returns true if streaming was handled (no normal response needed); the
+ * handler then calls done exactly once, possibly after returning, when the
+ * response is complete, and the stream stays open until it does.
+ * Returns false if a normal HttpResponse should be sent (done is not called).
  */
-using StreamingRequestHandler = std::function<bool(const HttpRequest&, beast::tcp_stream&)>;
+using StreamingRequestHandler = std::function<bool(const HttpRequest&, beast::tcp_stream&,
+                                                   std::function<void()> done)>;
 
 /**
  * Connection class - manages a single HTTP/1.1 client connection
@@ -280,6 +280,7 @@ HttpRequest SslConnection::parse_request(const http::request<http::string_body>&
     // Client connection info
     parsed.client_ip = client_ip_;
     parsed.client_port = client_port_;
+    parsed.client_socket = beast::get_lowest_layer(stream_).socket().native_handle();
 
     // Extract common headers (case-insensitive with Beast)
     if (auto it = req.find(http::field::host); it != req.end()) {
@@ -0,0 +1,122 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Buffer Pool implementation
+ */
+
+#include "util/buffer_pool.hpp"
+
+#include <atomic>
+#include <bit>
+#include <new>
+
+namespace ntonix::util {
+
+namespace {
+
+constexpr unsigned kMinShift = std::countr_zero(BufferPool::kMinBufferSize);
+
+static_assert(BufferPool::kMinBufferSize << (BufferPool::kSizeClasses - 1) == BufferPool::kMaxBufferSize,
+              "size classes must cover kMinBufferSize .. kMaxBufferSize");
+
+struct Counters {
+    std::atomic<std::uint64_t> in_use{0};
+    std::atomic<std::uint64_t> in_use_bytes{0};
+    std::atomic<std::uint64_t> idle{0};
+    std::atomic<std::uint64_t> idle_bytes{0};
+    std::atomic<std::uint64_t> allocated{0};
+    std::atomic<std::uint64_t> reused{0};
+};
+
+Counters counters;
+
+/**
+ * Idle buffers of one thread, freed when the thread exits
+ */
+struct ThreadCache {
+    char* buffers[BufferPool::kSizeClasses][BufferPool::kMaxIdlePerClass];
+    std::size_t counts[BufferPool::kSizeClasses]{};
+
+    ~ThreadCache() {
+        for (std::size_t c = 0; c < BufferPool::kSizeClasses; ++c) {
+            auto size = BufferPool::kMinBufferSize << c;
+            for (std::size_t i = 0; i < counts[c]; ++i) {
+                ::operator delete(buffers[c][i]);
+            }
+            counters.idle.fetch_sub(counts[c], std::memory_order_relaxed);
+            counters.idle_bytes.fetch_sub(counts[c] * size, std::memory_order_relaxed);
+        }
+    }
+};
+
+ThreadCache& thread_cache() {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+std::size_t class_index(std::size_t capacity) {
+    return static_cast<std::size_t>(std::countr_zero(capacity)) - kMinShift;
+}
+
+} // namespace
+
+std::size_t BufferPool::capacity_for(std::size_t size) {
+    if (size <= kMinBufferSize) {
+        return kMinBufferSize;
+    }
+    return size > kMaxBufferSize ? size : std::bit_ceil(size);
+}
+
+char* BufferPool::allocate(std::size_t size) {
+    auto capacity = capacity_for(size);
+    counters.in_use.fetch_add(1, std::memory_order_relaxed);
+    counters.in_use_bytes.fetch_add(capacity, std::memory_order_relaxed);
+
+    if (capacity <= kMaxBufferSize) {
+        auto& cache = thread_cache();
+        auto c = class_index(capacity);
+        if (cache.counts[c] > 0) {
+            counters.idle.fetch_sub(1, std::memory_order_relaxed);
+            counters.idle_bytes.fetch_sub(capacity, std::memory_order_relaxed);
+            counters.reused.fetch_add(1, std::memory_order_relaxed);
+            return cache.buffers[c][--cache.counts[c]];
+        }
+    }
+
+    counters.allocated.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<char*>(::operator new(capacity));
+}
+
+void BufferPool::deallocate(char* data, std::size_t size) noexcept {
+    if (!data) {
+        return;
+    }
+    auto capacity = capacity_for(size);
+    counters.in_use.fetch_sub(1, std::memory_order_relaxed);
+    counters.in_use_bytes.fetch_sub(capacity, std::memory_order_relaxed);
+
+    if (capacity <= kMaxBufferSize) {
+        auto& cache = thread_cache();
+        auto c = class_index(capacity);
+        if (cache.counts[c] < kMaxIdlePerClass) {
+            cache.buffers[c][cache.counts[c]++] = data;
+            counters.idle.fetch_add(1, std::memory_order_relaxed);
+            counters.idle_bytes.fetch_add(capacity, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    ::operator delete(data);
+}
+
+BufferPoolStats BufferPool::stats() {
+    BufferPoolStats stats;
+    stats.in_use = counters.in_use.load(std::memory_order_relaxed);
+    stats.in_use_bytes = counters.in_use_bytes.load(std::memory_order_relaxed);
+    stats.idle = counters.idle.load(std::memory_order_relaxed);
+    stats.idle_bytes = counters.idle_bytes.load(std::memory_order_relaxed);
+    stats.allocated = counters.allocated.load(std::memory_order_relaxed);
+    stats.reused = counters.reused.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace ntonix::util
@@ -0,0 +1,154 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * Buffer Pool - Per-thread recycling of I/O buffers in power-of-two size classes
+ *
+ * Streaming relays and backend response parsing each need a buffer for the
+ * length of one request. Taking them from the heap every time churns the
+ * allocator and scatters buffers across memory under many concurrent
+ * streams. The pool rounds requests up to a size class (1 KiB .. 64 KiB)
+ * and keeps released buffers on a free list of the releasing thread, so a
+ * thread serving request after request reuses the same few buffers. There
+ * are no locks: free lists are thread_local, occupancy counters are relaxed
+ * atomics. Larger requests bypass the pool.
+ */
+
+#ifndef NTONIX_UTIL_BUFFER_POOL_HPP
+#define NTONIX_UTIL_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace ntonix::util {
+
+/**
+ * Pool occupancy, summed over all threads
+ */
+struct BufferPoolStats {
+    std::uint64_t in_use{0};          // Buffers handed out and not yet released
+    std::uint64_t in_use_bytes{0};
+    std::uint64_t idle{0};            // Buffers waiting on free lists
+    std::uint64_t idle_bytes{0};
+    std::uint64_t allocated{0};       // Buffers taken from the heap
+    std::uint64_t reused{0};          // Buffers served from a free list
+};
+
+/**
+ * Buffer Pool - size-classed, thread-local free lists
+ *
+ * A buffer may be released on any thread; it joins that thread's free list.
+ * Each thread keeps at most kMaxIdlePerClass idle buffers per class and
+ * frees them when it exits.
+ */
+class BufferPool {
+public:
+    static constexpr std::size_t kMinBufferSize = 1024;
+    static constexpr std::size_t kMaxBufferSize = 64 * 1024;
+    static constexpr std::size_t kSizeClasses = 7;       // 1, 2, 4, ... 64 KiB
+    static constexpr std::size_t kMaxIdlePerClass = 32;
+
+    /**
+     * Capacity a request for `size` bytes actually gets: its size class, or
+     * `size` itself above kMaxBufferSize
+     */
+    static std::size_t capacity_for(std::size_t size);
+
+    /**
+     * Take a buffer of capacity_for(size) bytes
+     */
+    static char* allocate(std::size_t size);
+
+    /**
+     * Return a buffer; `size` must be the size it was allocated with
+     */
+    static void deallocate(char* data, std::size_t size) noexcept;
+
+    static BufferPoolStats stats();
+};
+
+/**
+ * Pooled Buffer - owns one pool buffer, released on destruction
+ */
+class PooledBuffer {
+public:
+    PooledBuffer() = default;
+
+    /**
+     * Acquire a buffer of at least `size` bytes (size() reports the capacity)
+     */
+    explicit PooledBuffer(std::size_t size)
+        : size_(BufferPool::capacity_for(size))
+        , data_(BufferPool::allocate(size_)) {
+    }
+
+    ~PooledBuffer() { reset(); }
+
+    PooledBuffer(PooledBuffer&& other) noexcept
+        : size_(other.size_)
+        , data_(other.data_) {
+        other.size_ = 0;
+        other.data_ = nullptr;
+    }
+
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            size_ = other.size_;
+            data_ = other.data_;
+            other.size_ = 0;
+            other.data_ = nullptr;
+        }
+        return *this;
+    }
+
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+    /**
+     * Give the buffer back to the pool
+     */
+    void reset() noexcept {
+        if (data_) {
+            BufferPool::deallocate(data_, size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+private:
+    std::size_t size_{0};
+    char* data_{nullptr};
+};
+
+/**
+ * Standard allocator over the pool, e.g. for beast::basic_flat_buffer
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return reinterpret_cast<T*>(BufferPool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        BufferPool::deallocate(reinterpret_cast<char*>(p), n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+};
+
+} // namespace ntonix::util
+
+#endif // NTONIX_UTIL_BUFFER_POOL_HPP
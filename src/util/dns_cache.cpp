@@ -0,0 +1,225 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * DNS Cache implementation
+ */
+
+#include "util/dns_cache.hpp"
+#include "util/metrics.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace ntonix::util {
+
+namespace {
+
+/**
+ * Retry interval after a failed lookup (capped by the TTL)
+ */
+constexpr std::chrono::milliseconds kRetryAfterFailure{1000};
+
+} // namespace
+
+DnsCache::DnsCache(asio::io_context& io_context, std::chrono::milliseconds ttl)
+    : io_context_(io_context)
+    , ttl_(ttl)
+{
+}
+
+std::vector<tcp::endpoint> DnsCache::endpoints(Entry& entry, std::uint16_t port) {
+    std::vector<tcp::endpoint> result;
+    auto count = entry.addresses.size();
+    result.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        result.emplace_back(entry.addresses[(entry.next + i) % count], port);
+    }
+    if (count > 0) {
+        entry.next = (entry.next + 1) % count;
+    }
+    return result;
+}
+
+std::vector<tcp::endpoint> DnsCache::resolve(const std::string& host, std::uint16_t port,
+                                             std::chrono::steady_clock::time_point deadline,
+                                             boost::system::error_code& ec) {
+    auto address = asio::ip::make_address(host, ec);
+    if (!ec) {
+        return {tcp::endpoint(address, port)};
+    }
+    ec.clear();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& entry = entries_[host];
+    if (!entry.addresses.empty()) {
+        bool expired = clock::now() >= entry.expires && !entry.refreshing;
+        if (expired) {
+            entry.refreshing = true;
+        }
+        auto result = endpoints(entry, port);
+        lock.unlock();
+
+        Metrics::instance().dns_lookup(true);
+        if (expired) {
+            refresh(host);
+        }
+        return result;
+    }
+
+    // First lookup of this host: nothing to serve meanwhile, so wait for it
+    bool start = !entry.refreshing;
+    entry.refreshing = true;
+    lock.unlock();
+
+    Metrics::instance().dns_lookup(false);
+    if (start) {
+        refresh(host);
+    }
+
+    lock.lock();
+    bool answered = answered_.wait_until(lock, deadline, [&entry] {
+        return !entry.addresses.empty() || !entry.refreshing;
+    });
+    if (entry.addresses.empty()) {
+        if (answered) {
+            ec = asio::error::host_not_found;
+        } else {
+            ec = asio::error::timed_out;
+        }
+        return {};
+    }
+    return endpoints(entry, port);
+}
+
+void DnsCache::async_resolve(const std::string& host, std::uint16_t port, ResolveHandler handler) {
+    boost::system::error_code ec;
+    auto address = asio::ip::make_address(host, ec);
+    if (!ec) {
+        asio::post(io_context_, [handler = std::move(handler), endpoint = tcp::endpoint(address, port)] {
+            handler({}, {endpoint});
+        });
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& entry = entries_[host];
+    if (!entry.addresses.empty()) {
+        bool expired = clock::now() >= entry.expires && !entry.refreshing;
+        if (expired) {
+            entry.refreshing = true;
+        }
+        asio::post(io_context_, [handler = std::move(handler), result = endpoints(entry, port)] {
+            handler({}, result);
+        });
+        lock.unlock();
+
+        Metrics::instance().dns_lookup(true);
+        if (expired) {
+            refresh(host);
+        }
+        return;
+    }
+
+    entry.waiters.emplace_back(port, std::move(handler));
+    bool start = !entry.refreshing;
+    entry.refreshing = true;
+    lock.unlock();
+
+    Metrics::instance().dns_lookup(false);
+    if (start) {
+        refresh(host);
+    }
+}
+
+void DnsCache::prefetch(const std::string& host) {
+    boost::system::error_code ec;
+    asio::ip::make_address(host, ec);
+    if (!ec) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& entry = entries_[host];
+        if (!entry.addresses.empty() || entry.refreshing) {
+            return;
+        }
+        entry.refreshing = true;
+    }
+    refresh(host);
+}
+
+void DnsCache::refresh(const std::string& host) {
+    spdlog::debug("DnsCache: Refreshing {}", host);
+
+    // Only addresses are kept; each lookup applies its own port. The answer
+    // is stored off the io_context, whose threads may be waiting for it.
+    auto resolver = std::make_shared<tcp::resolver>(asio::system_executor());
+    resolver->async_resolve(host, "0",
+        [self = shared_from_this(), host, resolver]
+        (const boost::system::error_code& ec, tcp::resolver::results_type results) {
+            self->store(host, ec, results);
+        });
+}
+
+void DnsCache::store(const std::string& host, const boost::system::error_code& ec,
+                     const tcp::resolver::results_type& results) {
+    std::vector<asio::ip::address> addresses;
+    if (!ec) {
+        for (const auto& entry : results) {
+            auto address = entry.endpoint().address();
+            if (std::find(addresses.begin(), addresses.end(), address) == addresses.end()) {
+                addresses.push_back(address);
+            }
+        }
+    }
+
+    bool failed = addresses.empty();
+    std::vector<std::pair<ResolveHandler, std::vector<tcp::endpoint>>> answers;
+    boost::system::error_code answer_ec;
+    std::size_t cached = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& entry = entries_[host];
+        entry.refreshing = false;
+
+        if (!failed) {
+            entry.addresses = std::move(addresses);
+            entry.next %= entry.addresses.size();
+            entry.expires = clock::now() + ttl_;
+        } else {
+            // Keep serving the last good answer, and try again soon
+            entry.expires = clock::now() + std::min(ttl_, kRetryAfterFailure);
+        }
+        cached = entry.addresses.size();
+        if (cached == 0) {
+            answer_ec = ec ? ec : asio::error::host_not_found;
+        }
+
+        for (auto& [port, handler] : entry.waiters) {
+            answers.emplace_back(std::move(handler), endpoints(entry, port));
+        }
+        entry.waiters.clear();
+    }
+    answered_.notify_all();
+
+    if (failed) {
+        Metrics::instance().dns_refresh_failed();
+        if (cached > 0) {
+            spdlog::warn("DnsCache: Lookup of {} failed ({}), serving {} cached addresses",
+                         host, ec ? ec.message() : "no addresses", cached);
+        } else {
+            spdlog::warn("DnsCache: Lookup of {} failed: {}", host, answer_ec.message());
+        }
+    } else {
+        spdlog::debug("DnsCache: {} resolved to {} addresses", host, cached);
+    }
+
+    for (auto& [handler, result] : answers) {
+        asio::post(io_context_, [handler = std::move(handler), result = std::move(result), answer_ec] {
+            handler(answer_ec, result);
+        });
+    }
+}
+
+} // namespace ntonix::util
@@ -0,0 +1,115 @@
+/**
+ * NTONIX - High-Performance AI Inference Gateway
+ * DNS Cache - Cached, background-refreshed resolution of backend host names
+ *
+ * Every new backend connection and every health check needs the backend's
+ * addresses. Looking them up each time puts the resolver's latency (and its
+ * outages) on the request path. The cache keeps the last answer per host for
+ * a TTL; an expired answer keeps being served while a lookup refreshes it in
+ * the background, and is kept if the refresh fails. Only the first lookup of
+ * a host waits for the resolver, and concurrent first lookups share one.
+ */
+
+#ifndef NTONIX_UTIL_DNS_CACHE_HPP
+#define NTONIX_UTIL_DNS_CACHE_HPP
+
+#include <boost/asio.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ntonix::util {
+
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+/**
+ * DNS Cache - thread-safe, shared by the connection pool and health checker
+ *
+ * Each lookup returns the host's addresses rotated by one, so connections
+ * (which try them in order) are spread across all addresses of a name.
+ * Numeric hosts are returned as is, without a lookup. Lookups complete on
+ * asio's system executor rather than the io_context, so a thread blocked in
+ * resolve() never holds up the lookup it is waiting for.
+ */
+class DnsCache : public std::enable_shared_from_this<DnsCache> {
+public:
+    using Ptr = std::shared_ptr<DnsCache>;
+    using ResolveHandler = std::function<void(const boost::system::error_code&, std::vector<tcp::endpoint>)>;
+
+    /**
+     * @param io_context Runs background refreshes and asynchronous lookups
+     * @param ttl How long an answer is used before it is refreshed
+     */
+    DnsCache(asio::io_context& io_context, std::chrono::milliseconds ttl);
+
+    // Non-copyable
+    DnsCache(const DnsCache&) = delete;
+    DnsCache& operator=(const DnsCache&) = delete;
+
+    /**
+     * Endpoints of host:port, waiting only if the host has no answer yet
+     * The wait joins the host's lookup in flight (starting one if needed) and
+     * gives up with asio::error::timed_out once the deadline passes.
+     */
+    std::vector<tcp::endpoint> resolve(const std::string& host, std::uint16_t port,
+                                       std::chrono::steady_clock::time_point deadline,
+                                       boost::system::error_code& ec);
+
+    /**
+     * Endpoints of host:port without blocking; handler runs on the io_context
+     */
+    void async_resolve(const std::string& host, std::uint16_t port, ResolveHandler handler);
+
+    /**
+     * Start a background lookup of a host not cached yet (e.g. a configured backend)
+     */
+    void prefetch(const std::string& host);
+
+    std::chrono::milliseconds ttl() const { return ttl_; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::vector<asio::ip::address> addresses;    // Last good answer (empty until the first one)
+        clock::time_point expires;
+        bool refreshing{false};                      // A background lookup is in flight
+        std::size_t next{0};                         // Rotation of the next lookup's first address
+        std::vector<std::pair<std::uint16_t, ResolveHandler>> waiters;   // async_resolve() calls awaiting a first answer
+    };
+
+    /**
+     * The entry's addresses with `port`, starting at the next in rotation (mutex_ held)
+     */
+    static std::vector<tcp::endpoint> endpoints(Entry& entry, std::uint16_t port);
+
+    /**
+     * Look the host up in the background (entry marked refreshing by the caller)
+     */
+    void refresh(const std::string& host);
+
+    /**
+     * Record a lookup's outcome and answer the waiters
+     */
+    void store(const std::string& host, const boost::system::error_code& ec,
+               const tcp::resolver::results_type& results);
+
+    asio::io_context& io_context_;
+    const std::chrono::milliseconds ttl_;
+
+    std::mutex mutex_;
+    std::condition_variable answered_;               // A lookup finished (resolve() waiters)
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+} // namespace ntonix::util
+
+#endif // NTONIX_UTIL_DNS_CACHE_HPP
@@ -4,17 +4,190 @@
  */
 
 #include "util/metrics.hpp"
+#include "util/buffer_pool.hpp"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
 namespace ntonix::util {
 
+namespace {
+
+/**
+ * Write a histogram as {"count", "sum", "mean", "buckets": {"<le>": cumulative count}}
+ */
+void write_histogram(std::ostringstream& json, const HistogramSnapshot& h, const std::string& indent) {
+    json << "{\n";
+    json << indent << "  \"count\": " << h.count << ",\n";
+    json << indent << "  \"sum\": " << h.sum << ",\n";
+    json << indent << "  \"mean\": " << h.mean() << ",\n";
+    json << indent << "  \"buckets\": {";
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < h.counts.size(); ++i) {
+        cumulative += h.counts[i];
+        json << (i > 0 ? ", " : "") << "\"";
+        if (i < h.bounds.size()) {
+            json << std::defaultfloat << std::setprecision(10) << h.bounds[i] << std::fixed << std::setprecision(4);
+        } else {
+            json << "+Inf";
+        }
+        json << "\": " << cumulative;
+    }
+    json << "}\n";
+    json << indent << "}";
+}
+
+/**
+ * Write streaming latency histograms as an object
+ */
+void write_stream_latency(std::ostringstream& json, const StreamLatencySnapshot& s, const std::string& indent) {
+    json << "{\n";
+    json << indent << "  \"streams\": " << s.streams << ",\n";
+    json << indent << "  \"time_to_header_ms\": ";
+    write_histogram(json, s.time_to_header_ms, indent + "  ");
+    json << ",\n";
+    json << indent << "  \"time_to_first_event_ms\": ";
+    write_histogram(json, s.time_to_first_event_ms, indent + "  ");
+    json << ",\n";
+    json << indent << "  \"event_gap_ms\": ";
+    write_histogram(json, s.event_gap_ms, indent + "  ");
+    json << ",\n";
+    json << indent << "  \"events_per_second\": ";
+    write_histogram(json, s.events_per_second, indent + "  ");
+    json << "\n";
+    json << indent << "}";
+}
+
+const std::vector<double> kStreamFirstByteBoundsMs{10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000};
+const std::vector<double> kStreamEventGapBoundsMs{1, 5, 10, 25, 50, 100, 250, 500, 1000};
+const std::vector<double> kStreamEventRateBounds{1, 5, 10, 25, 50, 100, 250, 500, 1000};
+const std::vector<double> kConnectBoundsMs{1, 5, 10, 25, 50, 100, 250, 500, 1000, 5000};
+const std::vector<double> kPoolWaitBoundsMs{1, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000};
+
+} // namespace
+
+// ============================================================================
+// Histogram Implementation
+// ============================================================================
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds))
+    , counts_(std::make_unique<std::atomic<std::uint64_t>[]>(bounds_.size() + 1))
+{
+}
+
+void Histogram::record(double value) {
+    auto bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+    counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    auto sum = sum_.load(std::memory_order_relaxed);
+    while (!sum_.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+    }
+}
+
+void Histogram::merge(const HistogramSnapshot& local) {
+    if (local.count == 0 || local.counts.size() != bounds_.size() + 1) {
+        return;
+    }
+    for (std::size_t i = 0; i < local.counts.size(); ++i) {
+        if (local.counts[i] > 0) {
+            counts_[i].fetch_add(local.counts[i], std::memory_order_relaxed);
+        }
+    }
+    count_.fetch_add(local.count, std::memory_order_relaxed);
+
+    auto sum = sum_.load(std::memory_order_relaxed);
+    while (!sum_.compare_exchange_weak(sum, sum + local.sum, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot snap;
+    snap.bounds = bounds_;
+    snap.counts.reserve(bounds_.size() + 1);
+    for (std::size_t i = 0; i <= bounds_.size(); ++i) {
+        snap.counts.push_back(counts_[i].load(std::memory_order_relaxed));
+    }
+    snap.count = count_.load(std::memory_order_relaxed);
+    snap.sum = sum_.load(std::memory_order_relaxed);
+    return snap;
+}
+
+void HistogramSnapshot::add(double value) {
+    auto bucket = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+    ++counts[bucket];
+    ++count;
+    sum += value;
+}
+
+// ============================================================================
+// StreamLatencyMetrics Implementation
+// ============================================================================
+
+StreamLatencyMetrics::StreamLatencyMetrics()
+    : time_to_header_ms(kStreamFirstByteBoundsMs)
+    , time_to_first_event_ms(kStreamFirstByteBoundsMs)
+    , event_gap_ms(kStreamEventGapBoundsMs)
+    , events_per_second(kStreamEventRateBounds)
+{
+}
+
+HistogramSnapshot StreamLatencyMetrics::empty_event_gaps() {
+    HistogramSnapshot gaps;
+    gaps.bounds = kStreamEventGapBoundsMs;
+    gaps.counts.assign(gaps.bounds.size() + 1, 0);
+    return gaps;
+}
+
+void StreamLatencyMetrics::record(const StreamTiming& timing) {
+    streams.fetch_add(1, std::memory_order_relaxed);
+    time_to_header_ms.record(timing.time_to_header.count() / 1000.0);
+    if (timing.events > 0) {
+        time_to_first_event_ms.record(timing.time_to_first_event.count() / 1000.0);
+    }
+    event_gap_ms.merge(timing.event_gaps_ms);
+
+    // The rate needs at least two events: (events - 1) gaps over the span between them
+    if (timing.events > 1 && timing.event_span.count() > 0) {
+        events_per_second.record((timing.events - 1) * 1e6 / timing.event_span.count());
+    }
+}
+
+StreamLatencySnapshot StreamLatencyMetrics::snapshot() const {
+    StreamLatencySnapshot snap;
+    snap.streams = streams.load(std::memory_order_relaxed);
+    snap.time_to_header_ms = time_to_header_ms.snapshot();
+    snap.time_to_first_event_ms = time_to_first_event_ms.snapshot();
+    snap.event_gap_ms = event_gap_ms.snapshot();
+    snap.events_per_second = events_per_second.snapshot();
+    return snap;
+}
+
+// ============================================================================
+// BackendMetrics Implementation
+// ============================================================================
+
+BackendMetrics::BackendMetrics()
+    : connect_ms(kConnectBoundsMs)
+    , pool_wait_ms(kPoolWaitBoundsMs)
+{
+}
+
+// ============================================================================
+// Metrics Implementation
+// ============================================================================
+
 // Static instance pointer
 Metrics* Metrics::instance_ = nullptr;
 
 Metrics::Metrics()
-    : start_time_(std::chrono::steady_clock::now())
+    : batch_size_({1, 2, 4, 8, 16, 32, 64})
+    , batch_wait_ms_({0.5, 1, 2, 5, 10, 25, 50, 100})
+    , stream_write_held_ms_({0.5, 1, 2, 5, 10, 25, 50})
+    , stream_client_stall_ms_({1, 10, 100, 1000, 10000})
+    , start_time_(std::chrono::steady_clock::now())
 {
 }
 
@@ -31,22 +204,22 @@ void Metrics::init(const std::vector<config::BackendConfig>& backends) {
 void Metrics::set_backends(const std::vector<config::BackendConfig>& backends) {
     std::lock_guard<std::mutex> lock(backends_mutex_);
 
-    // Clear old backends and create new ones
-    backends_.clear();
-
+    // Counters of a backend that stays (or comes back to its slot) carry over
     for (const auto& backend : backends) {
-        auto key = backend_key(backend.host, backend.port);
-        auto metrics = std::make_shared<BackendMetrics>();
+        if (backend.id == config::kNoBackendId || find_backend(backend.id)) {
+            continue;
+        }
+        auto slot = config::BackendRegistry::slot(backend.id);
+        auto metrics = std::make_unique<BackendMetrics>();
+        metrics->id = backend.id;
         metrics->host = backend.host;
         metrics->port = backend.port;
-        backends_[key] = metrics;
+        backend_slots_[slot].store(metrics.get(), std::memory_order_release);
+        retired_backends_[slot] = std::move(backends_[slot]);
+        backends_[slot] = std::move(metrics);
     }
 }
 
-std::string Metrics::backend_key(const std::string& host, std::uint16_t port) {
-    return host + ":" + std::to_string(port);
-}
-
 void Metrics::request_started() {
     requests_total_.fetch_add(1, std::memory_order_relaxed);
     requests_active_.fetch_add(1, std::memory_order_relaxed);
@@ -61,6 +234,18 @@ void Metrics::request_completed(bool success, std::chrono::milliseconds /*latenc
     }
 }
 
+void Metrics::request_timed_out() {
+    requests_timed_out_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::request_cancelled() {
+    requests_cancelled_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::request_rate_limited() {
+    requests_rate_limited_.fetch_add(1, std::memory_order_relaxed);
+}
+
 void Metrics::cache_hit() {
     cache_hits_.fetch_add(1, std::memory_order_relaxed);
 }
@@ -69,6 +254,66 @@ void Metrics::cache_miss() {
     cache_misses_.fetch_add(1, std::memory_order_relaxed);
 }
 
+void Metrics::cache_coalesced() {
+    cache_coalesced_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::stream_shared() {
+    streams_shared_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::retry_attempted() {
+    retries_total_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::retry_budget_exhausted() {
+    retries_budget_exhausted_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::queue_admitted(std::chrono::milliseconds waited) {
+    auto ms = static_cast<std::uint64_t>(waited.count());
+    queue_admitted_.fetch_add(1, std::memory_order_relaxed);
+    queue_wait_sum_ms_.fetch_add(ms, std::memory_order_relaxed);
+
+    auto max = queue_wait_max_ms_.load(std::memory_order_relaxed);
+    while (ms > max && !queue_wait_max_ms_.compare_exchange_weak(max, ms, std::memory_order_relaxed)) {
+    }
+}
+
+void Metrics::queue_rejected() {
+    queue_rejected_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::queue_dropped() {
+    queue_dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::queue_expired() {
+    queue_expired_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::set_queue_depth(std::uint64_t depth) {
+    queue_depth_.store(depth, std::memory_order_relaxed);
+}
+
+void Metrics::batch_sent(std::size_t size) {
+    batches_total_.fetch_add(1, std::memory_order_relaxed);
+    batched_requests_.fetch_add(size, std::memory_order_relaxed);
+    batch_size_.record(static_cast<double>(size));
+}
+
+void Metrics::batch_wait(std::chrono::microseconds added_wait) {
+    batch_wait_ms_.record(added_wait.count() / 1000.0);
+}
+
+void Metrics::dns_lookup(bool cached) {
+    (cached ? dns_hits_ : dns_misses_).fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::dns_refresh_failed() {
+    dns_refresh_failures_.fetch_add(1, std::memory_order_relaxed);
+}
+
 void Metrics::connection_opened() {
     connections_active_.fetch_add(1, std::memory_order_relaxed);
     connections_total_.fetch_add(1, std::memory_order_relaxed);
@@ -78,20 +323,8 @@ void Metrics::connection_closed() {
     connections_active_.fetch_sub(1, std::memory_order_relaxed);
 }
 
-void Metrics::backend_request(const std::string& host, std::uint16_t port,
-                              bool success, std::chrono::milliseconds latency) {
-    auto key = backend_key(host, port);
-
-    std::shared_ptr<BackendMetrics> metrics;
-    {
-        std::lock_guard<std::mutex> lock(backends_mutex_);
-        auto it = backends_.find(key);
-        if (it != backends_.end()) {
-            metrics = it->second;
-        }
-    }
-
-    if (metrics) {
+void Metrics::backend_request(config::BackendId backend, bool success, std::chrono::milliseconds latency) {
+    if (auto metrics = find_backend(backend)) {
         metrics->requests_total.fetch_add(1, std::memory_order_relaxed);
         if (success) {
             metrics->requests_success.fetch_add(1, std::memory_order_relaxed);
@@ -103,11 +336,103 @@ void Metrics::backend_request(const std::string& host, std::uint16_t port,
     }
 }
 
+void Metrics::backend_connected(config::BackendId backend, std::chrono::microseconds latency) {
+    if (auto metrics = find_backend(backend)) {
+        metrics->connect_ms.record(latency.count() / 1000.0);
+    }
+}
+
+void Metrics::backend_connect_failed(config::BackendId backend, bool timed_out) {
+    if (auto metrics = find_backend(backend)) {
+        metrics->connects_failed.fetch_add(1, std::memory_order_relaxed);
+        if (timed_out) {
+            metrics->connects_timed_out.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Metrics::backend_stale_connection(config::BackendId backend, bool retried) {
+    if (auto metrics = find_backend(backend)) {
+        (retried ? metrics->stale_retried : metrics->stale_on_checkout).fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::backend_pool_wait_started(config::BackendId backend) {
+    if (auto metrics = find_backend(backend)) {
+        metrics->pool_waiting.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::backend_pool_wait_finished(config::BackendId backend, std::chrono::microseconds waited, bool served) {
+    if (auto metrics = find_backend(backend)) {
+        metrics->pool_waiting.fetch_sub(1, std::memory_order_relaxed);
+        metrics->pool_wait_ms.record(waited.count() / 1000.0);
+        if (!served) {
+            metrics->pool_wait_timed_out.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Metrics::backend_pool_wait_rejected(config::BackendId backend) {
+    if (auto metrics = find_backend(backend)) {
+        metrics->pool_wait_rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::set_backend_pool_size(config::BackendId backend,
+                                    std::size_t open, std::size_t limit, std::size_t target) {
+    if (auto metrics = find_backend(backend)) {
+        metrics->pool_open.store(open, std::memory_order_relaxed);
+        metrics->pool_limit.store(limit, std::memory_order_relaxed);
+        metrics->pool_target.store(target, std::memory_order_relaxed);
+    }
+}
+
 std::uint64_t Metrics::uptime_seconds() const {
     auto now = std::chrono::steady_clock::now();
     return std::chrono::duration_cast<std::chrono::seconds>(now - start_time_).count();
 }
 
+void Metrics::stream_relayed(std::uint64_t chunks, std::uint64_t events, std::uint64_t writes) {
+    stream_chunks_.fetch_add(chunks, std::memory_order_relaxed);
+    stream_events_.fetch_add(events, std::memory_order_relaxed);
+    stream_writes_.fetch_add(writes, std::memory_order_relaxed);
+}
+
+void Metrics::stream_write_held(std::chrono::microseconds held) {
+    stream_write_held_ms_.record(held.count() / 1000.0);
+}
+
+void Metrics::stream_client_stalled(std::chrono::microseconds stalled) {
+    stream_client_stall_ms_.record(stalled.count() / 1000.0);
+}
+
+void Metrics::slow_client_dropped() {
+    slow_clients_dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::set_stream_spilled_bytes(std::uint64_t bytes) {
+    stream_spilled_bytes_.store(bytes, std::memory_order_relaxed);
+}
+
+void Metrics::stream_timing(config::BackendId backend,
+                            const std::string& model, const StreamTiming& timing) {
+    if (auto metrics = find_backend(backend)) {
+        metrics->streaming.record(timing);
+    }
+
+    // Model names come from clients, so the set of tracked models is capped
+    std::lock_guard<std::mutex> lock(stream_models_mutex_);
+    const std::string& name = model.empty() ? "unknown" : model;
+    auto it = stream_models_.find(name);
+    if (it == stream_models_.end()) {
+        it = stream_models_.size() < kMaxStreamModels
+            ? stream_models_.emplace(name, std::make_unique<StreamLatencyMetrics>()).first
+            : stream_models_.try_emplace("other", std::make_unique<StreamLatencyMetrics>()).first;
+    }
+    it->second->record(timing);
+}
+
 void Metrics::set_cache_memory(std::uint64_t bytes) {
     cache_memory_bytes_.store(bytes, std::memory_order_relaxed);
 }
@@ -120,15 +445,73 @@ MetricsSnapshot Metrics::snapshot() const {
     snap.requests_active = requests_active_.load(std::memory_order_relaxed);
     snap.requests_success = requests_success_.load(std::memory_order_relaxed);
     snap.requests_error = requests_error_.load(std::memory_order_relaxed);
+    snap.requests_timed_out = requests_timed_out_.load(std::memory_order_relaxed);
+    snap.requests_cancelled = requests_cancelled_.load(std::memory_order_relaxed);
+    snap.requests_rate_limited = requests_rate_limited_.load(std::memory_order_relaxed);
 
     // Cache metrics
     snap.cache_hits = cache_hits_.load(std::memory_order_relaxed);
     snap.cache_misses = cache_misses_.load(std::memory_order_relaxed);
+    snap.cache_coalesced = cache_coalesced_.load(std::memory_order_relaxed);
+    snap.streams_shared = streams_shared_.load(std::memory_order_relaxed);
     auto cache_total = snap.cache_hits + snap.cache_misses;
     snap.cache_hit_rate = cache_total > 0
         ? static_cast<double>(snap.cache_hits) / cache_total
         : 0.0;
 
+    // Retry metrics
+    snap.retries_total = retries_total_.load(std::memory_order_relaxed);
+    snap.retries_budget_exhausted = retries_budget_exhausted_.load(std::memory_order_relaxed);
+
+    // Request queue metrics
+    snap.queue_depth = queue_depth_.load(std::memory_order_relaxed);
+    snap.queue_admitted = queue_admitted_.load(std::memory_order_relaxed);
+    snap.queue_rejected = queue_rejected_.load(std::memory_order_relaxed);
+    snap.queue_dropped = queue_dropped_.load(std::memory_order_relaxed);
+    snap.queue_expired = queue_expired_.load(std::memory_order_relaxed);
+    snap.queue_wait_max_ms = queue_wait_max_ms_.load(std::memory_order_relaxed);
+    if (snap.queue_admitted > 0) {
+        snap.queue_wait_avg_ms = static_cast<double>(queue_wait_sum_ms_.load(std::memory_order_relaxed)) /
+                                 snap.queue_admitted;
+    }
+
+    // Micro-batching metrics
+    snap.batches_total = batches_total_.load(std::memory_order_relaxed);
+    snap.batched_requests = batched_requests_.load(std::memory_order_relaxed);
+    snap.batch_size = batch_size_.snapshot();
+    snap.batch_wait_ms = batch_wait_ms_.snapshot();
+
+    // Stream relay metrics
+    snap.stream_chunks = stream_chunks_.load(std::memory_order_relaxed);
+    snap.stream_events = stream_events_.load(std::memory_order_relaxed);
+    snap.stream_writes = stream_writes_.load(std::memory_order_relaxed);
+    snap.stream_write_held_ms = stream_write_held_ms_.snapshot();
+    snap.stream_client_stall_ms = stream_client_stall_ms_.snapshot();
+    snap.slow_clients_dropped = slow_clients_dropped_.load(std::memory_order_relaxed);
+    snap.stream_spilled_bytes = stream_spilled_bytes_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(stream_models_mutex_);
+        for (const auto& [model, latency] : stream_models_) {
+            snap.stream_models.emplace_back(model, latency->snapshot());
+        }
+    }
+    std::sort(snap.stream_models.begin(), snap.stream_models.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // I/O buffer pool occupancy
+    auto buffers = BufferPool::stats();
+    snap.buffers_in_use = buffers.in_use;
+    snap.buffers_in_use_bytes = buffers.in_use_bytes;
+    snap.buffers_idle = buffers.idle;
+    snap.buffers_idle_bytes = buffers.idle_bytes;
+    snap.buffers_allocated = buffers.allocated;
+    snap.buffers_reused = buffers.reused;
+
+    // DNS cache metrics
+    snap.dns_hits = dns_hits_.load(std::memory_order_relaxed);
+    snap.dns_misses = dns_misses_.load(std::memory_order_relaxed);
+    snap.dns_refresh_failures = dns_refresh_failures_.load(std::memory_order_relaxed);
+
     // System metrics
     snap.uptime_seconds = uptime_seconds();
     snap.connections_active = connections_active_.load(std::memory_order_relaxed);
@@ -137,8 +520,12 @@ MetricsSnapshot Metrics::snapshot() const {
 
     // Per-backend metrics
     {
-        std::lock_guard<std::mutex> lock(backends_mutex_);
-        for (const auto& [key, metrics] : backends_) {
+        const auto& registry = config::BackendRegistry::instance();
+        for (std::size_t slot = 0; slot < registry.size(); ++slot) {
+            auto* metrics = backend_slots_[slot].load(std::memory_order_acquire);
+            if (!metrics || !registry.is_current(metrics->id)) {
+                continue;
+            }
             MetricsSnapshot::BackendSnapshot backend_snap;
             backend_snap.host = metrics->host;
             backend_snap.port = metrics->port;
@@ -146,6 +533,19 @@ MetricsSnapshot Metrics::snapshot() const {
             backend_snap.errors = metrics->requests_error.load(std::memory_order_relaxed);
             backend_snap.latency_avg_ms = metrics->latency_avg_ms();
             backend_snap.error_rate = metrics->error_rate();
+            backend_snap.streaming = metrics->streaming.snapshot();
+            backend_snap.connect_ms = metrics->connect_ms.snapshot();
+            backend_snap.connects_failed = metrics->connects_failed.load(std::memory_order_relaxed);
+            backend_snap.connects_timed_out = metrics->connects_timed_out.load(std::memory_order_relaxed);
+            backend_snap.stale_on_checkout = metrics->stale_on_checkout.load(std::memory_order_relaxed);
+            backend_snap.stale_retried = metrics->stale_retried.load(std::memory_order_relaxed);
+            backend_snap.pool_waiting = metrics->pool_waiting.load(std::memory_order_relaxed);
+            backend_snap.pool_wait_rejected = metrics->pool_wait_rejected.load(std::memory_order_relaxed);
+            backend_snap.pool_wait_timed_out = metrics->pool_wait_timed_out.load(std::memory_order_relaxed);
+            backend_snap.pool_wait_ms = metrics->pool_wait_ms.snapshot();
+            backend_snap.pool_open = metrics->pool_open.load(std::memory_order_relaxed);
+            backend_snap.pool_limit = metrics->pool_limit.load(std::memory_order_relaxed);
+            backend_snap.pool_target = metrics->pool_target.load(std::memory_order_relaxed);
             snap.backends.push_back(backend_snap);
         }
     }
@@ -164,16 +564,88 @@ std::string MetricsSnapshot::to_json() const {
     json << "    \"total\": " << requests_total << ",\n";
     json << "    \"active\": " << requests_active << ",\n";
     json << "    \"success\": " << requests_success << ",\n";
-    json << "    \"error\": " << requests_error << "\n";
+    json << "    \"error\": " << requests_error << ",\n";
+    json << "    \"timed_out\": " << requests_timed_out << ",\n";
+    json << "    \"cancelled\": " << requests_cancelled << ",\n";
+    json << "    \"rate_limited\": " << requests_rate_limited << "\n";
     json << "  },\n";
 
     // Cache metrics
     json << "  \"cache\": {\n";
     json << "    \"hits\": " << cache_hits << ",\n";
     json << "    \"misses\": " << cache_misses << ",\n";
+    json << "    \"coalesced\": " << cache_coalesced << ",\n";
+    json << "    \"streams_shared\": " << streams_shared << ",\n";
     json << "    \"hit_rate\": " << cache_hit_rate << "\n";
     json << "  },\n";
 
+    // Retry metrics
+    json << "  \"retries\": {\n";
+    json << "    \"total\": " << retries_total << ",\n";
+    json << "    \"budget_exhausted\": " << retries_budget_exhausted << "\n";
+    json << "  },\n";
+
+    // Request queue metrics
+    json << "  \"queue\": {\n";
+    json << "    \"depth\": " << queue_depth << ",\n";
+    json << "    \"admitted\": " << queue_admitted << ",\n";
+    json << "    \"rejected\": " << queue_rejected << ",\n";
+    json << "    \"dropped\": " << queue_dropped << ",\n";
+    json << "    \"expired\": " << queue_expired << ",\n";
+    json << "    \"wait_avg_ms\": " << queue_wait_avg_ms << ",\n";
+    json << "    \"wait_max_ms\": " << queue_wait_max_ms << "\n";
+    json << "  },\n";
+
+    // Micro-batching metrics
+    json << "  \"batching\": {\n";
+    json << "    \"batches\": " << batches_total << ",\n";
+    json << "    \"requests\": " << batched_requests << ",\n";
+    json << "    \"batch_size\": ";
+    write_histogram(json, batch_size, "    ");
+    json << ",\n";
+    json << "    \"added_wait_ms\": ";
+    write_histogram(json, batch_wait_ms, "    ");
+    json << "\n";
+    json << "  },\n";
+
+    // Stream relay metrics
+    json << "  \"streaming\": {\n";
+    json << "    \"chunks\": " << stream_chunks << ",\n";
+    json << "    \"events\": " << stream_events << ",\n";
+    json << "    \"writes\": " << stream_writes << ",\n";
+    json << "    \"write_held_ms\": ";
+    write_histogram(json, stream_write_held_ms, "    ");
+    json << ",\n";
+    json << "    \"client_stall_ms\": ";
+    write_histogram(json, stream_client_stall_ms, "    ");
+    json << ",\n";
+    json << "    \"slow_clients_dropped\": " << slow_clients_dropped << ",\n";
+    json << "    \"spilled_bytes\": " << stream_spilled_bytes << ",\n";
+    json << "    \"models\": {";
+    for (std::size_t i = 0; i < stream_models.size(); ++i) {
+        json << (i > 0 ? ",\n" : "\n") << "      " << nlohmann::json(stream_models[i].first).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace) << ": ";
+        write_stream_latency(json, stream_models[i].second, "      ");
+    }
+    json << (stream_models.empty() ? "}\n" : "\n    }\n");
+    json << "  },\n";
+
+    // I/O buffer pool occupancy
+    json << "  \"buffers\": {\n";
+    json << "    \"in_use\": " << buffers_in_use << ",\n";
+    json << "    \"in_use_bytes\": " << buffers_in_use_bytes << ",\n";
+    json << "    \"idle\": " << buffers_idle << ",\n";
+    json << "    \"idle_bytes\": " << buffers_idle_bytes << ",\n";
+    json << "    \"allocated\": " << buffers_allocated << ",\n";
+    json << "    \"reused\": " << buffers_reused << "\n";
+    json << "  },\n";
+
+    // Backend DNS cache
+    json << "  \"dns\": {\n";
+    json << "    \"hits\": " << dns_hits << ",\n";
+    json << "    \"misses\": " << dns_misses << ",\n";
+    json << "    \"refresh_failures\": " << dns_refresh_failures << "\n";
+    json << "  },\n";
+
     // System metrics
     json << "  \"system\": {\n";
     json << "    \"uptime_seconds\": " << uptime_seconds << ",\n";
@@ -192,7 +664,32 @@ std::string MetricsSnapshot::to_json() const {
         json << "      \"requests\": " << b.requests << ",\n";
         json << "      \"errors\": " << b.errors << ",\n";
         json << "      \"latency_avg_ms\": " << b.latency_avg_ms << ",\n";
-        json << "      \"error_rate\": " << b.error_rate << "\n";
+        json << "      \"error_rate\": " << b.error_rate << ",\n";
+        json << "      \"streaming\": ";
+        write_stream_latency(json, b.streaming, "      ");
+        json << ",\n";
+        json << "      \"connect\": {\n";
+        json << "        \"failed\": " << b.connects_failed << ",\n";
+        json << "        \"timed_out\": " << b.connects_timed_out << ",\n";
+        json << "        \"stale_on_checkout\": " << b.stale_on_checkout << ",\n";
+        json << "        \"stale_retried\": " << b.stale_retried << ",\n";
+        json << "        \"latency_ms\": ";
+        write_histogram(json, b.connect_ms, "        ");
+        json << "\n";
+        json << "      },\n";
+        json << "      \"pool_wait\": {\n";
+        json << "        \"waiting\": " << b.pool_waiting << ",\n";
+        json << "        \"rejected\": " << b.pool_wait_rejected << ",\n";
+        json << "        \"timed_out\": " << b.pool_wait_timed_out << ",\n";
+        json << "        \"wait_ms\": ";
+        write_histogram(json, b.pool_wait_ms, "        ");
+        json << "\n";
+        json << "      },\n";
+        json << "      \"pool_size\": {\n";
+        json << "        \"open\": " << b.pool_open << ",\n";
+        json << "        \"limit\": " << b.pool_limit << ",\n";
+        json << "        \"target\": " << b.pool_target << "\n";
+        json << "      }\n";
         json << "    }";
         if (i < backends.size() - 1) {
             json << ",";
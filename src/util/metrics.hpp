@@ -6,6 +6,12 @@
  * - Request counters (total, active, errors)
  * - Cache hit/miss statistics
  * - Per-backend metrics (requests, errors, latency)
+ * - Retry counters
+ * - Request queue depth and wait time
+ * - Micro-batch size and added wait histograms
+ * - I/O buffer pool occupancy
+ * - Streaming latency (time to header / first event, inter-event gaps,
+ *   events per second) per backend and per model
  * - System metrics (uptime, connections)
  * - Thread-safe collection using atomics
  */
@@ -13,22 +19,117 @@
 #ifndef NTONIX_UTIL_METRICS_HPP
 #define NTONIX_UTIL_METRICS_HPP
 
+#include "config/backend_registry.hpp"
 #include "config/config.hpp"
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace ntonix::util {
 
+/**
+ * Point-in-time copy of a histogram
+ */
+struct HistogramSnapshot {
+    std::vector<double> bounds;          // Bucket upper bounds; a final +Inf bucket is implied
+    std::vector<std::uint64_t> counts;   // Per bucket (not cumulative), bounds.size() + 1 entries
+    std::uint64_t count{0};
+    double sum{0.0};
+
+    double mean() const { return count > 0 ? sum / count : 0.0; }
+
+    /**
+     * Count a value in this copy, to be merged into a Histogram later
+     * (bounds and counts must be set, e.g. by Histogram::snapshot())
+     */
+    void add(double value);
+};
+
+/**
+ * Fixed-bucket histogram, recorded with relaxed atomics
+ */
+class Histogram {
+public:
+    /**
+     * @param bounds Ascending bucket upper bounds (inclusive)
+     */
+    explicit Histogram(std::vector<double> bounds);
+
+    void record(double value);
+
+    /**
+     * Add the values counted in a local copy with the same bounds
+     */
+    void merge(const HistogramSnapshot& local);
+
+    HistogramSnapshot snapshot() const;
+
+private:
+    std::vector<double> bounds_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> counts_;
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<double> sum_{0.0};
+};
+
+/**
+ * Latency profile of one relayed stream
+ */
+struct StreamTiming {
+    std::chrono::microseconds time_to_header{0};        // Backend request sent -> response header
+    std::chrono::microseconds time_to_first_event{0};   // Backend request sent -> first complete SSE event
+    std::chrono::microseconds event_span{0};            // First -> last complete event
+    std::uint64_t events{0};
+    HistogramSnapshot event_gaps_ms;                    // Gaps between consecutive events
+};
+
+/**
+ * Point-in-time copy of StreamLatencyMetrics
+ */
+struct StreamLatencySnapshot {
+    std::uint64_t streams{0};
+    HistogramSnapshot time_to_header_ms;
+    HistogramSnapshot time_to_first_event_ms;
+    HistogramSnapshot event_gap_ms;
+    HistogramSnapshot events_per_second;
+};
+
+/**
+ * Streaming latency histograms of one backend or model
+ */
+struct StreamLatencyMetrics {
+    StreamLatencyMetrics();
+
+    void record(const StreamTiming& timing);
+
+    StreamLatencySnapshot snapshot() const;
+
+    /**
+     * Empty local histogram with the event gap bounds, for StreamTiming::event_gaps_ms
+     */
+    static HistogramSnapshot empty_event_gaps();
+
+    std::atomic<std::uint64_t> streams{0};
+    Histogram time_to_header_ms;
+    Histogram time_to_first_event_ms;
+    Histogram event_gap_ms;
+    Histogram events_per_second;
+};
+
 /**
  * Per-backend metrics
  */
 struct BackendMetrics {
+    BackendMetrics();
+
+    config::BackendId id{config::kNoBackendId};
     std::string host;
     std::uint16_t port{0};
 
@@ -40,6 +141,29 @@ struct BackendMetrics {
     std::atomic<std::uint64_t> latency_sum_ms{0};
     std::atomic<std::uint64_t> latency_count{0};
 
+    // Streams relayed from this backend
+    StreamLatencyMetrics streaming;
+
+    // New pooled connections: time to resolve and connect, and failures
+    Histogram connect_ms;
+    std::atomic<std::uint64_t> connects_failed{0};
+    std::atomic<std::uint64_t> connects_timed_out{0};
+
+    // Idle connections the backend had closed: caught on checkout, or by a failed request
+    std::atomic<std::uint64_t> stale_on_checkout{0};
+    std::atomic<std::uint64_t> stale_retried{0};
+
+    // Checkouts that found the pool exhausted: queued, waited, gave up
+    std::atomic<std::uint64_t> pool_waiting{0};
+    std::atomic<std::uint64_t> pool_wait_rejected{0};
+    std::atomic<std::uint64_t> pool_wait_timed_out{0};
+    Histogram pool_wait_ms;
+
+    // Pool sizing: connections open, the current limit and the estimated need
+    std::atomic<std::uint64_t> pool_open{0};
+    std::atomic<std::uint64_t> pool_limit{0};
+    std::atomic<std::uint64_t> pool_target{0};
+
     // Computed metrics
     double latency_avg_ms() const {
         auto count = latency_count.load(std::memory_order_relaxed);
@@ -63,12 +187,59 @@ struct MetricsSnapshot {
     std::uint64_t requests_active{0};
     std::uint64_t requests_success{0};
     std::uint64_t requests_error{0};
+    std::uint64_t requests_timed_out{0};
+    std::uint64_t requests_cancelled{0};
+    std::uint64_t requests_rate_limited{0};
 
     // Cache metrics
     std::uint64_t cache_hits{0};
     std::uint64_t cache_misses{0};
+    std::uint64_t cache_coalesced{0};
+    std::uint64_t streams_shared{0};
     double cache_hit_rate{0.0};
 
+    // Retry metrics
+    std::uint64_t retries_total{0};
+    std::uint64_t retries_budget_exhausted{0};
+
+    // Request queue metrics
+    std::uint64_t queue_depth{0};
+    std::uint64_t queue_admitted{0};
+    std::uint64_t queue_rejected{0};
+    std::uint64_t queue_dropped{0};
+    std::uint64_t queue_expired{0};
+    double queue_wait_avg_ms{0.0};
+    std::uint64_t queue_wait_max_ms{0};
+
+    // Micro-batching metrics
+    std::uint64_t batches_total{0};
+    std::uint64_t batched_requests{0};
+    HistogramSnapshot batch_size;
+    HistogramSnapshot batch_wait_ms;
+
+    // Stream relay metrics
+    std::uint64_t stream_chunks{0};
+    std::uint64_t stream_events{0};
+    std::uint64_t stream_writes{0};
+    HistogramSnapshot stream_write_held_ms;
+    HistogramSnapshot stream_client_stall_ms;
+    std::uint64_t slow_clients_dropped{0};
+    std::uint64_t stream_spilled_bytes{0};
+    std::vector<std::pair<std::string, StreamLatencySnapshot>> stream_models;   // Sorted by model
+
+    // I/O buffer pool occupancy
+    std::uint64_t buffers_in_use{0};
+    std::uint64_t buffers_in_use_bytes{0};
+    std::uint64_t buffers_idle{0};
+    std::uint64_t buffers_idle_bytes{0};
+    std::uint64_t buffers_allocated{0};
+    std::uint64_t buffers_reused{0};
+
+    // Backend DNS cache
+    std::uint64_t dns_hits{0};
+    std::uint64_t dns_misses{0};
+    std::uint64_t dns_refresh_failures{0};
+
     // System metrics
     std::uint64_t uptime_seconds{0};
     std::uint64_t connections_active{0};
@@ -85,6 +256,19 @@ struct MetricsSnapshot {
         std::uint64_t errors{0};
         double latency_avg_ms{0.0};
         double error_rate{0.0};
+        StreamLatencySnapshot streaming;
+        HistogramSnapshot connect_ms;
+        std::uint64_t connects_failed{0};
+        std::uint64_t connects_timed_out{0};
+        std::uint64_t stale_on_checkout{0};
+        std::uint64_t stale_retried{0};
+        std::uint64_t pool_waiting{0};
+        std::uint64_t pool_wait_rejected{0};
+        std::uint64_t pool_wait_timed_out{0};
+        HistogramSnapshot pool_wait_ms;
+        std::uint64_t pool_open{0};
+        std::uint64_t pool_limit{0};
+        std::uint64_t pool_target{0};
     };
     std::vector<BackendSnapshot> backends;
 
@@ -120,18 +304,63 @@ public:
     // Request tracking
     void request_started();
     void request_completed(bool success, std::chrono::milliseconds latency);
+    void request_timed_out();   // Backend exchange cancelled by its deadline (504)
+    void request_cancelled();   // Backend generation abandoned because the client disconnected
+    void request_rate_limited();  // Refused with 429 by the token rate limiter
 
     // Cache tracking
     void cache_hit();
     void cache_miss();
+    void cache_coalesced();   // Request served from an identical in-flight request
+    void stream_shared();     // Streaming request attached to an identical in-flight stream
+
+    // Retry tracking
+    void retry_attempted();
+    void retry_budget_exhausted();
+
+    // Request queue tracking
+    void queue_admitted(std::chrono::milliseconds waited);
+    void queue_rejected();    // Queue full
+    void queue_dropped();     // Shed by CoDel
+    void queue_expired();     // Deadline passed while queued
+    void set_queue_depth(std::uint64_t depth);
+
+    // Micro-batching tracking
+    void batch_sent(std::size_t size);                       // One backend request carrying `size` prompts
+    void batch_wait(std::chrono::microseconds added_wait);   // Delay a request spent waiting for its batch
+
+    // Stream relay tracking
+    void stream_relayed(std::uint64_t chunks, std::uint64_t events,   // One finished stream's backend reads,
+                        std::uint64_t writes);                        // SSE events and client writes
+    void stream_write_held(std::chrono::microseconds held);            // Delay coalescing added to a client write
+    void stream_client_stalled(std::chrono::microseconds stalled);     // One period a client spent at client_buffer_bytes
+    void slow_client_dropped();                                        // Client disconnected by SlowClientPolicy::drop
+    void set_stream_spilled_bytes(std::uint64_t bytes);                // Spill budget in use
+    void stream_timing(config::BackendId backend,                    // One finished stream's latency profile,
+                       const std::string& model, const StreamTiming& timing);   // by backend and model
+
+    // Backend DNS cache tracking
+    void dns_lookup(bool cached);      // Answered from the cache (possibly expired) or waited for the resolver
+    void dns_refresh_failed();         // A lookup failed or returned no addresses
 
     // Connection tracking
     void connection_opened();
     void connection_closed();
 
     // Backend-specific tracking
-    void backend_request(const std::string& host, std::uint16_t port,
-                        bool success, std::chrono::milliseconds latency);
+    void backend_request(config::BackendId backend, bool success, std::chrono::milliseconds latency);
+    void backend_connected(config::BackendId backend,                  // New pool connection established
+                           std::chrono::microseconds latency);
+    void backend_connect_failed(config::BackendId backend,             // Connect failed or hit its timeout
+                                bool timed_out);
+    void backend_stale_connection(config::BackendId backend,           // Idle connection found closed
+                                  bool retried);
+    void backend_pool_wait_started(config::BackendId backend);         // Checkout queued on a full pool
+    void backend_pool_wait_finished(config::BackendId backend,         // Queued checkout served or timed out
+                                    std::chrono::microseconds waited, bool served);
+    void backend_pool_wait_rejected(config::BackendId backend);        // Pool and its wait queue full
+    void set_backend_pool_size(config::BackendId backend,              // Pool size after a resize
+                               std::size_t open, std::size_t limit, std::size_t target);
 
     /**
      * Get a snapshot of current metrics
@@ -156,26 +385,71 @@ private:
     Metrics(const Metrics&) = delete;
     Metrics& operator=(const Metrics&) = delete;
 
-    // Generate backend key
-    static std::string backend_key(const std::string& host, std::uint16_t port);
+    // Metrics of a registered backend, or null (also once its slot went to another backend)
+    BackendMetrics* find_backend(config::BackendId backend) const {
+        auto* metrics = backend_slots_[config::BackendRegistry::slot(backend)].load(std::memory_order_acquire);
+        return metrics && metrics->id == backend ? metrics : nullptr;
+    }
 
     // Global counters
     std::atomic<std::uint64_t> requests_total_{0};
     std::atomic<std::uint64_t> requests_active_{0};
     std::atomic<std::uint64_t> requests_success_{0};
     std::atomic<std::uint64_t> requests_error_{0};
+    std::atomic<std::uint64_t> requests_timed_out_{0};
+    std::atomic<std::uint64_t> requests_cancelled_{0};
+    std::atomic<std::uint64_t> requests_rate_limited_{0};
 
     std::atomic<std::uint64_t> cache_hits_{0};
     std::atomic<std::uint64_t> cache_misses_{0};
+    std::atomic<std::uint64_t> cache_coalesced_{0};
+    std::atomic<std::uint64_t> streams_shared_{0};
+
+    std::atomic<std::uint64_t> retries_total_{0};
+    std::atomic<std::uint64_t> retries_budget_exhausted_{0};
+
+    std::atomic<std::uint64_t> queue_depth_{0};
+    std::atomic<std::uint64_t> queue_admitted_{0};
+    std::atomic<std::uint64_t> queue_rejected_{0};
+    std::atomic<std::uint64_t> queue_dropped_{0};
+    std::atomic<std::uint64_t> queue_expired_{0};
+    std::atomic<std::uint64_t> queue_wait_sum_ms_{0};
+    std::atomic<std::uint64_t> queue_wait_max_ms_{0};
+
+    std::atomic<std::uint64_t> batches_total_{0};
+    std::atomic<std::uint64_t> batched_requests_{0};
+    Histogram batch_size_;
+    Histogram batch_wait_ms_;
+
+    std::atomic<std::uint64_t> stream_chunks_{0};
+    std::atomic<std::uint64_t> stream_events_{0};
+    std::atomic<std::uint64_t> stream_writes_{0};
+    Histogram stream_write_held_ms_;
+    Histogram stream_client_stall_ms_;
+    std::atomic<std::uint64_t> slow_clients_dropped_{0};
+    std::atomic<std::uint64_t> stream_spilled_bytes_{0};
+
+    std::atomic<std::uint64_t> dns_hits_{0};
+    std::atomic<std::uint64_t> dns_misses_{0};
+    std::atomic<std::uint64_t> dns_refresh_failures_{0};
 
     std::atomic<std::uint64_t> connections_active_{0};
     std::atomic<std::uint64_t> connections_total_{0};
 
     std::atomic<std::uint64_t> cache_memory_bytes_{0};
 
-    // Per-backend metrics
+    // Streaming latency per model, at most kMaxStreamModels (the rest count as "other")
+    static constexpr std::size_t kMaxStreamModels = 64;
+    mutable std::mutex stream_models_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<StreamLatencyMetrics>> stream_models_;
+
+    // Per-backend metrics, indexed by BackendRegistry::slot(); kept until the slot
+    // is reused, the snapshot lists the current generation's. A replaced backend's
+    // metrics live until the slot is reused again, for threads still holding them.
     mutable std::mutex backends_mutex_;
-    std::unordered_map<std::string, std::shared_ptr<BackendMetrics>> backends_;
+    std::array<std::unique_ptr<BackendMetrics>, config::BackendRegistry::kMaxBackends> backends_;
+    std::array<std::unique_ptr<BackendMetrics>, config::BackendRegistry::kMaxBackends> retired_backends_;
+    std::array<std::atomic<BackendMetrics*>, config::BackendRegistry::kMaxBackends> backend_slots_{};
 
     // Start time for uptime calculation
     std::chrono::steady_clock::time_point start_time_;
@@ -13,18 +13,32 @@ Usage:
 
     # Or with custom proxy URL:
     NTONIX_PROXY_URL=http://localhost:8080 pytest tests/integration/
+
+Tests that need a specific configuration or need to stop a backend use the
+local_stack fixture, which launches its own proxy binary (NTONIX_BINARY,
+default build/ntonix) and mock backends on free ports. They are skipped when
+the binary is not available.
 """
 
+import json
 import os
+import socket
+import subprocess
+import sys
 import time
 import pytest
 import requests
-from typing import Generator
+from pathlib import Path
+from typing import Generator, List, Optional
 
 # Default URLs - can be overridden via environment variables
 DEFAULT_PROXY_URL = "http://localhost:8080"
 DEFAULT_PROXY_SSL_URL = "https://localhost:8443"
 
+REPO_ROOT = Path(__file__).resolve().parents[2]
+MOCK_BACKEND = REPO_ROOT / "mock" / "simple_backend.py"
+DEFAULT_BINARY = REPO_ROOT / "build" / "ntonix"
+
 
 @pytest.fixture(scope="session")
 def proxy_url() -> str:
@@ -119,6 +133,116 @@ def reset_cache(proxy_url: str):
     yield
 
 
+def free_port() -> int:
+    """Ask the kernel for an unused TCP port."""
+    with socket.socket() as sock:
+        sock.bind(("127.0.0.1", 0))
+        return sock.getsockname()[1]
+
+
+def wait_for_http(url: str, timeout: float = 10.0) -> bool:
+    """Poll a URL until it answers 200 or the timeout expires."""
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        try:
+            if requests.get(url, timeout=1).status_code == 200:
+                return True
+        except requests.exceptions.RequestException:
+            pass
+        time.sleep(0.1)
+    return False
+
+
+class LocalStack:
+    """
+    A private proxy plus mock backends, for tests that need their own
+    configuration or have to stop a backend mid-test.
+    """
+
+    def __init__(self, binary: Path, workdir: Path):
+        self.binary = binary
+        self.workdir = workdir
+        self.backends: List[subprocess.Popen] = []
+        self.backend_ports: List[int] = []
+        self.proxy: Optional[subprocess.Popen] = None
+        self.url = ""
+
+    def start_backend(self, *args: str) -> int:
+        """Start a mock backend with extra simple_backend.py options; returns its port."""
+        port = free_port()
+        log = open(self.workdir / f"backend-{port}.log", "w")
+        process = subprocess.Popen(
+            [sys.executable, str(MOCK_BACKEND), str(port), *args],
+            stdout=log, stderr=subprocess.STDOUT)
+        if not wait_for_http(f"http://127.0.0.1:{port}/health"):
+            process.kill()
+            pytest.fail(f"Mock backend on port {port} did not start")
+        self.backends.append(process)
+        self.backend_ports.append(port)
+        return port
+
+    def stop_backend(self, port: int) -> None:
+        """Stop the mock backend listening on port."""
+        process = self.backends[self.backend_ports.index(port)]
+        process.terminate()
+        process.wait(timeout=5)
+
+    def start_proxy(self, config: dict, backends: Optional[List[dict]] = None) -> str:
+        """
+        Start the proxy with config merged over test defaults. Backends default
+        to every mock started so far. Returns the proxy base URL.
+        """
+        port = free_port()
+        settings = {
+            "server": {"port": port, "ssl_port": free_port(), "threads": 4},
+            "backends": backends if backends is not None else [
+                {"host": "127.0.0.1", "port": p, "weight": 1} for p in self.backend_ports],
+            "cache": {"enabled": False},
+            "logging": {"level": "info"},
+        }
+        for section, values in config.items():
+            if isinstance(values, dict):
+                settings.setdefault(section, {}).update(values)
+            else:
+                settings[section] = values
+
+        config_path = self.workdir / "ntonix.json"
+        config_path.write_text(json.dumps(settings))
+        log = open(self.workdir / "proxy.log", "w")
+        self.proxy = subprocess.Popen(
+            [str(self.binary), "-c", str(config_path)],
+            stdout=log, stderr=subprocess.STDOUT)
+        self.url = f"http://127.0.0.1:{port}"
+        if not wait_for_http(f"{self.url}/health"):
+            self.close()
+            pytest.fail(f"Proxy did not start; see {self.workdir / 'proxy.log'}")
+        return self.url
+
+    def metrics(self) -> dict:
+        return requests.get(f"{self.url}/metrics", timeout=5).json()
+
+    def close(self) -> None:
+        for process in [self.proxy, *self.backends]:
+            if process is not None and process.poll() is None:
+                process.terminate()
+                try:
+                    process.wait(timeout=5)
+                except subprocess.TimeoutExpired:
+                    process.kill()
+
+
+@pytest.fixture
+def local_stack(tmp_path: Path) -> Generator[LocalStack, None, None]:
+    """Private proxy and mock backends; skipped when no proxy binary is built."""
+    binary = Path(os.getenv("NTONIX_BINARY", DEFAULT_BINARY))
+    if not binary.is_file() or not os.access(binary, os.X_OK):
+        pytest.skip(f"NTONIX binary not found at {binary} (set NTONIX_BINARY)")
+
+    stack = LocalStack(binary, tmp_path)
+    yield stack
+    stack.close()
+
+
 def pytest_configure(config):
     """Configure custom pytest markers."""
     config.addinivalue_line(
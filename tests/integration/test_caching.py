@@ -7,6 +7,7 @@ returns cached responses for identical requests.
 
 import pytest
 import requests
+import json
 import time
 
 
@@ -213,3 +214,209 @@ class TestCaching:
         # Both should have valid responses (different cache entries)
         assert "choices" in response1.json()
         assert "choices" in response2.json()
+
+    def test_concurrent_identical_requests_are_coalesced(self, proxy_url: str):
+        """
+        Verify that identical requests arriving while the first is still
+        in flight share its backend response instead of each forwarding.
+        """
+        from concurrent.futures import ThreadPoolExecutor
+
+        request_data = {
+            "model": "coalesce-test-model",
+            "messages": [
+                {"role": "user", "content": f"Coalescing test {time.time()}"}
+            ],
+            "stream": False
+        }
+
+        def send():
+            return requests.post(
+                f"{proxy_url}/v1/chat/completions",
+                json=request_data,
+                headers={"Content-Type": "application/json"}
+            )
+
+        with ThreadPoolExecutor(max_workers=5) as pool:
+            responses = list(pool.map(lambda _: send(), range(5)))
+
+        assert all(r.status_code == 200 for r in responses)
+
+        # Exactly one request may have gone to the backend; the rest were
+        # coalesced with it or served from the cache it populated
+        sources = [r.headers.get("X-Cache") for r in responses]
+        assert sources.count("MISS") <= 1
+        assert all(s in ("MISS", "COALESCED", "HIT") for s in sources)
+
+        contents = {r.json()["choices"][0]["message"]["content"] for r in responses}
+        assert len(contents) == 1
+
+        metrics = requests.get(f"{proxy_url}/metrics").json()
+        assert "coalesced" in metrics["cache"]
+
+    def test_coalesced_request_bounded_by_own_deadline(self, local_stack):
+        """
+        Verify that a request waiting on an identical in-flight request gives
+        up at its own X-Request-Timeout rather than the leader's.
+        """
+        from concurrent.futures import ThreadPoolExecutor
+
+        local_stack.start_backend("--delay-ms", "1500")
+        local_stack.start_proxy({"cache": {"enabled": True}})
+        request_data = {
+            "model": "test-model",
+            "messages": [{"role": "user", "content": "Coalesced deadline test"}]
+        }
+
+        def send(headers):
+            started = time.monotonic()
+            response = requests.post(f"{local_stack.url}/v1/chat/completions",
+                                     json=request_data, headers=headers, timeout=10)
+            return response, time.monotonic() - started
+
+        with ThreadPoolExecutor(max_workers=2) as pool:
+            leader = pool.submit(send, {})
+            time.sleep(0.2)
+            follower = pool.submit(send, {"X-Request-Timeout": "300ms"})
+            follower_response, follower_elapsed = follower.result()
+            leader_response, _ = leader.result()
+
+        assert leader_response.status_code == 200
+        assert follower_response.status_code == 504
+        assert follower_elapsed < 1.0
+
+    def test_streamed_response_is_cached_for_both_formats(self, proxy_url: str):
+        """
+        Verify that a completed stream is cached and answers both a
+        non-streaming request (as JSON) and a later streaming request (as SSE).
+        """
+        messages = [{"role": "user", "content": f"Stream caching test {time.time()}"}]
+
+        # Complete stream populates the cache
+        stream_response = requests.post(
+            f"{proxy_url}/v1/chat/completions",
+            json={"model": "test-model", "messages": messages, "stream": True},
+            headers={"Content-Type": "application/json"},
+            stream=True,
+            timeout=60
+        )
+        assert stream_response.status_code == 200
+        for line in stream_response.iter_lines(decode_unicode=True):
+            if line == "data: [DONE]":
+                break
+
+        # Same request without streaming is served the assembled completion
+        json_response = requests.post(
+            f"{proxy_url}/v1/chat/completions",
+            json={"model": "test-model", "messages": messages},
+            headers={"Content-Type": "application/json"}
+        )
+        assert json_response.status_code == 200
+        assert json_response.headers.get("X-Cache") == "HIT"
+        content = json_response.json()["choices"][0]["message"]["content"]
+        assert len(content) > 0
+
+        # Streaming again replays the cached events
+        replay = requests.post(
+            f"{proxy_url}/v1/chat/completions",
+            json={"model": "test-model", "messages": messages, "stream": True},
+            headers={"Content-Type": "application/json"},
+            stream=True,
+            timeout=60
+        )
+        assert replay.status_code == 200
+        assert replay.headers.get("X-Cache") == "HIT"
+        assert "text/event-stream" in replay.headers.get("Content-Type", "")
+
+        parts = []
+        for line in replay.iter_lines(decode_unicode=True):
+            if not line or not line.startswith("data: "):
+                continue
+            if line == "data: [DONE]":
+                break
+            delta = json.loads(line[6:])["choices"][0].get("delta", {})
+            parts.append(delta.get("content", ""))
+        assert "".join(parts) == content
+
+    def test_tool_call_cached_for_both_formats(self, local_stack):
+        """
+        Verify that a tool-call completion cached in one form keeps its
+        tool calls when served in the other.
+        """
+        local_stack.start_backend()
+        local_stack.start_proxy({"cache": {"enabled": True}})
+        tools = [{"type": "function", "function": {"name": "get_weather", "parameters": {"type": "object"}}}]
+
+        def send(content, stream):
+            return requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json={"model": "test-model", "messages": [{"role": "user", "content": content}],
+                      "tools": tools, "stream": stream},
+                stream=stream,
+                timeout=10
+            )
+
+        def streamed_calls(response):
+            calls = {}
+            for line in response.iter_lines(decode_unicode=True):
+                if not line or not line.startswith("data: "):
+                    continue
+                if line == "data: [DONE]":
+                    break
+                choice = json.loads(line[6:])["choices"][0]
+                for fragment in choice.get("delta", {}).get("tool_calls", []):
+                    call = calls.setdefault(fragment["index"], {"function": {"name": "", "arguments": ""}})
+                    call.update({k: v for k, v in fragment.items() if k not in ("index", "function")})
+                    for key, value in fragment.get("function", {}).items():
+                        call["function"][key] += value
+            return [calls[index] for index in sorted(calls)]
+
+        expected = {"id": "call_mock", "type": "function",
+                    "function": {"name": "get_weather", "arguments": '{"city": "Paris"}'}}
+
+        # Streamed first, then served as JSON
+        stream = send("Weather, streamed first", True)
+        assert streamed_calls(stream) == [expected]
+
+        assembled = send("Weather, streamed first", False)
+        assert assembled.headers.get("X-Cache") == "HIT"
+        choice = assembled.json()["choices"][0]
+        assert choice["finish_reason"] == "tool_calls"
+        assert choice["message"]["content"] is None
+        assert choice["message"]["tool_calls"] == [expected]
+
+        # JSON first, then replayed as a stream
+        completion = send("Weather, JSON first", False)
+        assert completion.headers.get("X-Cache") == "MISS"
+        assert completion.json()["choices"][0]["message"]["tool_calls"] == [expected]
+
+        replay = send("Weather, JSON first", True)
+        assert replay.headers.get("X-Cache") == "HIT"
+        assert streamed_calls(replay) == [expected]
+
+    def test_embedding_inputs_cached_individually(self, proxy_url: str):
+        """
+        Verify that embedding inputs are cached one by one, so a request
+        overlapping an earlier one is partly served from cache, in order.
+        """
+        tag = time.time()
+        first = requests.post(
+            f"{proxy_url}/v1/embeddings",
+            json={"model": "embed-model", "input": [f"alpha {tag}", f"beta {tag}"]},
+            headers={"Content-Type": "application/json"}
+        )
+        assert first.status_code == 200
+        assert first.headers.get("X-Cache") == "MISS"
+        vectors = {f"alpha {tag}": first.json()["data"][0]["embedding"],
+                   f"beta {tag}": first.json()["data"][1]["embedding"]}
+
+        second = requests.post(
+            f"{proxy_url}/v1/embeddings",
+            json={"model": "embed-model", "input": [f"gamma {tag}", f"beta {tag}"]},
+            headers={"Content-Type": "application/json"}
+        )
+        assert second.status_code == 200
+        assert second.headers.get("X-Cache") == "PARTIAL"
+        data = second.json()["data"]
+        assert [item["index"] for item in data] == [0, 1]
+        assert data[1]["embedding"] == vectors[f"beta {tag}"]
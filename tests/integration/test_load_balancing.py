@@ -5,9 +5,31 @@ Verifies that the NTONIX proxy distributes requests evenly
 across available backend servers using round-robin algorithm.
 """
 
+import json
+import os
+import signal
+import time
+from collections import Counter
+from concurrent.futures import ThreadPoolExecutor
+
 import pytest
 import requests
-from collections import Counter
+
+
+def established_connections(port: int) -> int:
+    """Count established TCP connections accepted on a local port."""
+    count = 0
+    for table in ("/proc/net/tcp", "/proc/net/tcp6"):
+        try:
+            with open(table) as f:
+                rows = f.readlines()[1:]
+        except OSError:
+            continue
+        for row in rows:
+            fields = row.split()
+            if int(fields[1].rsplit(":", 1)[1], 16) == port and fields[3] == "01":
+                count += 1
+    return count
 
 
 class TestLoadBalancing:
@@ -163,3 +185,132 @@ class TestLoadBalancing:
         assert response.status_code in [200, 503], (
             "Request should either succeed (200) or fail with 503 if no backends"
         )
+
+    def test_priority_requests_pass_through_queue(self, proxy_url: str):
+        """
+        Test that priority and tenant headers are accepted and that the
+        request queue reports its state in metrics.
+        """
+        for priority in ["high", "normal", "low"]:
+            response = requests.post(
+                f"{proxy_url}/v1/chat/completions",
+                json={
+                    "model": "test",
+                    "messages": [{"role": "user", "content": f"Priority test {priority}"}],
+                    "stream": False
+                },
+                headers={
+                    "Content-Type": "application/json",
+                    "Cache-Control": "no-cache",
+                    "Authorization": "Bearer queue-test-tenant",
+                    "X-Priority": priority
+                }
+            )
+            assert response.status_code == 200
+
+        queue = requests.get(f"{proxy_url}/metrics").json()["queue"]
+        for field in ["depth", "admitted", "rejected", "dropped", "expired", "wait_avg_ms", "wait_max_ms"]:
+            assert field in queue
+
+    def test_interactive_tenant_admitted_ahead_of_batch_backlog(self, local_stack):
+        """
+        Test that with one backend slot, a tenant's single high priority
+        request is admitted ahead of another tenant's queued batch backlog.
+        """
+        local_stack.start_backend("--delay-ms", "200")
+        local_stack.start_proxy({
+            "server": {"threads": 12},
+            "queue": {"enabled": True, "max_concurrent": 1, "target_delay_ms": 10000}
+        })
+
+        def send(tenant, priority):
+            response = requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json={"model": "test", "messages": [{"role": "user", "content": f"{tenant} request"}]},
+                headers={"Authorization": f"Bearer {tenant}", "X-Priority": priority},
+                timeout=30
+            )
+            return response.status_code, time.monotonic()
+
+        with ThreadPoolExecutor(max_workers=7) as executor:
+            batch = [executor.submit(send, "batch-tenant", "low") for _ in range(6)]
+            time.sleep(0.1)   # The backlog is queued behind the first batch request
+            interactive = executor.submit(send, "interactive-tenant", "high")
+
+            status, finished = interactive.result()
+            batch_results = [future.result() for future in batch]
+
+        # Served right after the batch request holding the slot, not after the backlog
+        assert status == 200
+        assert [result[0] for result in batch_results] == [200] * 6
+        assert sum(1 for _, batch_finished in batch_results if batch_finished < finished) <= 2
+
+        queue = local_stack.metrics()["queue"]
+        assert queue["admitted"] == 7
+        assert queue["rejected"] == queue["dropped"] == queue["expired"] == 0
+
+    def test_streams_do_not_hold_queue_slots(self, local_stack):
+        """
+        Test that streams being relayed do not count against the queue's
+        thread-derived slots, so more of them run than there are slots.
+        """
+        # About a second per stream
+        local_stack.start_backend("--stream-events", "10", "--event-interval-ms", "100")
+        local_stack.start_proxy({"server": {"threads": 4}, "queue": {"enabled": True}})
+
+        def stream(index):
+            time.sleep(index * 0.05)
+            response = requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json={
+                    "model": "test",
+                    "messages": [{"role": "user", "content": f"Queued stream {index}"}],
+                    "stream": True
+                },
+                stream=True,
+                timeout=30
+            )
+            lines = [line for line in response.iter_lines(decode_unicode=True) if line]
+            return response.status_code, lines[-1] if lines else None
+
+        start = time.time()
+        with ThreadPoolExecutor(max_workers=8) as executor:
+            results = list(executor.map(stream, range(8)))
+        elapsed = time.time() - start
+
+        # Two slots and two queue places would admit four streams and reject the rest
+        assert results == [(200, "data: [DONE]")] * 8
+        assert elapsed < 2.5, f"8 streams behind 2 queue slots took {elapsed:.1f}s"
+        queue = local_stack.metrics()["queue"]
+        assert queue["admitted"] == 8
+        assert queue["rejected"] == queue["dropped"] == queue["expired"] == 0
+
+    @pytest.mark.skipif(not os.path.exists("/proc/net/tcp"), reason="Needs /proc/net/tcp")
+    def test_removed_backend_connections_closed_on_reload(self, local_stack):
+        """
+        Test that removing a backend on reload closes its pooled connections
+        at once, not when each worker thread next checks one out.
+        """
+        kept = local_stack.start_backend()
+        removed = local_stack.start_backend()
+        local_stack.start_proxy({})
+
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            statuses = list(executor.map(lambda i: requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json={"model": "test", "messages": [{"role": "user", "content": f"Reload test {i}"}]},
+                timeout=10
+            ).status_code, range(16)))
+        assert statuses == [200] * 16
+        assert established_connections(removed) > 0, "Expected idle pooled connections"
+
+        config_path = local_stack.workdir / "ntonix.json"
+        settings = json.loads(config_path.read_text())
+        settings["backends"] = [{"host": "127.0.0.1", "port": kept, "weight": 1}]
+        config_path.write_text(json.dumps(settings))
+        local_stack.proxy.send_signal(signal.SIGHUP)
+
+        deadline = time.time() + 5
+        while established_connections(removed) > 0 and time.time() < deadline:
+            time.sleep(0.1)
+        assert established_connections(removed) == 0
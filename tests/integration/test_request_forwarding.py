@@ -5,6 +5,12 @@ Verifies that the NTONIX proxy correctly forwards HTTP requests
 to backend servers and returns responses to clients.
 """
 
+import json
+import re
+import socket
+import time
+from concurrent.futures import ThreadPoolExecutor
+
 import pytest
 import requests
 
@@ -106,3 +112,431 @@ class TestRequestForwarding:
         response = requests.get(f"{proxy_url}/unknown/endpoint/path")
 
         assert response.status_code == 404
+
+    def test_client_request_timeout_returns_504(self, local_stack):
+        """Verify an expired X-Request-Timeout deadline cancels the backend call with 504."""
+        local_stack.start_backend("--delay-ms", "300")
+        local_stack.start_proxy({})
+
+        start = time.time()
+        response = requests.post(
+            f"{local_stack.url}/v1/chat/completions",
+            json={
+                "model": "test-model",
+                "messages": [{"role": "user", "content": "Deadline test"}]
+            },
+            headers={
+                "Content-Type": "application/json",
+                "Cache-Control": "no-cache",
+                "X-Request-Timeout": "50ms"
+            },
+            timeout=10
+        )
+        elapsed = time.time() - start
+
+        # The backend takes 300ms; the 504 comes at the 50ms deadline instead
+        assert response.status_code == 504
+        assert elapsed < 0.2, f"504 took {elapsed * 1000:.0f}ms"
+
+        # The proxy keeps serving requests afterwards
+        assert requests.get(f"{local_stack.url}/health").status_code == 200
+
+    @pytest.mark.parametrize("timeout", ["inf", "nan", "1e300", "-5", "0.4ms"])
+    def test_extreme_request_timeout_served(self, proxy_url: str, timeout: str):
+        """Verify huge values are clamped and non-finite, negative or sub-millisecond ones ignored."""
+        response = requests.post(
+            f"{proxy_url}/v1/chat/completions",
+            json={
+                "model": "test-model",
+                "messages": [{"role": "user", "content": f"Timeout {timeout}"}]
+            },
+            headers={
+                "Content-Type": "application/json",
+                "Cache-Control": "no-cache",
+                "X-Request-Timeout": timeout
+            },
+            timeout=10
+        )
+        assert response.status_code == 200
+
+    def test_client_disconnect_cancels_backend_request(self, local_stack):
+        """Verify a client giving up on a non-streaming request is counted as cancelled."""
+        local_stack.start_backend("--delay-ms", "500")
+        # The client closes its socket, which the proxy sees as a half-close
+        local_stack.start_proxy({"timeouts": {"cancel_on_half_close": True}})
+
+        # The backend takes 500ms, so the client leaves first
+        with pytest.raises(requests.exceptions.Timeout):
+            requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json={
+                    "model": "test-model",
+                    "messages": [{"role": "user", "content": "Disconnect test"}]
+                },
+                headers={"Content-Type": "application/json", "Cache-Control": "no-cache"},
+                timeout=0.1
+            )
+
+        time.sleep(0.3)
+        assert local_stack.metrics()["requests"]["cancelled"] == 1
+
+    def test_half_closed_client_still_served(self, local_stack):
+        """Verify a client that only shuts down its sending side still gets its response."""
+        local_stack.start_backend("--delay-ms", "300")
+        local_stack.start_proxy({})
+
+        body = json.dumps({
+            "model": "test-model",
+            "messages": [{"role": "user", "content": "Half-close test"}]
+        })
+        port = int(local_stack.url.rsplit(":", 1)[1])
+        with socket.create_connection(("127.0.0.1", port), timeout=5) as sock:
+            sock.sendall((
+                "POST /v1/chat/completions HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "Content-Type: application/json\r\n"
+                "Connection: close\r\n"
+                f"Content-Length: {len(body)}\r\n\r\n{body}"
+            ).encode())
+            sock.shutdown(socket.SHUT_WR)
+
+            response = b""
+            while chunk := sock.recv(65536):
+                response += chunk
+
+        assert response.startswith(b"HTTP/1.1 200")
+        assert local_stack.metrics()["requests"]["cancelled"] == 0
+
+    def test_rate_limit_metrics_reported(self, proxy_url: str, chat_completion_request: dict):
+        """Verify requests within the token limits pass and rate limiting is reported."""
+        response = requests.post(
+            f"{proxy_url}/v1/chat/completions",
+            json={**chat_completion_request, "max_tokens": 16},
+            headers={"Content-Type": "application/json", "Authorization": "Bearer rate-limit-test"}
+        )
+        assert response.status_code == 200
+
+        metrics = requests.get(f"{proxy_url}/metrics").json()
+        assert "rate_limited" in metrics["requests"]
+
+    def test_rate_limit_rejects_burst_and_refunds_usage(self, local_stack, chat_completion_request: dict):
+        """Verify concurrent requests beyond a key's burst get 429, and reported usage refunds the rest."""
+        local_stack.start_backend("--delay-ms", "500")
+        local_stack.start_proxy({
+            "rate_limit": {
+                "enabled": True,
+                "key_tokens_per_minute": 60,
+                "key_burst_tokens": 1000,
+                "ip_tokens_per_minute": 600000,
+                "ip_burst_tokens": 1000000
+            }
+        })
+
+        def send(_, max_tokens=400, key="burst-test"):
+            return requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json={**chat_completion_request, "max_tokens": max_tokens},
+                headers={"Authorization": f"Bearer {key}", "Cache-Control": "no-cache"},
+                timeout=10
+            )
+
+        # Two estimates of ~400 tokens fit the 1000 token burst, a third does not
+        with ThreadPoolExecutor(max_workers=3) as executor:
+            responses = list(executor.map(send, range(3)))
+        statuses = sorted(response.status_code for response in responses)
+        assert statuses == [200, 200, 429]
+        rejected = next(response for response in responses if response.status_code == 429)
+        assert int(rejected.headers["Retry-After"]) >= 1
+
+        # The backend reported 20 tokens per request, so the estimates were refunded
+        for response in map(send, range(3)):
+            assert response.status_code == 200
+
+        # A huge max_tokens is charged a whole (fresh) bucket rather than overflowing to almost nothing
+        with ThreadPoolExecutor(max_workers=2) as executor:
+            huge = executor.submit(send, 0, 2**63 - 1, "huge-test")
+            time.sleep(0.2)
+            small = executor.submit(send, 0, 16, "huge-test")
+        assert huge.result().status_code == 200
+        assert small.result().status_code == 429
+        assert local_stack.metrics()["requests"]["rate_limited"] == 2
+
+    def test_completions_endpoint_forwarded(self, proxy_url: str):
+        """Verify legacy completions are forwarded and batching metrics are reported."""
+        response = requests.post(
+            f"{proxy_url}/v1/completions",
+            json={"model": "test-model", "prompt": "Say hello", "max_tokens": 8},
+            headers={"Content-Type": "application/json"}
+        )
+        assert response.status_code == 200
+        assert "choices" in response.json()
+        assert "X-Request-ID" in response.headers
+
+        metrics = requests.get(f"{proxy_url}/metrics").json()
+        assert "batch_size" in metrics["batching"]
+        assert "added_wait_ms" in metrics["batching"]
+
+    def test_concurrent_completions_batched(self, local_stack):
+        """Verify concurrent compatible completions share backend calls and each get their own choice."""
+        local_stack.start_backend("--delay-ms", "100")
+        local_stack.start_proxy({
+            "server": {"threads": 16},
+            "batching": {"enabled": True, "max_batch_size": 8, "max_wait_ms": 50}
+        })
+
+        def send(i, timeout=None):
+            headers = {"X-Request-Timeout": timeout} if timeout else {}
+            return requests.post(
+                f"{local_stack.url}/v1/completions",
+                json={"model": "test-model", "prompt": f"prompt {i}", "max_tokens": 8},
+                headers=headers,
+                timeout=10
+            )
+
+        # One client's short deadline must not fail the batch it would have joined
+        with ThreadPoolExecutor(max_workers=9) as executor:
+            hurried = executor.submit(send, "hurried", "10ms")
+            responses = list(executor.map(send, range(8)))
+
+        for i, response in enumerate(responses):
+            assert response.status_code == 200
+            choices = response.json()["choices"]
+            assert [choice["text"] for choice in choices] == [f"Completion for prompt {i}"]
+        assert hurried.result().status_code == 504
+
+        batching = local_stack.metrics()["batching"]
+        assert batching["requests"] == 9
+        assert batching["batches"] < batching["requests"]
+
+    def test_backend_connect_metrics_reported(self, proxy_url: str, chat_completion_request: dict):
+        """Verify new backend connections are timed per backend."""
+        response = requests.post(
+            f"{proxy_url}/v1/chat/completions",
+            json=chat_completion_request,
+            headers={"Content-Type": "application/json"}
+        )
+        assert response.status_code == 200
+
+        backends = requests.get(f"{proxy_url}/metrics").json()["backends"]
+        assert sum(b["connect"]["latency_ms"]["count"] for b in backends) >= 1
+        for backend in backends:
+            assert backend["connect"]["failed"] >= backend["connect"]["timed_out"]
+            assert backend["connect"]["stale_on_checkout"] >= 0
+            assert backend["connect"]["stale_retried"] >= 0
+
+    def test_stale_connection_replaced_on_checkout(self, local_stack, chat_completion_request: dict):
+        """Verify a pooled connection the backend closed while idle is detected and replaced."""
+        local_stack.start_backend("--idle-timeout", "0.5")
+        local_stack.start_proxy({})
+
+        def send():
+            return requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json=chat_completion_request,
+                timeout=10
+            )
+
+        assert send().status_code == 200
+        before = local_stack.metrics()["backends"][0]["connect"]
+
+        # Outlast the backend's keep-alive so the pooled connection is closed under us
+        time.sleep(1.5)
+        response = send()
+        assert response.status_code == 200
+
+        connect = local_stack.metrics()["backends"][0]["connect"]
+        assert connect["stale_on_checkout"] > before["stale_on_checkout"]
+        assert connect["failed"] == 0
+
+    def test_dns_cache_metrics_reported(self, proxy_url: str):
+        """Verify the backend DNS cache reports its counters."""
+        dns = requests.get(f"{proxy_url}/metrics").json()["dns"]
+        for counter in ("hits", "misses", "refresh_failures"):
+            assert dns[counter] >= 0
+
+    def test_dns_cache_resolves_backend_once(self, local_stack, chat_completion_request: dict):
+        """Verify a backend name is resolved once and then served from the DNS cache."""
+        port = local_stack.start_backend("--delay-ms", "100")
+        local_stack.start_proxy(
+            {"dns": {"ttl_ms": 60000}},
+            backends=[{"host": "localhost", "port": port, "weight": 1}]
+        )
+        before = local_stack.metrics()["dns"]
+
+        # Concurrent requests open new pooled connections, each looking up the name
+        def send(_):
+            return requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json=chat_completion_request,
+                timeout=10
+            ).status_code
+
+        with ThreadPoolExecutor(max_workers=3) as executor:
+            assert list(executor.map(send, range(6))) == [200] * 6
+
+        # The name is prefetched at startup, so at most one lookup ever misses
+        dns = local_stack.metrics()["dns"]
+        assert dns["misses"] == before["misses"] <= 1
+        assert dns["hits"] > before["hits"]
+
+    def test_pool_preconnects_min_idle(self, local_stack):
+        """Verify min_idle connections are opened before the first request arrives."""
+        local_stack.start_backend()
+        local_stack.start_proxy({"pool": {"size_per_backend": 4, "min_idle": 2}})
+
+        # Pre-connects run in the background after startup
+        deadline = time.time() + 5
+        while True:
+            backends = local_stack.metrics()["backends"]
+            connected = sum(b["connect"]["latency_ms"]["count"] for b in backends)
+            if connected >= 2 or time.time() > deadline:
+                break
+            time.sleep(0.2)
+
+        assert sum(b["requests"] for b in backends) == 0
+        assert connected == 2
+
+    def test_pool_wait_metrics_reported(self, local_stack, chat_completion_request: dict):
+        """Verify requests beyond the pool size wait for a connection and are reported."""
+        local_stack.start_backend("--delay-ms", "200")
+        local_stack.start_proxy({
+            "server": {"threads": 8},
+            "pool": {"size_per_backend": 2, "max_waiters": 8, "max_wait_ms": 5000}
+        })
+
+        def send(_):
+            return requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json=chat_completion_request,
+                timeout=10
+            ).status_code
+
+        with ThreadPoolExecutor(max_workers=6) as executor:
+            assert list(executor.map(send, range(6))) == [200] * 6
+
+        pool_wait = local_stack.metrics()["backends"][0]["pool_wait"]
+        assert pool_wait["wait_ms"]["count"] > 0
+        assert pool_wait["waiting"] == 0
+        assert pool_wait["timed_out"] == 0
+        assert pool_wait["rejected"] == 0
+
+    def test_pool_size_metrics_reported(self, local_stack, chat_completion_request: dict):
+        """Verify an adaptive pool grows under load, staying within its size bounds."""
+        local_stack.start_backend("--delay-ms", "200")
+        local_stack.start_proxy({
+            "server": {"threads": 16},
+            "pool": {"adaptive": True, "size_per_backend": 2, "min_size": 2, "max_size": 6}
+        })
+
+        def send(_):
+            return requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json=chat_completion_request,
+                timeout=10
+            ).status_code
+
+        # Ten clients for a few resize ticks (one per second), sampling the pool size
+        samples = []
+        with ThreadPoolExecutor(max_workers=10) as executor:
+            results = executor.map(send, range(120))
+            for _ in range(12):
+                time.sleep(0.25)
+                samples.append(local_stack.metrics()["backends"][0]["pool_size"])
+            assert set(results) == {200}
+        samples.append(local_stack.metrics()["backends"][0]["pool_size"])
+
+        for pool_size in samples:
+            assert 2 <= pool_size["limit"] <= 6
+            assert 2 <= pool_size["target"] <= 6
+        assert max(pool_size["target"] for pool_size in samples) > 2
+        assert max(pool_size["limit"] for pool_size in samples) > 2
+
+    def test_failed_backend_is_retried_on_another(self, local_stack, chat_completion_request: dict):
+        """Verify requests still succeed after one backend goes down, by retrying elsewhere."""
+        local_stack.start_backend()
+        stopped = local_stack.start_backend()
+        local_stack.start_proxy({"retry": {"max_retries": 2}})
+
+        local_stack.stop_backend(stopped)
+        for _ in range(10):
+            response = requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json=chat_completion_request,
+                timeout=10
+            )
+            assert response.status_code == 200
+            assert response.json()["backend_port"] != stopped
+
+        assert local_stack.metrics()["retries"]["total"] > 0
+
+    def test_failed_backend_is_retried_for_streaming_requests(self, local_stack, streaming_chat_request: dict):
+        """Verify streaming requests also fail over to another backend before the stream starts."""
+        local_stack.start_backend()
+        stopped = local_stack.start_backend()
+        local_stack.start_proxy({"retry": {"max_retries": 2}})
+
+        local_stack.stop_backend(stopped)
+        for _ in range(10):
+            response = requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json=streaming_chat_request,
+                headers={"Cache-Control": "no-cache"},
+                timeout=10
+            )
+            assert response.status_code == 200
+            assert response.text.strip().endswith("data: [DONE]")
+
+        assert local_stack.metrics()["retries"]["total"] > 0
+
+    @pytest.mark.parametrize("stream", [False, True])
+    def test_retry_backoff_is_jittered_within_bounds(self, local_stack, stream: bool):
+        """Verify each retry backs off for a jittered delay between the configured base and cap."""
+        local_stack.start_backend()
+        stopped = [local_stack.start_backend() for _ in range(4)]
+        local_stack.start_proxy({"retry": {"max_retries": 4, "budget_ratio": 10,
+                                           "backoff_base_ms": 20, "backoff_max_ms": 60}})
+
+        # Every attempt on a stopped backend is refused and retried elsewhere
+        for port in stopped:
+            local_stack.stop_backend(port)
+
+        for i in range(10):
+            response = requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json={
+                    "model": "test-model",
+                    "messages": [{"role": "user", "content": f"Backoff test {i}"}],
+                    "stream": stream
+                },
+                headers={"Cache-Control": "no-cache"},
+                timeout=10
+            )
+            assert response.status_code == 200
+
+        log = (local_stack.workdir / "proxy.log").read_text()
+        delays = [int(ms) for ms in re.findall(r"backoff=(\d+)ms", log)]
+        assert len(delays) >= 5, f"Expected several retries, got {delays}"
+        assert all(20 <= delay <= 60 for delay in delays), delays
+        assert len(set(delays)) > 1, f"Backoff is not jittered: {delays}"
+
+    @pytest.mark.parametrize("stream", [False, True])
+    def test_request_sent_to_backend_is_not_retried(self, local_stack, stream: bool):
+        """Verify a backend that closes after reading the request is contacted exactly once."""
+        ports = [local_stack.start_backend("--close-after-request") for _ in range(3)]
+        local_stack.start_proxy({"retry": {"max_retries": 2}})
+
+        response = requests.post(
+            f"{local_stack.url}/v1/chat/completions",
+            json={
+                "model": "test-model",
+                "messages": [{"role": "user", "content": "Request of death"}],
+                "stream": stream
+            },
+            headers={"Cache-Control": "no-cache"},
+            timeout=10
+        )
+
+        assert response.status_code == 502
+        posts = [requests.get(f"http://127.0.0.1:{port}/stats", timeout=5).json()["posts"] for port in ports]
+        assert sum(posts) == 1
+        assert local_stack.metrics()["retries"]["total"] == 0
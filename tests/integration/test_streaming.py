@@ -8,6 +8,7 @@ streaming responses from backends to clients without buffering.
 import pytest
 import requests
 import json
+import socket
 import time
 
 
@@ -258,3 +259,616 @@ class TestStreaming:
         assert health_response.status_code == 200, (
             "Proxy should remain healthy after client disconnect"
         )
+
+    def test_identical_concurrent_streams_share_backend_stream(self, proxy_url: str):
+        """
+        Verify that identical streaming requests arriving while a stream is
+        in flight attach to it and receive the complete event sequence.
+        """
+        from concurrent.futures import ThreadPoolExecutor
+
+        request_data = {
+            "model": "test-model",
+            "messages": [
+                {"role": "user", "content": f"Shared stream test {time.time()}"}
+            ],
+            "stream": True
+        }
+
+        def collect(delay: float):
+            time.sleep(delay)
+            response = requests.post(
+                f"{proxy_url}/v1/chat/completions",
+                json=request_data,
+                headers={"Content-Type": "application/json"},
+                stream=True,
+                timeout=60
+            )
+            assert response.status_code == 200
+            events = []
+            for line in response.iter_lines(decode_unicode=True):
+                if line and line.startswith("data: "):
+                    events.append(line)
+                    if line == "data: [DONE]":
+                        break
+            return events
+
+        # The second and third clients join after the first has started streaming
+        with ThreadPoolExecutor(max_workers=3) as pool:
+            results = list(pool.map(collect, [0.0, 0.3, 0.6]))
+
+        # Late joiners are replayed the events they missed, so all see the same stream
+        assert results[0], "Leader should receive events"
+        assert results[0][-1] == "data: [DONE]"
+        for events in results[1:]:
+            assert events == results[0]
+
+        metrics = requests.get(f"{proxy_url}/metrics").json()
+        assert "streams_shared" in metrics["cache"]
+
+    def test_stream_relay_metrics_reported(self, proxy_url: str):
+        """
+        Verify that relayed streams report backend chunks, events and client
+        writes along with the coalescing and stall histograms.
+        """
+        request_data = {
+            "model": "test-model",
+            "messages": [
+                {"role": "user", "content": f"Relay metrics test {time.time()}"}
+            ],
+            "stream": True
+        }
+
+        response = requests.post(
+            f"{proxy_url}/v1/chat/completions",
+            json=request_data,
+            headers={"Content-Type": "application/json", "Cache-Control": "no-cache"},
+            stream=True,
+            timeout=60
+        )
+        assert response.status_code == 200
+        for line in response.iter_lines(decode_unicode=True):
+            if line == "data: [DONE]":
+                break
+        response.close()
+
+        streaming = requests.get(f"{proxy_url}/metrics").json()["streaming"]
+        assert streaming["chunks"] > 0
+        assert streaming["events"] > 0
+        assert streaming["writes"] > 0
+        assert "write_held_ms" in streaming
+        assert "client_stall_ms" in streaming
+        assert streaming["slow_clients_dropped"] >= 0
+        assert streaming["spilled_bytes"] >= 0
+
+    def test_route_coalesce_window_merges_writes(self, local_stack):
+        """
+        Verify that a route with a coalesce window holds paced backend chunks
+        so that fewer, larger writes reach the client.
+        """
+        local_stack.start_backend("--stream-events", "20", "--event-interval-ms", "10")
+        local_stack.start_proxy({
+            "streaming": {
+                "coalesce_window_ms": 0,
+                "routes": {"/v1/chat/completions": 50}
+            }
+        })
+
+        response = requests.post(
+            f"{local_stack.url}/v1/chat/completions",
+            json={
+                "model": "test-model",
+                "messages": [{"role": "user", "content": "Coalesce window test"}],
+                "stream": True
+            },
+            stream=True,
+            timeout=30
+        )
+        assert response.status_code == 200
+        lines = [line for line in response.iter_lines(decode_unicode=True) if line]
+        assert len(lines) == 21
+        assert lines[-1] == "data: [DONE]"
+
+        # Relay counts are published once the backend body has been drained
+        deadline = time.time() + 5
+        while True:
+            streaming = local_stack.metrics()["streaming"]
+            if streaming["chunks"] > 0 or time.time() > deadline:
+                break
+            time.sleep(0.1)
+
+        assert streaming["chunks"] > 0
+        assert streaming["writes"] < streaming["chunks"]
+        assert streaming["write_held_ms"]["count"] > 0
+
+    def test_streams_do_not_hold_io_threads(self, local_stack):
+        """
+        Verify that more concurrent streams than I/O threads run side by
+        side rather than waiting for a thread each.
+        """
+        from concurrent.futures import ThreadPoolExecutor
+
+        # About a second per stream
+        local_stack.start_backend("--stream-events", "10", "--event-interval-ms", "100")
+        local_stack.start_proxy({"server": {"threads": 2}})
+
+        def collect(index: int):
+            response = requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json={
+                    "model": "test-model",
+                    "messages": [{"role": "user", "content": f"Thread test {index}"}],
+                    "stream": True
+                },
+                stream=True,
+                timeout=30
+            )
+            assert response.status_code == 200
+            return [line for line in response.iter_lines(decode_unicode=True) if line]
+
+        start = time.time()
+        with ThreadPoolExecutor(max_workers=8) as pool:
+            results = list(pool.map(collect, range(8)))
+        elapsed = time.time() - start
+
+        for lines in results:
+            assert lines[-1] == "data: [DONE]"
+        # Two threads relaying one stream each would take about four seconds
+        assert elapsed < 2.5, f"8 streams on 2 threads took {elapsed:.1f}s"
+
+    def test_joined_streams_do_not_hold_io_threads(self, local_stack):
+        """
+        Verify that more clients joining one shared stream than there are
+        I/O threads are all served while the leader is still streaming.
+        """
+        from concurrent.futures import ThreadPoolExecutor
+
+        # About a second per stream
+        local_stack.start_backend("--stream-events", "10", "--event-interval-ms", "100")
+        local_stack.start_proxy({"server": {"threads": 2}, "cache": {"enabled": True}})
+
+        prompt = f"Joined thread test {time.time()}"
+
+        def collect(index: int):
+            time.sleep(index * 0.05)  # Let the first request lead
+            response = requests.post(
+                f"{local_stack.url}/v1/chat/completions",
+                json={
+                    "model": "test-model",
+                    "messages": [{"role": "user", "content": prompt}],
+                    "stream": True
+                },
+                stream=True,
+                timeout=30
+            )
+            assert response.status_code == 200
+            return [line for line in response.iter_lines(decode_unicode=True) if line]
+
+        start = time.time()
+        with ThreadPoolExecutor(max_workers=6) as pool:
+            results = list(pool.map(collect, range(6)))
+        elapsed = time.time() - start
+
+        for lines in results:
+            assert lines == results[0]
+            assert lines[-1] == "data: [DONE]"
+        # Joiners parked on both threads would stall the leader's relay
+        assert elapsed < 2.5, f"6 identical streams on 2 threads took {elapsed:.1f}s"
+        assert local_stack.metrics()["cache"]["streams_shared"] >= 1
+
+    def test_route_timeout_bounds_stream(self, local_stack):
+        """
+        Verify that a timeouts.routes entry ends a stream that is still
+        producing events when the route's deadline passes.
+        """
+        # About 5 seconds of events, never idle for long
+        local_stack.start_backend("--stream-events", "50", "--event-interval-ms", "100")
+        local_stack.start_proxy({"timeouts": {"routes": {"/v1/chat/completions": 500}}})
+
+        start = time.time()
+        response = requests.post(
+            f"{local_stack.url}/v1/chat/completions",
+            json={
+                "model": "test-model",
+                "messages": [{"role": "user", "content": "Route deadline test"}],
+                "stream": True
+            },
+            stream=True,
+            timeout=30
+        )
+        assert response.status_code == 200
+
+        lines = []
+        try:
+            for line in response.iter_lines(decode_unicode=True):
+                if line:
+                    lines.append(line)
+        except requests.exceptions.ChunkedEncodingError:
+            pass  # Truncated stream: no terminating chunk
+        elapsed = time.time() - start
+
+        assert "data: [DONE]" not in lines
+        assert elapsed < 3, f"Stream ran for {elapsed:.1f}s past its 500ms route deadline"
+
+    def test_paced_replay_bounded_by_route_timeout(self, local_stack):
+        """
+        Verify that a paced replay from cache ends once the route's deadline
+        passes instead of sleeping through the remaining events.
+        """
+        local_stack.start_backend("--stream-events", "20")
+        local_stack.start_proxy({
+            "cache": {"enabled": True, "stream_replay_interval_ms": 200},
+            "timeouts": {"routes": {"/v1/chat/completions": 500}}
+        })
+        request_data = {
+            "model": "test-model",
+            "messages": [{"role": "user", "content": f"Paced replay test {time.time()}"}],
+            "stream": True
+        }
+
+        # Populate the cache
+        first = requests.post(f"{local_stack.url}/v1/chat/completions", json=request_data, timeout=30)
+        assert first.status_code == 200
+        assert "data: [DONE]" in first.text
+
+        start = time.time()
+        response = requests.post(
+            f"{local_stack.url}/v1/chat/completions",
+            json=request_data,
+            stream=True,
+            timeout=30
+        )
+        assert response.status_code == 200
+        assert response.headers.get("X-Cache") == "HIT"
+
+        lines = []
+        try:
+            for line in response.iter_lines(decode_unicode=True):
+                if line:
+                    lines.append(line)
+        except requests.exceptions.ChunkedEncodingError:
+            pass  # Truncated stream: no terminating chunk
+        elapsed = time.time() - start
+
+        # 20 events at 200ms would take about 4 seconds
+        assert "data: [DONE]" not in lines
+        assert elapsed < 2, f"Replay ran for {elapsed:.1f}s past its 500ms route deadline"
+
+    def test_paced_replays_do_not_hold_io_threads(self, local_stack):
+        """
+        Verify that more paced cache replays than I/O threads run side by
+        side rather than waiting for a thread each.
+        """
+        from concurrent.futures import ThreadPoolExecutor
+
+        local_stack.start_backend("--stream-events", "10")
+        local_stack.start_proxy({
+            "server": {"threads": 2},
+            "cache": {"enabled": True, "stream_replay_interval_ms": 100}
+        })
+
+        body = {
+            "model": "test-model",
+            "messages": [{"role": "user", "content": f"Paced replay thread test {time.time()}"}],
+            "stream": True
+        }
+
+        def collect(_):
+            response = requests.post(f"{local_stack.url}/v1/chat/completions",
+                                     json=body, stream=True, timeout=30)
+            assert response.status_code == 200
+            return response.headers.get("X-Cache"), [
+                line for line in response.iter_lines(decode_unicode=True) if line]
+
+        # Fill the cache, then replay it to more clients than threads
+        _, expected = collect(0)
+        start = time.time()
+        with ThreadPoolExecutor(max_workers=6) as pool:
+            results = list(pool.map(collect, range(6)))
+        elapsed = time.time() - start
+
+        for cache_status, lines in results:
+            assert cache_status == "HIT"
+            assert lines == expected
+        # About a second per replay; two threads pausing in turn would take three
+        assert elapsed < 2.5, f"6 paced replays on 2 threads took {elapsed:.1f}s"
+
+    def test_stalled_client_dropped(self, local_stack):
+        """
+        Verify that under slow_client_policy "drop" a client that stops
+        reading is disconnected once stalled for slow_client_timeout_ms.
+        """
+        # About 8 MB of events, far more than the socket buffers can absorb
+        local_stack.start_backend("--stream-events", "2000", "--event-bytes", "4096")
+        local_stack.start_proxy({
+            "streaming": {
+                "client_buffer_bytes": 16384,
+                "slow_client_policy": "drop",
+                "slow_client_timeout_ms": 500
+            }
+        })
+
+        body = json.dumps({
+            "model": "test-model",
+            "messages": [{"role": "user", "content": "Slow client test"}],
+            "stream": True
+        })
+        port = int(local_stack.url.rsplit(":", 1)[1])
+        sock = socket.socket()
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4096)
+        sock.connect(("127.0.0.1", port))
+        sock.sendall((
+            "POST /v1/chat/completions HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "Content-Type: application/json\r\n"
+            f"Content-Length: {len(body)}\r\n\r\n{body}"
+        ).encode())
+
+        # Stop reading well past the timeout, then drain what was sent
+        time.sleep(2)
+        sock.settimeout(10)
+        received = b""
+        try:
+            while chunk := sock.recv(65536):
+                received += chunk
+        except ConnectionResetError:
+            pass
+        finally:
+            sock.close()
+
+        assert received.startswith(b"HTTP/1.1 200")
+        assert not received.endswith(b"0\r\n\r\n"), "Dropped client should not get the terminating chunk"
+        assert b"data: [DONE]" not in received
+        assert local_stack.metrics()["streaming"]["slow_clients_dropped"] == 1
+
+    def test_half_closed_client_ends_stream(self, local_stack):
+        """
+        Verify that a streaming client shutting down its sending side is
+        treated as gone and its stream ended, not relayed to the end.
+        """
+        # About five seconds of events
+        local_stack.start_backend("--stream-events", "50", "--event-interval-ms", "100")
+        local_stack.start_proxy({})
+
+        body = json.dumps({
+            "model": "test-model",
+            "messages": [{"role": "user", "content": "Half-close stream test"}],
+            "stream": True
+        })
+        port = int(local_stack.url.rsplit(":", 1)[1])
+        sock = socket.create_connection(("127.0.0.1", port))
+        sock.sendall((
+            "POST /v1/chat/completions HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "Content-Type: application/json\r\n"
+            f"Content-Length: {len(body)}\r\n\r\n{body}"
+        ).encode())
+        sock.shutdown(socket.SHUT_WR)
+
+        start = time.time()
+        sock.settimeout(10)
+        received = b""
+        try:
+            while chunk := sock.recv(65536):
+                received += chunk
+        except ConnectionResetError:
+            pass
+        finally:
+            sock.close()
+        elapsed = time.time() - start
+
+        assert b"data: [DONE]" not in received
+        assert elapsed < 2, f"Half-closed client's stream took {elapsed:.1f}s to end"
+
+    def test_stalled_joiner_dropped(self, local_stack):
+        """
+        Verify that a client joined to a shared stream that stops reading is
+        dropped once stalled, while the leading client still completes.
+        """
+        # About 8 MB of events, more than the socket buffers can absorb
+        local_stack.start_backend("--stream-events", "2000", "--event-bytes", "4096",
+                                  "--event-interval-ms", "1")
+        local_stack.start_proxy({
+            "cache": {"enabled": True},
+            "streaming": {
+                "slow_client_policy": "drop",
+                "slow_client_timeout_ms": 500
+            }
+        })
+
+        body = json.dumps({
+            "model": "test-model",
+            "messages": [{"role": "user", "content": f"Stalled joiner test {time.time()}"}],
+            "stream": True
+        })
+        leader = requests.post(
+            f"{local_stack.url}/v1/chat/completions",
+            data=body,
+            headers={"Content-Type": "application/json"},
+            stream=True,
+            timeout=30
+        )
+        assert leader.status_code == 200
+        lines = leader.iter_lines(decode_unicode=True)
+        next(line for line in lines if line and line.startswith("data: "))
+
+        port = int(local_stack.url.rsplit(":", 1)[1])
+        sock = socket.socket()
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4096)
+        sock.connect(("127.0.0.1", port))
+        sock.sendall((
+            "POST /v1/chat/completions HTTP/1.1\r\n"
+            "Host: localhost\r\n"
+            "Content-Type: application/json\r\n"
+            f"Content-Length: {len(body)}\r\n\r\n{body}"
+        ).encode())
+
+        # The leader keeps receiving while the joiner stalls
+        assert "data: [DONE]" in lines
+
+        sock.settimeout(10)
+        received = b""
+        try:
+            while chunk := sock.recv(65536):
+                received += chunk
+        except ConnectionResetError:
+            pass
+        finally:
+            sock.close()
+
+        assert received.startswith(b"HTTP/1.1 200")
+        assert not received.endswith(b"0\r\n\r\n"), "Stalled joiner should not get the terminating chunk"
+        assert local_stack.metrics()["streaming"]["slow_clients_dropped"] == 1
+
+    def test_done_split_across_reads_ends_stream(self, local_stack):
+        """
+        Verify that a [DONE] event arriving in two backend reads still ends
+        the client stream, without waiting for the backend body to end.
+        """
+        local_stack.start_backend("--stream-events", "3", "--split-done-ms", "5000")
+        local_stack.start_proxy({})
+
+        start = time.time()
+        response = requests.post(
+            f"{local_stack.url}/v1/chat/completions",
+            json={
+                "model": "test-model",
+                "messages": [{"role": "user", "content": "Split done test"}],
+                "stream": True
+            },
+            stream=True,
+            timeout=30
+        )
+        assert response.status_code == 200
+        lines = [line for line in response.iter_lines(decode_unicode=True) if line]
+        elapsed = time.time() - start
+
+        assert len(lines) == 4
+        assert lines[-1] == "data: [DONE]"
+        assert elapsed < 3, f"Stream ended after {elapsed:.1f}s, with the backend body"
+
+    def test_done_inside_token_text_does_not_end_stream(self, local_stack):
+        """
+        Verify that a token whose text contains [DONE] is relayed like any
+        other event rather than taken for the end of the stream.
+        """
+        local_stack.start_backend("--stream-events", "5", "--event-text", "data: [DONE]\n\n")
+        local_stack.start_proxy({})
+
+        response = requests.post(
+            f"{local_stack.url}/v1/chat/completions",
+            json={
+                "model": "test-model",
+                "messages": [{"role": "user", "content": "Done in text test"}],
+                "stream": True
+            },
+            stream=True,
+            timeout=30
+        )
+        assert response.status_code == 200
+        lines = [line for line in response.iter_lines(decode_unicode=True) if line]
+
+        assert len(lines) == 6
+        for line in lines[:-1]:
+            chunk = json.loads(line[len("data: "):])
+            assert chunk["choices"][0]["delta"]["content"] == "data: [DONE]\n\n"
+        assert lines[-1] == "data: [DONE]"
+
+    def test_buffer_pool_metrics_reported(self, proxy_url: str):
+        """
+        Verify that stream and parse buffers come from the buffer pool and
+        return to it once the request is done.
+        """
+        request_data = {
+            "model": "test-model",
+            "messages": [
+                {"role": "user", "content": f"Buffer pool test {time.time()}"}
+            ],
+            "stream": True
+        }
+
+        for _ in range(2):
+            response = requests.post(
+                f"{proxy_url}/v1/chat/completions",
+                json=request_data,
+                headers={"Content-Type": "application/json", "Cache-Control": "no-cache"},
+                stream=True,
+                timeout=60
+            )
+            assert response.status_code == 200
+            for _line in response.iter_lines():
+                pass
+            response.close()
+
+        buffers = requests.get(f"{proxy_url}/metrics").json()["buffers"]
+        assert buffers["allocated"] > 0
+        assert buffers["idle"] > 0
+        assert buffers["idle_bytes"] >= 1024 * buffers["idle"]
+
+    def test_stream_latency_metrics_by_model_and_backend(self, proxy_url: str):
+        """
+        Verify that a relayed stream is timed (time to header and first
+        event, event gaps) under its model and its backend.
+        """
+        model = f"latency-test-model-{int(time.time())}"
+        request_data = {
+            "model": model,
+            "messages": [
+                {"role": "user", "content": "Latency metrics test"}
+            ],
+            "stream": True
+        }
+
+        response = requests.post(
+            f"{proxy_url}/v1/chat/completions",
+            json=request_data,
+            headers={"Content-Type": "application/json", "Cache-Control": "no-cache"},
+            stream=True,
+            timeout=60
+        )
+        assert response.status_code == 200
+        for _line in response.iter_lines():
+            pass
+        response.close()
+
+        metrics = requests.get(f"{proxy_url}/metrics").json()
+        latency = metrics["streaming"]["models"][model]
+        assert latency["streams"] == 1
+        assert latency["time_to_header_ms"]["count"] == 1
+        assert latency["time_to_first_event_ms"]["count"] == 1
+        assert latency["time_to_first_event_ms"]["sum"] >= latency["time_to_header_ms"]["sum"]
+        assert "event_gap_ms" in latency
+        assert "events_per_second" in latency
+        assert sum(b["streaming"]["streams"] for b in metrics["backends"]) >= 1
+
+    def test_stream_carries_no_backend_chunk_framing(self, proxy_url: str):
+        """
+        Verify that back-to-back streams carry only SSE lines: the backend's
+        chunked framing is decoded, not relayed inside the client's chunks,
+        and a pooled backend connection serves the next stream cleanly.
+        """
+        for i in range(3):
+            request_data = {
+                "model": "test-model",
+                "messages": [
+                    {"role": "user", "content": f"Framing test {i} {time.time()}"}
+                ],
+                "stream": True
+            }
+
+            response = requests.post(
+                f"{proxy_url}/v1/chat/completions",
+                json=request_data,
+                headers={"Content-Type": "application/json", "Cache-Control": "no-cache"},
+                stream=True,
+                timeout=60
+            )
+            assert response.status_code == 200
+
+            lines = [line.decode("utf-8") for line in response.iter_lines() if line]
+            response.close()
+
+            assert lines, "Expected SSE events"
+            for line in lines:
+                assert line.startswith("data:"), f"Unexpected line in stream: {line!r}"
+            assert lines[-1] == "data: [DONE]"